@@ -68,8 +68,7 @@ CFLAGS="-c -fPIC -Wno-incompatible-pointer-types"
 LFLAGS="-L${OSQP_DIR}/lib"
 
 SRCDIR=`dirname $0`/../src/main/C
-SRCFILE=${SRCDIR}/com_d3x_osqp_OsqpModel.c
-OBJFILE=${SRCDIR}/com_d3x_osqp_OsqpModel.o
+SRCNAMES="d3x_osqp com_d3x_osqp_OsqpBatch com_d3x_osqp_OsqpEmbedded com_d3x_osqp_OsqpLinsys com_d3x_osqp_OsqpNativeStats com_d3x_osqp_OsqpSolver"
 
 if [ ! -d $D3X_LIBDIR ]
 then
@@ -81,10 +80,32 @@ then
     IFLAGS="-I${JAVA_HOME}/include -I${JAVA_HOME}/include/darwin -I${OSQP_DIR}/include/osqp -I$SRCDIR"
     SHARED="-dynamiclib"
     SUFFIX=".dylib"
+    SYMBOLIC=""
+    HIDELIBS=""
+    DLLIB=""
 else
     IFLAGS="-I${JAVA_HOME}/include -I${JAVA_HOME}/include/linux -I${OSQP_DIR}/include/osqp -I$SRCDIR"
     SHARED="-shared -fPIC"
     SUFFIX=".so"
+    SYMBOLIC="-Wl,-Bsymbolic"
+    HIDELIBS="-Wl,--exclude-libs,ALL"
+    DLLIB="-ldl"
+    LFLAGS="$LFLAGS $DLLIB"
+fi
+
+# OSQP loads the MKL Pardiso solver at run time from libmkl_rt; when
+# MKLROOT is defined, record its library directory so that the loader
+# finds it without LD_LIBRARY_PATH...
+if [ -n "$MKLROOT" ]
+then
+    if [ $UNAME = "Darwin" ]
+    then
+        MKL_LIBDIR=${MKLROOT}/lib
+    else
+        MKL_LIBDIR=${MKLROOT}/lib/intel64
+    fi
+
+    LFLAGS="$LFLAGS -Wl,-rpath,${MKL_LIBDIR}"
 fi
 
 if [ ! -f ${OSQP_DIR}/lib/libosqp${SUFFIX} ]
@@ -95,16 +116,27 @@ fi
 
 LIBFILE=${D3X_LIBDIR}/lib${D3X_LIBNAME}${SUFFIX}
 
-$CC $CFLAGS $IFLAGS $SRCFILE -o $OBJFILE
+OBJFILES=""
 
-if [ ! -f $OBJFILE ]
-then
-    echo "Compilation failed; exiting."
-    exit 1
-fi
+for SRCNAME in $SRCNAMES
+do
+    SRCFILE=${SRCDIR}/${SRCNAME}.c
+    OBJFILE=${SRCDIR}/${SRCNAME}.o
 
-$CC $SHARED -o $LIBFILE $OBJFILE $LFLAGS -lc -losqp
-/bin/rm -f $OBJFILE
+    /bin/rm -f $OBJFILE
+    $CC $CFLAGS $IFLAGS $SRCFILE -o $OBJFILE
+
+    if [ ! -f $OBJFILE ]
+    then
+        echo "Compilation failed; exiting."
+        exit 1
+    fi
+
+    OBJFILES="$OBJFILES $OBJFILE"
+done
+
+$CC $SHARED -o $LIBFILE $OBJFILES $LFLAGS -lc -losqp -lpthread
+/bin/rm -f $OBJFILES
 
 if [ -f $LIBFILE ]
 then
@@ -114,4 +146,93 @@ else
     exit 1
 fi
 
+# When SINGLE_OSQP_DIR names an OSQP installation compiled with DFLOAT
+# (cmake -DDFLOAT=ON), also build the single-precision adapter library
+# from the solver sources, linked statically against that OSQP.  Every
+# symbol is hidden (the JNI functions too, by defining JNIEXPORT empty)
+# and the library binds its own calls internally, so it coexists with
+# the double-precision libraries; its JNI_OnLoad registers the functions
+# as the native methods of OsqpSingle...
+if [ -n "$SINGLE_OSQP_DIR" ]
+then
+    if [ ! -f ${SINGLE_OSQP_DIR}/lib/libosqp.a ]
+    then
+        echo "OSQP is not installed under ${SINGLE_OSQP_DIR}; exiting."
+        exit 1
+    fi
+
+    SINGLE_IFLAGS=`echo $IFLAGS | sed "s|-I${OSQP_DIR}/include/osqp|-I${SINGLE_OSQP_DIR}/include/osqp|"`
+    SINGLE_FILE=${D3X_LIBDIR}/lib${D3X_LIBNAME}-single${SUFFIX}
+    SINGLE_OBJFILES=""
+
+    for SRCNAME in d3x_osqp d3x_single com_d3x_osqp_OsqpSolver
+    do
+        SRCFILE=${SRCDIR}/${SRCNAME}.c
+        OBJFILE=${SRCDIR}/${SRCNAME}-single.o
+
+        /bin/rm -f $OBJFILE
+        $CC $CFLAGS -fvisibility=hidden -DJNIEXPORT= $SINGLE_IFLAGS $SRCFILE -o $OBJFILE
+
+        if [ ! -f $OBJFILE ]
+        then
+            echo "Compilation failed; exiting."
+            exit 1
+        fi
+
+        SINGLE_OBJFILES="$SINGLE_OBJFILES $OBJFILE"
+    done
+
+    /bin/rm -f $SINGLE_FILE
+    $CC $SHARED $SYMBOLIC $HIDELIBS -o $SINGLE_FILE $SINGLE_OBJFILES \
+        ${SINGLE_OSQP_DIR}/lib/libosqp.a -lc -lm -lpthread $DLLIB
+    /bin/rm -f $SINGLE_OBJFILES
+
+    if [ -f $SINGLE_FILE ]
+    then
+        echo "Generated single-precision library:" $SINGLE_FILE
+    else
+        echo "Linking failed; exiting."
+        exit 1
+    fi
+fi
+
+# When CODEGEN_MODELS lists model files (written by OsqpModel.save), build
+# a specialized solver library for each one from the code generated by
+# bin/codegen.py (which requires the OSQP Python interface); the library
+# is named after the model file.  CODEGEN_EMBEDDED selects vector updates
+# only (1, the default) or vector and matrix updates (2).  The generated
+# code defines the OSQP functions itself, so only the d3x_embedded entry
+# points are exported and the library binds its own calls internally...
+if [ -n "$CODEGEN_MODELS" ]
+then
+    EMBEDDED=${CODEGEN_EMBEDDED:-1}
+
+    for MODELFILE in $CODEGEN_MODELS
+    do
+        MODELNAME=`basename $MODELFILE | sed 's/\.[^.]*$//'`
+        GENDIR=${D3X_LIBDIR}/codegen/${MODELNAME}
+        GENFILE=${D3X_LIBDIR}/lib${D3X_LIBNAME}-${MODELNAME}${SUFFIX}
+
+        python3 `dirname $0`/codegen.py $MODELFILE $GENDIR $EMBEDDED
+
+        if [ ! -d ${GENDIR}/src/osqp ]
+        then
+            echo "Code generation failed for $MODELFILE; exiting."
+            exit 1
+        fi
+
+        /bin/rm -f $GENFILE
+        $CC $SHARED -O2 -fvisibility=hidden $SYMBOLIC -I${GENDIR}/include -I$SRCDIR \
+            -o $GENFILE ${GENDIR}/src/osqp/*.c ${SRCDIR}/d3x_embedded.c -lm -lpthread
+
+        if [ -f $GENFILE ]
+        then
+            echo "Generated specialized library:" $GENFILE
+        else
+            echo "Compilation failed for $MODELFILE; exiting."
+            exit 1
+        fi
+    done
+fi
+
 exit 0
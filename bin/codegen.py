@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+########################################################################
+# Copyright (C) 2022 D3X Systems - All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+# implied.  See the License for the specific language governing
+# permissions and limitations under the License.
+########################################################################
+
+"""
+Generates the embedded C code for a problem saved by OsqpModel.save() with
+the code generator of the OSQP Python interface (osqp 0.6.2).  The code is
+specialized to the dimensions, sparsity pattern, settings, and (unless
+EMBEDDED=2) matrix values of the problem; bin/build.sh compiles it with
+src/main/C/d3x_embedded.c into a library loaded by OsqpEmbedded.
+
+Usage: codegen.py <MODEL_FILE> <OUTPUT_DIR> [1|2]
+"""
+
+import struct
+import sys
+
+import numpy as np
+import osqp
+import scipy.sparse as sparse
+
+# The magic string and header layout written by OsqpModelFile...
+MAGIC = b"D3XOSQP\0"
+VERSION = 1
+HEADER_SIZE = 64
+
+# The solver settings in the order of OsqpParam; the parameters enforced
+# by the adapter or fixed by the code generator are not passed on...
+PARAMS = [
+    ("rho", float),
+    ("sigma", float),
+    ("alpha", float),
+    ("polish", bool),
+    ("max_iter", int),
+    ("eps_abs", float),
+    ("eps_rel", float),
+    ("eps_prim_inf", float),
+    ("eps_dual_inf", float),
+    ("scaling", int),
+    ("adaptive_rho", bool),
+    ("adaptive_rho_interval", int),
+    ("adaptive_rho_tolerance", float),
+    ("adaptive_rho_fraction", float),
+    ("delta", float),
+    ("polish_refine_iter", int),
+    ("verbose", bool),
+    ("scaled_termination", bool),
+    ("check_termination", int),
+    ("warm_start", bool),
+    (None, None),  # TIME_LIMIT
+    (None, None),  # LINSYS_SOLVER (always QDLDL)
+]
+
+
+def read_model(path):
+    with open(path, "rb") as file:
+        content = file.read()
+
+    if content[:len(MAGIC)] != MAGIC:
+        raise ValueError("%s is not a model file" % path)
+
+    # The file is written in native byte order...
+    header = struct.unpack("=7q", content[len(MAGIC):HEADER_SIZE])
+    version, num_var, num_con, num_dual, quad_nnz, lin_nnz, param_count = header
+
+    if version != VERSION:
+        raise ValueError("Unsupported model file version: %d" % version)
+
+    offset = HEADER_SIZE
+
+    def take(dtype, count):
+        nonlocal offset
+        values = np.frombuffer(content, dtype=dtype, count=count, offset=offset)
+        offset += 8 * count
+        return values
+
+    params = take(np.float64, param_count)
+    q = take(np.float64, num_var)
+    l = take(np.float64, num_dual)
+    u = take(np.float64, num_dual)
+    p_colptr = take(np.int64, num_var + 1)
+    p_rowind = take(np.int64, quad_nnz)
+    p_values = take(np.float64, quad_nnz)
+    a_colptr = take(np.int64, num_var + 1)
+    a_rowind = take(np.int64, lin_nnz)
+    a_values = take(np.float64, lin_nnz)
+
+    P = sparse.csc_matrix((p_values, p_rowind, p_colptr), shape=(num_var, num_var))
+    A = sparse.csc_matrix((a_values, a_rowind, a_colptr), shape=(num_dual, num_var))
+
+    settings = {}
+
+    for index, value in enumerate(params):
+        if index >= len(PARAMS) or np.isnan(value):
+            continue
+
+        name, kind = PARAMS[index]
+
+        if name is not None:
+            settings[name] = kind(round(value)) if kind is not float else float(value)
+
+    return P, q, A, l, u, settings
+
+
+def main(argv):
+    if len(argv) < 3 or len(argv) > 4:
+        print("Usage: %s <MODEL_FILE> <OUTPUT_DIR> [1|2]" % argv[0])
+        return 1
+
+    embedded = int(argv[3]) if len(argv) == 4 else 1
+
+    if embedded not in (1, 2):
+        print("EMBEDDED must be 1 (vector updates) or 2 (vector and matrix updates)")
+        return 1
+
+    P, q, A, l, u, settings = read_model(argv[1])
+
+    # The Java bounds use +/-1e20 for infinity, which OSQP also treats
+    # as infinite...
+    solver = osqp.OSQP()
+    solver.setup(P=P, q=q, A=A, l=l, u=u, **settings)
+    solver.codegen(
+        argv[2],
+        project_type="",
+        parameters="vectors" if embedded == 1 else "matrices",
+        force_rewrite=True,
+        compile_python_ext=False,
+        FLOAT=False,
+        LONG=True)
+
+    print("Generated code:", argv[2])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
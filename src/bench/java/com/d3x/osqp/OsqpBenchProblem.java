@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+import java.util.Random;
+
+/**
+ * Generates reproducible benchmark problems with a range of structures:
+ * dense quadratic programs, banded (sparse) programs, and portfolio
+ * programs with a diagonal plus low-rank covariance matrix.
+ *
+ * <p>The coefficients are held as triplets, so that each benchmark phase
+ * (model population, matrix assembly, native setup) may be measured on
+ * its own.</p>
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpBenchProblem {
+    /**
+     * Enumerates the problem structures.
+     */
+    enum Shape {
+        /** A dense positive definite objective with one budget constraint. */
+        DENSE,
+
+        /** A banded objective with bounded differences between neighbors. */
+        BANDED,
+
+        /** A diagonal plus low-rank objective with one budget constraint. */
+        PORTFOLIO
+    }
+
+    final int numVar;
+    final int numCon;
+    final double[] linObj;
+    final double[] conLower;
+    final double[] conUpper;
+    final double[] varLower;
+    final double[] varUpper;
+    final Triplets quadObj;
+    final Triplets linCon;
+
+    /**
+     * A growable list of (row, column, value) triplets.
+     */
+    static final class Triplets {
+        int size = 0;
+        int[] rows = new int[16];
+        int[] cols = new int[16];
+        double[] values = new double[16];
+
+        void add(int row, int col, double value) {
+            if (size == rows.length) {
+                rows = Arrays.copyOf(rows, 2 * size);
+                cols = Arrays.copyOf(cols, 2 * size);
+                values = Arrays.copyOf(values, 2 * size);
+            }
+
+            rows[size] = row;
+            cols[size] = col;
+            values[size] = value;
+            ++size;
+        }
+    }
+
+    private OsqpBenchProblem(int numVar, int numCon) {
+        this.numVar = numVar;
+        this.numCon = numCon;
+        this.linObj = new double[numVar];
+        this.conLower = new double[numCon];
+        this.conUpper = new double[numCon];
+        this.varLower = new double[numVar];
+        this.varUpper = new double[numVar];
+        this.quadObj = new Triplets();
+        this.linCon = new Triplets();
+    }
+
+    /**
+     * Generates a benchmark problem.
+     *
+     * @param shape  the problem structure.
+     * @param numVar the number of decision variables.
+     * @param seed   the seed for the random coefficients.
+     *
+     * @return the benchmark problem.
+     */
+    static OsqpBenchProblem create(Shape shape, int numVar, long seed) {
+        var random = new Random(seed);
+
+        switch (shape) {
+        case DENSE:
+            return dense(numVar, random);
+
+        case BANDED:
+            return banded(numVar, random);
+
+        case PORTFOLIO:
+            return portfolio(numVar, random);
+
+        default:
+            throw new IllegalArgumentException("Unknown shape: " + shape);
+        }
+    }
+
+    private static OsqpBenchProblem dense(int numVar, Random random) {
+        var problem = new OsqpBenchProblem(numVar, 1);
+        var factor = new double[numVar][numVar];
+
+        for (int i = 0; i < numVar; ++i)
+            for (int j = 0; j < numVar; ++j)
+                factor[i][j] = random.nextGaussian();
+
+        // P = F'F / n + 0.1 I, upper triangle only...
+        for (int j = 0; j < numVar; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                var value = 0.0;
+
+                for (int k = 0; k < numVar; ++k)
+                    value += factor[k][i] * factor[k][j];
+
+                value /= numVar;
+
+                if (i == j)
+                    value += 0.1;
+
+                problem.quadObj.add(i, j, value);
+            }
+        }
+
+        problem.addBudget(random);
+        return problem;
+    }
+
+    private static OsqpBenchProblem banded(int numVar, Random random) {
+        var bandwidth = 3;
+        var problem = new OsqpBenchProblem(numVar, numVar - 1);
+
+        for (int j = 0; j < numVar; ++j) {
+            problem.quadObj.add(j, j, 2.0 * bandwidth + random.nextDouble());
+
+            for (int i = Math.max(0, j - bandwidth); i < j; ++i)
+                problem.quadObj.add(i, j, random.nextDouble() - 0.5);
+
+            problem.linObj[j] = random.nextGaussian();
+            problem.varLower[j] = -1.0;
+            problem.varUpper[j] = +1.0;
+        }
+
+        // Bounded differences between neighboring variables...
+        for (int i = 0; i < numVar - 1; ++i) {
+            problem.linCon.add(i, i, 1.0);
+            problem.linCon.add(i, i + 1, -1.0);
+            problem.conLower[i] = -0.1;
+            problem.conUpper[i] = +0.1;
+        }
+
+        return problem;
+    }
+
+    private static OsqpBenchProblem portfolio(int numVar, Random random) {
+        var numFactor = Math.max(2, numVar / 10);
+        var problem = new OsqpBenchProblem(numVar, 1);
+        var exposure = new double[numVar][numFactor];
+
+        for (int i = 0; i < numVar; ++i)
+            for (int k = 0; k < numFactor; ++k)
+                exposure[i][k] = random.nextGaussian() / Math.sqrt(numFactor);
+
+        // P = D + B B', upper triangle only...
+        for (int j = 0; j < numVar; ++j) {
+            for (int i = 0; i <= j; ++i) {
+                var value = 0.0;
+
+                for (int k = 0; k < numFactor; ++k)
+                    value += exposure[i][k] * exposure[j][k];
+
+                if (i == j)
+                    value += 0.05 + 0.05 * random.nextDouble();
+
+                problem.quadObj.add(i, j, value);
+            }
+        }
+
+        problem.addBudget(random);
+        return problem;
+    }
+
+    private void addBudget(Random random) {
+        for (int j = 0; j < numVar; ++j) {
+            linObj[j] = -0.1 * random.nextDouble();
+            varLower[j] = 0.0;
+            varUpper[j] = 1.0;
+            linCon.add(0, j, 1.0);
+        }
+
+        conLower[0] = 1.0;
+        conUpper[0] = 1.0;
+    }
+
+    /**
+     * Populates a new model through the public setters.
+     * @return a new model for this problem.
+     */
+    OsqpModel toModel() {
+        var model = OsqpModel.create(numVar, numCon);
+
+        for (int j = 0; j < numVar; ++j) {
+            model.setObjectiveCoeff(j, linObj[j]);
+            model.setVariableBound(j, varLower[j], varUpper[j]);
+        }
+
+        for (int k = 0; k < quadObj.size; ++k)
+            model.setObjectiveCoeff(quadObj.rows[k], quadObj.cols[k], quadObj.values[k]);
+
+        for (int k = 0; k < linCon.size; ++k)
+            model.setConstraintCoeff(linCon.rows[k], linCon.cols[k], linCon.values[k]);
+
+        for (int i = 0; i < numCon; ++i)
+            model.setConstraintBound(i, conLower[i], conUpper[i]);
+
+        return model;
+    }
+
+    /**
+     * Populates a new model through the bulk setters.
+     * @return a new model for this problem.
+     */
+    OsqpModel toModelBulk() {
+        return OsqpModel.create(numVar, numCon)
+                .setObjective(linObj)
+                .setVariableBounds(varLower, varUpper)
+                .setQuadraticObjective(
+                        Arrays.copyOf(quadObj.rows, quadObj.size),
+                        Arrays.copyOf(quadObj.cols, quadObj.size),
+                        Arrays.copyOf(quadObj.values, quadObj.size))
+                .setConstraintMatrix(
+                        Arrays.copyOf(linCon.rows, linCon.size),
+                        Arrays.copyOf(linCon.cols, linCon.size),
+                        Arrays.copyOf(linCon.values, linCon.size))
+                .setConstraintBounds(conLower, conUpper);
+    }
+
+    /**
+     * Returns a builder holding the quadratic objective coefficients.
+     * @return a builder holding the quadratic objective coefficients.
+     */
+    OsqpMatrixBuilder quadObjBuilder() {
+        var builder = new OsqpMatrixBuilder(numVar, numVar);
+
+        for (int k = 0; k < quadObj.size; ++k)
+            builder.put(quadObj.rows[k], quadObj.cols[k], quadObj.values[k]);
+
+        return builder;
+    }
+
+    /**
+     * Returns a builder holding the constraint coefficients, with the
+     * variable bounds as the last rows (as laid out by the model).
+     *
+     * @return a builder holding the constraint coefficients.
+     */
+    OsqpMatrixBuilder linConBuilder() {
+        var builder = new OsqpMatrixBuilder(numCon + numVar, numVar);
+
+        for (int k = 0; k < linCon.size; ++k)
+            builder.put(linCon.rows[k], linCon.cols[k], linCon.values[k]);
+
+        for (int j = 0; j < numVar; ++j)
+            builder.put(numCon + j, j, 1.0);
+
+        return builder;
+    }
+
+    /**
+     * Returns the lower bounds for all constraint rows.
+     * @return the lower bounds for all constraint rows.
+     */
+    double[] dualLower() {
+        var lower = new double[numCon + numVar];
+        System.arraycopy(conLower, 0, lower, 0, numCon);
+        System.arraycopy(varLower, 0, lower, numCon, numVar);
+        return lower;
+    }
+
+    /**
+     * Returns the upper bounds for all constraint rows.
+     * @return the upper bounds for all constraint rows.
+     */
+    double[] dualUpper() {
+        var upper = new double[numCon + numVar];
+        System.arraycopy(conUpper, 0, upper, 0, numCon);
+        System.arraycopy(varUpper, 0, upper, numCon, numVar);
+        return upper;
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+/**
+ * Measures each phase of a solve separately: populating a model through
+ * its setters, assembling the sparse matrices, marshalling vectors across
+ * JNI, the native setup (including factorization), and the ADMM solve.
+ *
+ * <p>Run with {@code mvn -P benchmark test-compile exec:exec}; pass JMH
+ * options (for example, a benchmark regex or {@code -p size=100}) with
+ * {@code -Djmh.args="..."}.</p>
+ *
+ * @author Scott Shaffer
+ */
+@Fork(1)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Thread)
+public class OsqpBenchmark {
+    @Param({ "DENSE", "BANDED", "PORTFOLIO" })
+    public OsqpBenchProblem.Shape shape;
+
+    @Param({ "20", "100", "500" })
+    public int size;
+
+    private OsqpBenchProblem problem;
+    private OsqpMatrixBuilder quadObjBuilder;
+    private OsqpMatrixBuilder linConBuilder;
+    private OsqpMatrix quadObj;
+    private OsqpMatrix linCon;
+    private double[] lower;
+    private double[] upper;
+    private double[] primal;
+    private double[] dual;
+    private double[] zeroPrimal;
+    private double[] zeroDual;
+    private OsqpSolver solver;
+
+    @Setup(Level.Trial)
+    public void setup() {
+        problem = OsqpBenchProblem.create(shape, size, 20221014L);
+        quadObjBuilder = problem.quadObjBuilder();
+        linConBuilder = problem.linConBuilder();
+        quadObj = OsqpMatrix.build(quadObjBuilder);
+        linCon = OsqpMatrix.build(linConBuilder);
+        lower = problem.dualLower();
+        upper = problem.dualUpper();
+
+        var numDual = problem.numCon + problem.numVar;
+        primal = new double[problem.numVar];
+        dual = new double[numDual];
+        zeroPrimal = new double[problem.numVar];
+        zeroDual = new double[numDual];
+        solver = setupSolver();
+
+        if (solver == null)
+            throw new IllegalStateException("Benchmark problem setup failed.");
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() {
+        solver.close();
+    }
+
+    private OsqpSolver setupSolver() {
+        Map<OsqpParam, Double> params = Map.of();
+
+        return OsqpSolver.setup(
+                problem.numVar,
+                problem.numCon + problem.numVar,
+                "",
+                problem.linObj,
+                quadObj,
+                linCon,
+                lower,
+                upper,
+                OsqpParam.toArray(params));
+    }
+
+    /**
+     * Populates a new model through the public setters.
+     * @return the populated model.
+     */
+    @Benchmark
+    public OsqpModel populate() {
+        return problem.toModel();
+    }
+
+    /**
+     * Populates a new model through the bulk setters.
+     * @return the populated model.
+     */
+    @Benchmark
+    public OsqpModel populateBulk() {
+        return problem.toModelBulk();
+    }
+
+    /**
+     * Assembles the compressed sparse column matrices.
+     * @param blackhole the sink for the matrices.
+     */
+    @Benchmark
+    public void matrixBuild(Blackhole blackhole) {
+        blackhole.consume(OsqpMatrix.build(quadObjBuilder));
+        blackhole.consume(OsqpMatrix.build(linConBuilder));
+    }
+
+    /**
+     * Sends the constraint bounds to the live workspace, which is
+     * dominated by the JNI transition and array marshalling.
+     *
+     * @return whether the workspace was updated.
+     */
+    @Benchmark
+    public boolean marshal() {
+        return solver.updateBounds(lower, upper);
+    }
+
+    /**
+     * Creates and releases a native workspace, including the data copy,
+     * scaling, and factorization performed by osqp_setup.
+     */
+    @Benchmark
+    public void setupAndCleanup() {
+        setupSolver().close();
+    }
+
+    /**
+     * Solves the problem from a cold start in the existing workspace.
+     * @return the solution status.
+     */
+    @Benchmark
+    public OsqpStatus solve() {
+        solver.warmStart(zeroPrimal, zeroDual);
+        return solver.solve(primal, dual);
+    }
+}
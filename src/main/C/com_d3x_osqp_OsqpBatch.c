@@ -0,0 +1,693 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fcntl.h>
+#include <jni.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "osqp.h"
+#include "d3x_osqp.h"
+#include "com_d3x_osqp_OsqpBatch.h"
+
+/*
+ * The number of problem dimensions stored for each problem in the batch:
+ * the number of variables, the number of constraint rows, and the number
+ * of non-zeros in the quadratic objective and constraint matrices.
+ */
+#define D3X_BATCH_DIMS 4
+
+/*
+ * The number of problems claimed by a worker thread at one time: small
+ * enough to balance the load when problem sizes vary, large enough that
+ * the shared counter is rarely contended.
+ */
+#define D3X_BATCH_CHUNK 8
+
+/*
+ * The number of dimensions passed for each model file: the number of
+ * variables and the number of constraint rows, as read by the Java code
+ * from the file header.
+ */
+#define D3X_FILE_DIMS 2
+
+/*
+ * The layout of the model files written by OsqpModelFile.java: an eight
+ * byte magic string and seven header words (the version, the number of
+ * variables, linear constraints, and constraint rows, the number of
+ * non-zeros in the quadratic objective and constraint matrices, and the
+ * number of parameters), then the parameter values and the problem data
+ * in the OsqpData layout (q, l, u, Pp, Pi, Px, Ap, Ai, Ax).
+ */
+#define D3X_FILE_MAGIC "D3XOSQP"
+#define D3X_FILE_VERSION 1
+#define D3X_FILE_HEADER_WORDS 8
+
+/*
+ * One problem in the batch, pointing into the packed Java arrays (where
+ * the index array holds Pp, Pi, Ap, and Ai and the real array holds q, Px,
+ * Ax, l, and u) or into a mapped model file.
+ */
+typedef struct {
+  c_int          numVar;
+  c_int          numDual;
+  c_int          quadObjNnz;
+  c_int          linConNnz;
+  c_int*         quadObjColPtr;
+  c_int*         quadObjRowInd;
+  c_float*       quadObjCoeff;
+  c_int*         linConColPtr;
+  c_int*         linConRowInd;
+  c_float*       linConCoeff;
+  c_float*       linObjCoeff;
+  c_float*       linConLower;
+  c_float*       linConUpper;
+  const jdouble* params;
+  c_float*       primal;
+  c_float*       dual;
+  jint*          status;
+  jdouble*       info;
+} D3XProblem;
+
+/*
+ * The problems shared by all worker threads, which claim them in chunks
+ * from an atomic counter.
+ */
+typedef struct {
+  D3XProblem* problems;
+  jint        count;
+  atomic_int  next;
+} D3XQueue;
+
+/*
+ * The workspace kept by one worker, with the problem that it was created
+ * for, so that problems with the same structure reuse the factorization,
+ * and the step size that it was created with.
+ */
+typedef struct {
+  OSQPWorkspace*    workspace;
+  const D3XProblem* setupProblem;
+  c_float           setupRho;
+} D3XWorker;
+
+static c_int d3x_index_length(const D3XProblem* problem) {
+  return 2 * (problem->numVar + 1) + problem->quadObjNnz + problem->linConNnz;
+}
+
+static c_int d3x_real_length(const D3XProblem* problem) {
+  return problem->numVar + problem->quadObjNnz + problem->linConNnz + 2 * problem->numDual;
+}
+
+static int d3x_same_index(const c_int* index1, const c_int* index2, c_int length) {
+  return index1 == index2 || memcmp(index1, index2, length * sizeof(c_int)) == 0;
+}
+
+/*
+ * Problems with identical dimensions, sparsity patterns, and parameters
+ * may be solved in the same workspace after updating the vectors and the
+ * matrix values.
+ */
+static int d3x_same_structure(const D3XProblem* prob1, const D3XProblem* prob2) {
+  return prob1->numVar == prob2->numVar
+    && prob1->numDual == prob2->numDual
+    && prob1->quadObjNnz == prob2->quadObjNnz
+    && prob1->linConNnz == prob2->linConNnz
+    && d3x_same_index(prob1->quadObjColPtr, prob2->quadObjColPtr, prob1->numVar + 1)
+    && d3x_same_index(prob1->quadObjRowInd, prob2->quadObjRowInd, prob1->quadObjNnz)
+    && d3x_same_index(prob1->linConColPtr, prob2->linConColPtr, prob1->numVar + 1)
+    && d3x_same_index(prob1->linConRowInd, prob2->linConRowInd, prob1->linConNnz)
+    && memcmp(prob1->params, prob2->params, D3X_PARAM_COUNT * sizeof(jdouble)) == 0;
+}
+
+static void d3x_problem_csc(csc*     matrix,
+                            c_int    nrow,
+                            c_int    ncol,
+                            c_int    nnz,
+                            c_int*   colptr,
+                            c_int*   rowind,
+                            c_float* values) {
+  matrix->nzmax = nnz;
+  matrix->m  = nrow;
+  matrix->n  = ncol;
+  matrix->p  = colptr;
+  matrix->i  = rowind;
+  matrix->x  = values;
+  matrix->nz = -1;
+}
+
+static OSQPWorkspace* d3x_problem_setup(const D3XProblem* problem) {
+  csc quadObj;
+  csc linCon;
+  OSQPData data;
+
+  d3x_problem_csc(&quadObj,
+                  problem->numVar,
+                  problem->numVar,
+                  problem->quadObjNnz,
+                  problem->quadObjColPtr,
+                  problem->quadObjRowInd,
+                  problem->quadObjCoeff);
+
+  d3x_problem_csc(&linCon,
+                  problem->numDual,
+                  problem->numVar,
+                  problem->linConNnz,
+                  problem->linConColPtr,
+                  problem->linConRowInd,
+                  problem->linConCoeff);
+
+  data.n = problem->numVar;
+  data.m = problem->numDual;
+  data.P = &quadObj;
+  data.A = &linCon;
+  data.q = problem->linObjCoeff;
+  data.l = problem->linConLower;
+  data.u = problem->linConUpper;
+
+  /*
+   * Unassigned parameters are marked by NaN values.  Every problem starts
+   * from the origin, whether or not its workspace is reused, so that the
+   * solutions do not depend on the order in which the workers claim them.
+   */
+  OSQPSettings settings;
+  d3x_default_settings(&settings);
+  settings.warm_start = 0;
+
+  d3x_assign_params(problem->params, &settings);
+
+  return d3x_create_workspace(&data, &settings);
+}
+
+/*
+ * Adaptive rho leaves the step size of the previous problem in the
+ * workspace; it is restored (with a refactorization) so that each problem
+ * starts from its own setting, as it would in a new workspace.
+ */
+static int d3x_problem_update(OSQPWorkspace* workspace, const D3XProblem* problem, c_float rho) {
+  jlong timer = d3x_stats_start();
+
+  int updated = (workspace->settings->rho == rho || osqp_update_rho(workspace, rho) == 0)
+    && osqp_update_lin_cost(workspace, problem->linObjCoeff) == 0
+    && osqp_update_bounds(workspace, problem->linConLower, problem->linConUpper) == 0
+    && osqp_update_P_A(workspace,
+                       problem->quadObjCoeff,
+                       OSQP_NULL,
+                       problem->quadObjNnz,
+                       problem->linConCoeff,
+                       OSQP_NULL,
+                       problem->linConNnz) == 0;
+
+  d3x_stats_lap(D3X_STAT_UPDATE, timer);
+  return updated;
+}
+
+static void d3x_worker_release(D3XWorker* worker) {
+  if (worker->workspace)
+    osqp_cleanup(worker->workspace);
+
+  worker->workspace = OSQP_NULL;
+  worker->setupProblem = OSQP_NULL;
+}
+
+/*
+ * Solves one problem, reusing the worker's workspace when the problem has
+ * the same structure as the one the workspace was created for, and writes
+ * the solution into the output arrays on success.
+ */
+static void d3x_worker_solve(D3XWorker* worker, const D3XProblem* problem) {
+  int reuse =
+    worker->workspace
+    && d3x_same_structure(worker->setupProblem, problem)
+    && d3x_problem_update(worker->workspace, problem, worker->setupRho);
+
+  if (!reuse) {
+    d3x_worker_release(worker);
+    worker->workspace = d3x_problem_setup(problem);
+
+    if (!worker->workspace) {
+      *problem->status = D3X_SETUP_ERROR;
+      return;
+    }
+
+    worker->setupProblem = problem;
+    worker->setupRho = worker->workspace->settings->rho;
+  }
+
+  /*
+   * A batch solve cannot be cancelled, but each problem keeps its own
+   * time limit.
+   */
+  jdouble timeLimit = problem->params[D3X_PARAM_TIME_LIMIT];
+
+  jlong timer = d3x_stats_start();
+  c_int status = d3x_solve(worker->workspace, OSQP_NULL, isnan(timeLimit) ? 0.0 : timeLimit, OSQP_NULL);
+  timer = d3x_stats_lap(D3X_STAT_SOLVE, timer);
+
+  if (status == 0) {
+    memcpy(problem->primal, worker->workspace->solution->x, problem->numVar * sizeof(c_float));
+    memcpy(problem->dual, worker->workspace->solution->y, problem->numDual * sizeof(c_float));
+    status = worker->workspace->info->status_val;
+  }
+
+  *problem->status = (jint) status;
+  d3x_copy_info(worker->workspace->info, problem->info);
+  d3x_stats_lap(D3X_STAT_SET_REGION, timer);
+}
+
+static void* d3x_worker_run(void* arg) {
+  D3XQueue* queue = (D3XQueue*) arg;
+  D3XWorker worker = { OSQP_NULL, OSQP_NULL, 0.0 };
+
+  for (;;) {
+    jint first = atomic_fetch_add(&queue->next, D3X_BATCH_CHUNK);
+
+    if (first >= queue->count)
+      break;
+
+    jint last = first + D3X_BATCH_CHUNK;
+
+    if (last > queue->count)
+      last = queue->count;
+
+    for (jint problem = first; problem < last; ++problem)
+      d3x_worker_solve(&worker, queue->problems + problem);
+  }
+
+  d3x_worker_release(&worker);
+  d3x_stats_flush();
+  return OSQP_NULL;
+}
+
+/*
+ * Runs the worker loop on the requested number of threads, including the
+ * calling thread; runs serially if the threads cannot be created.
+ */
+static void d3x_queue_run(D3XQueue* queue, jint numThreads) {
+  if (numThreads > queue->count)
+    numThreads = queue->count;
+
+  if (numThreads < 1)
+    numThreads = 1;
+
+  pthread_t* threads = (pthread_t*) d3x_arena_alloc(numThreads * sizeof(pthread_t));
+  jint started = 0;
+
+  if (threads) {
+    while (started < numThreads - 1) {
+      if (pthread_create(threads + started, OSQP_NULL, d3x_worker_run, queue) != 0) {
+        fprintf(stderr, "Failed to create batch worker thread.\n");
+        break;
+      }
+
+      ++started;
+    }
+  }
+
+  d3x_worker_run(queue);
+
+  for (jint thread = 0; thread < started; ++thread)
+    pthread_join(threads[thread], OSQP_NULL);
+}
+
+/*
+ * A model file mapped into memory for the duration of a batch.
+ */
+typedef struct {
+  void*  address;
+  size_t length;
+} D3XMapping;
+
+static int d3x_file_csc_valid(const c_int* colptr, const c_int* rowind, c_int nrow, c_int ncol, c_int nnz) {
+  if (colptr[0] != 0 || colptr[ncol] != nnz)
+    return 0;
+
+  for (c_int col = 0; col < ncol; ++col)
+    if (colptr[col] > colptr[col + 1])
+      return 0;
+
+  for (c_int index = 0; index < nnz; ++index)
+    if (rowind[index] < 0 || rowind[index] >= nrow)
+      return 0;
+
+  return 1;
+}
+
+/*
+ * Points a problem into a mapped model file after checking the header and
+ * the sparse matrix structure.  The parameters stored in the file fill
+ * the parameter slots that are not overridden (those that hold NaN).
+ */
+static int d3x_file_problem(const D3XMapping* mapping,
+                            const jlong*      dims,
+                            jdouble*          params,
+                            D3XProblem*       problem) {
+  const c_int* header = (const c_int*) mapping->address;
+  c_int maxWords = (c_int) (mapping->length / sizeof(c_int));
+
+  if (maxWords < D3X_FILE_HEADER_WORDS
+      || memcmp(header, D3X_FILE_MAGIC, sizeof(c_int)) != 0
+      || header[1] != D3X_FILE_VERSION)
+    return 0;
+
+  c_int numVar     = header[2];
+  c_int numCon     = header[3];
+  c_int numDual    = header[4];
+  c_int quadObjNnz = header[5];
+  c_int linConNnz  = header[6];
+  c_int paramCount = header[7];
+
+  if (numVar != dims[0] || numDual != dims[1] || numCon < 0 || numCon > numDual)
+    return 0;
+
+  /*
+   * Each count is checked against the file size before it is multiplied,
+   * so the total cannot overflow.
+   */
+  if (numVar < 1 || numVar > maxWords
+      || numDual < 0 || numDual > maxWords
+      || quadObjNnz < 0 || quadObjNnz > maxWords
+      || linConNnz < 0 || linConNnz > maxWords
+      || paramCount < 0 || paramCount > maxWords)
+    return 0;
+
+  c_int words = D3X_FILE_HEADER_WORDS + paramCount
+    + 3 * numVar + 2 * numDual + 2 + 2 * quadObjNnz + 2 * linConNnz;
+
+  if (words > maxWords)
+    return 0;
+
+  const jdouble* stored = (const jdouble*) (header + D3X_FILE_HEADER_WORDS);
+
+  /*
+   * The mapping is read-only; OSQP copies the problem data during setup
+   * and only reads them during updates.
+   */
+  c_float* next = (c_float*) (stored + paramCount);
+
+  problem->numVar     = numVar;
+  problem->numDual    = numDual;
+  problem->quadObjNnz = quadObjNnz;
+  problem->linConNnz  = linConNnz;
+
+  problem->linObjCoeff   = next;
+  problem->linConLower   = problem->linObjCoeff + numVar;
+  problem->linConUpper   = problem->linConLower + numDual;
+  problem->quadObjColPtr = (c_int*) (problem->linConUpper + numDual);
+  problem->quadObjRowInd = problem->quadObjColPtr + numVar + 1;
+  problem->quadObjCoeff  = (c_float*) (problem->quadObjRowInd + quadObjNnz);
+  problem->linConColPtr  = (c_int*) (problem->quadObjCoeff + quadObjNnz);
+  problem->linConRowInd  = problem->linConColPtr + numVar + 1;
+  problem->linConCoeff   = (c_float*) (problem->linConRowInd + linConNnz);
+
+  if (!d3x_file_csc_valid(problem->quadObjColPtr, problem->quadObjRowInd, numVar, numVar, quadObjNnz)
+      || !d3x_file_csc_valid(problem->linConColPtr, problem->linConRowInd, numDual, numVar, linConNnz))
+    return 0;
+
+  for (c_int paramIndex = 0; paramIndex < D3X_PARAM_COUNT && paramIndex < paramCount; ++paramIndex)
+    if (isnan(params[paramIndex]))
+      params[paramIndex] = stored[paramIndex];
+
+  problem->params = params;
+  return 1;
+}
+
+/*
+ * Maps a model file read-only; returns 0 if the file cannot be mapped.
+ */
+static int d3x_file_map(const char* path, D3XMapping* mapping) {
+  mapping->address = OSQP_NULL;
+  mapping->length = 0;
+
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+    return 0;
+
+  struct stat fileStat;
+
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    close(fd);
+    return 0;
+  }
+
+  void* address = mmap(OSQP_NULL, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (address == MAP_FAILED)
+    return 0;
+
+  mapping->address = address;
+  mapping->length = (size_t) fileStat.st_size;
+  return 1;
+}
+
+static void d3x_file_unmap(D3XMapping* mapping) {
+  if (mapping->address)
+    munmap(mapping->address, mapping->length);
+
+  mapping->address = OSQP_NULL;
+  mapping->length = 0;
+}
+
+/*
+ * The problem data for all problems in the batch are packed into a few
+ * contiguous arrays, so the Java arrays are pinned (or copied) once for
+ * the entire batch.  The worker threads never call back into the JVM.
+ * The inputs are released with JNI_ABORT; the outputs are copied back.
+ */
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpBatch_solveBatch(JNIEnv*      jniEnv,
+                                       jclass       jniClass,
+                                       jstring      logName,
+                                       jint         numThreads,
+                                       jint         count,
+                                       jint         paramCount,
+                                       jlongArray   dims,
+                                       jlongArray   index,
+                                       jdoubleArray reals,
+                                       jdoubleArray params,
+                                       jdoubleArray primal,
+                                       jdoubleArray dual,
+                                       jintArray    status,
+                                       jdoubleArray info) {
+  if (!d3x_check_types() || !d3x_check_params(jniEnv, params, count, paramCount))
+    return;
+
+  d3x_arena_begin(count * sizeof(D3XProblem) + (numThreads > 0 ? numThreads : 1) * sizeof(pthread_t) + 2 * D3X_ARENA_ALIGN);
+  D3XProblem* problems = (D3XProblem*) d3x_arena_alloc(count * sizeof(D3XProblem));
+
+  if (!problems) {
+    fprintf(stderr, "Failed to allocate batch problems.\n");
+    d3x_arena_end();
+    return;
+  }
+
+  jlong timer = d3x_stats_start();
+
+  jlong*   nativeDims   = (*jniEnv)->GetLongArrayElements(jniEnv, dims, 0);
+  jlong*   nativeIndex  = (*jniEnv)->GetLongArrayElements(jniEnv, index, 0);
+  jdouble* nativeReals  = (*jniEnv)->GetDoubleArrayElements(jniEnv, reals, 0);
+  jdouble* nativeParams = (*jniEnv)->GetDoubleArrayElements(jniEnv, params, 0);
+  jdouble* nativePrimal = (*jniEnv)->GetDoubleArrayElements(jniEnv, primal, 0);
+  jdouble* nativeDual   = (*jniEnv)->GetDoubleArrayElements(jniEnv, dual, 0);
+  jint*    nativeStatus = (*jniEnv)->GetIntArrayElements(jniEnv, status, 0);
+  jdouble* nativeInfo   = (*jniEnv)->GetDoubleArrayElements(jniEnv, info, 0);
+
+  d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  /*
+   * Locate each problem within the packed arrays.
+   */
+  c_int*   nextIndex  = (c_int*) nativeIndex;
+  c_float* nextReal   = (c_float*) nativeReals;
+  c_float* nextPrimal = (c_float*) nativePrimal;
+  c_float* nextDual   = (c_float*) nativeDual;
+
+  for (jint k = 0; k < count; ++k) {
+    D3XProblem* problem = problems + k;
+    const jlong* problemDims = nativeDims + k * D3X_BATCH_DIMS;
+
+    problem->numVar     = problemDims[0];
+    problem->numDual    = problemDims[1];
+    problem->quadObjNnz = problemDims[2];
+    problem->linConNnz  = problemDims[3];
+    problem->params     = nativeParams + k * D3X_PARAM_COUNT;
+    problem->primal     = nextPrimal;
+    problem->dual       = nextDual;
+    problem->status     = nativeStatus + k;
+    problem->info       = nativeInfo + k * D3X_INFO_COUNT;
+
+    problem->quadObjColPtr = nextIndex;
+    problem->quadObjRowInd = problem->quadObjColPtr + problem->numVar + 1;
+    problem->linConColPtr  = problem->quadObjRowInd + problem->quadObjNnz;
+    problem->linConRowInd  = problem->linConColPtr + problem->numVar + 1;
+
+    problem->linObjCoeff  = nextReal;
+    problem->quadObjCoeff = problem->linObjCoeff + problem->numVar;
+    problem->linConCoeff  = problem->quadObjCoeff + problem->quadObjNnz;
+    problem->linConLower  = problem->linConCoeff + problem->linConNnz;
+    problem->linConUpper  = problem->linConLower + problem->numDual;
+
+    nextIndex  += d3x_index_length(problem);
+    nextReal   += d3x_real_length(problem);
+    nextPrimal += problem->numVar;
+    nextDual   += problem->numDual;
+  }
+
+  D3XQueue queue;
+  queue.problems = problems;
+  queue.count = count;
+  atomic_init(&queue.next, 0);
+
+  int logOpened = d3x_open_log(jniEnv, logName);
+  d3x_queue_run(&queue, numThreads);
+  d3x_close_log(logOpened);
+
+  timer = d3x_stats_start();
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, info, nativeInfo, 0);
+  (*jniEnv)->ReleaseIntArrayElements(jniEnv, status, nativeStatus, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, dual, nativeDual, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, primal, nativePrimal, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, params, nativeParams, JNI_ABORT);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, reals, nativeReals, JNI_ABORT);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, index, nativeIndex, JNI_ABORT);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, dims, nativeDims, JNI_ABORT);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_arena_end();
+  d3x_stats_flush();
+}
+
+/*
+ * The problem data are read in place from the mapped model files and
+ * never enter the Java heap.  The files are mapped by the calling thread
+ * before the workers start and unmapped after they finish, so a worker
+ * may compare the structure of a problem with the one its workspace was
+ * created for.  Files that cannot be mapped or fail validation keep the
+ * SETUP_ERROR status assigned by the Java code.  The parameter array is
+ * scratch space for the merged parameters and is released with JNI_ABORT.
+ */
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpBatch_solveFiles(JNIEnv*      jniEnv,
+                                       jclass       jniClass,
+                                       jstring      logName,
+                                       jint         numThreads,
+                                       jint         count,
+                                       jint         paramCount,
+                                       jobjectArray paths,
+                                       jlongArray   dims,
+                                       jdoubleArray params,
+                                       jdoubleArray primal,
+                                       jdoubleArray dual,
+                                       jintArray    status,
+                                       jdoubleArray info) {
+  if (!d3x_check_types() || !d3x_check_params(jniEnv, params, count, paramCount))
+    return;
+
+  d3x_arena_begin(count * (sizeof(D3XProblem) + sizeof(D3XMapping))
+                  + (numThreads > 0 ? numThreads : 1) * sizeof(pthread_t)
+                  + 3 * D3X_ARENA_ALIGN);
+  D3XProblem* problems = (D3XProblem*) d3x_arena_alloc(count * sizeof(D3XProblem));
+  D3XMapping* mappings = (D3XMapping*) d3x_arena_alloc(count * sizeof(D3XMapping));
+
+  if (!problems || !mappings) {
+    fprintf(stderr, "Failed to allocate batch problems.\n");
+    d3x_arena_end();
+    return;
+  }
+
+  memset(mappings, 0, count * sizeof(D3XMapping));
+
+  jlong timer = d3x_stats_start();
+
+  jlong*   nativeDims   = (*jniEnv)->GetLongArrayElements(jniEnv, dims, 0);
+  jdouble* nativeParams = (*jniEnv)->GetDoubleArrayElements(jniEnv, params, 0);
+  jdouble* nativePrimal = (*jniEnv)->GetDoubleArrayElements(jniEnv, primal, 0);
+  jdouble* nativeDual   = (*jniEnv)->GetDoubleArrayElements(jniEnv, dual, 0);
+  jint*    nativeStatus = (*jniEnv)->GetIntArrayElements(jniEnv, status, 0);
+  jdouble* nativeInfo   = (*jniEnv)->GetDoubleArrayElements(jniEnv, info, 0);
+
+  d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  /*
+   * Map each file and locate its outputs; only the valid problems are
+   * queued for the workers.
+   */
+  c_float* nextPrimal = (c_float*) nativePrimal;
+  c_float* nextDual   = (c_float*) nativeDual;
+  jint valid = 0;
+
+  for (jint k = 0; k < count; ++k) {
+    const jlong* fileDims = nativeDims + k * D3X_FILE_DIMS;
+    D3XProblem* problem = problems + valid;
+
+    jstring path = (jstring) (*jniEnv)->GetObjectArrayElement(jniEnv, paths, k);
+    const char* pathChars = (*jniEnv)->GetStringUTFChars(jniEnv, path, 0);
+
+    int mapped =
+      pathChars
+      && d3x_file_map(pathChars, mappings + k)
+      && d3x_file_problem(mappings + k, fileDims, nativeParams + k * D3X_PARAM_COUNT, problem);
+
+    if (mapped) {
+      problem->primal = nextPrimal;
+      problem->dual   = nextDual;
+      problem->status = nativeStatus + k;
+      problem->info   = nativeInfo + k * D3X_INFO_COUNT;
+      ++valid;
+    }
+    else {
+      fprintf(stderr, "Failed to load model file: %s\n", pathChars ? pathChars : "");
+      d3x_file_unmap(mappings + k);
+    }
+
+    if (pathChars)
+      (*jniEnv)->ReleaseStringUTFChars(jniEnv, path, pathChars);
+
+    (*jniEnv)->DeleteLocalRef(jniEnv, path);
+
+    nextPrimal += fileDims[0];
+    nextDual   += fileDims[1];
+  }
+
+  D3XQueue queue;
+  queue.problems = problems;
+  queue.count = valid;
+  atomic_init(&queue.next, 0);
+
+  int logOpened = d3x_open_log(jniEnv, logName);
+  d3x_queue_run(&queue, numThreads);
+  d3x_close_log(logOpened);
+
+  for (jint k = 0; k < count; ++k)
+    d3x_file_unmap(mappings + k);
+
+  timer = d3x_stats_start();
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, info, nativeInfo, 0);
+  (*jniEnv)->ReleaseIntArrayElements(jniEnv, status, nativeStatus, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, dual, nativeDual, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, primal, nativePrimal, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, params, nativeParams, JNI_ABORT);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, dims, nativeDims, JNI_ABORT);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_arena_end();
+  d3x_stats_flush();
+}
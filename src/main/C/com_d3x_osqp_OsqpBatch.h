@@ -0,0 +1,29 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class com_d3x_osqp_OsqpBatch */
+
+#ifndef _Included_com_d3x_osqp_OsqpBatch
+#define _Included_com_d3x_osqp_OsqpBatch
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     com_d3x_osqp_OsqpBatch
+ * Method:    solveBatch
+ * Signature: (Ljava/lang/String;III[J[J[D[D[D[D[I[D)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpBatch_solveBatch
+  (JNIEnv *, jclass, jstring, jint, jint, jint, jlongArray, jlongArray, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray, jintArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpBatch
+ * Method:    solveFiles
+ * Signature: (Ljava/lang/String;III[Ljava/lang/String;[J[D[D[D[I[D)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpBatch_solveFiles
+  (JNIEnv *, jclass, jstring, jint, jint, jint, jobjectArray, jlongArray, jdoubleArray, jdoubleArray, jdoubleArray, jintArray, jdoubleArray);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
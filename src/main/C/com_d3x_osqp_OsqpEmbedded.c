@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include <dlfcn.h>
+#include <math.h>
+#include <stdlib.h>
+#include "osqp.h"
+#include "d3x_osqp.h"
+#include "d3x_embedded.h"
+#include "com_d3x_osqp_OsqpEmbedded.h"
+
+static D3XEmbedded* d3x_embedded(jlong handle) {
+  return (D3XEmbedded*) handle;
+}
+
+/*
+ * Loads a specialized solver library privately, so that its OSQP symbols
+ * neither replace nor are replaced by those of the OSQP library linked
+ * into the adapter, and resolves its entry points.  Returns zero if the
+ * library cannot be loaded or is not a specialized solver.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_load(JNIEnv* jniEnv,
+                                    jclass  jniClass,
+                                    jstring path) {
+  const char* fileName = (*jniEnv)->GetStringUTFChars(jniEnv, path, NULL);
+  void* library = dlopen(fileName, RTLD_NOW | RTLD_LOCAL);
+  (*jniEnv)->ReleaseStringUTFChars(jniEnv, path, fileName);
+
+  if (!library)
+    return 0;
+
+  D3XEmbedded* embedded = (D3XEmbedded*) calloc(1, sizeof(D3XEmbedded));
+
+  if (!embedded) {
+    dlclose(library);
+    return 0;
+  }
+
+  embedded->library        = library;
+  embedded->dims           = (void (*)(long long*)) dlsym(library, "d3x_embedded_dims");
+  embedded->matrices       = (void (*)(long long*, long long*, double*, long long*, long long*, double*)) dlsym(library, "d3x_embedded_matrices");
+  embedded->solve          = (int (*)(const double*, const double*, const double*, double*, double*, double*)) dlsym(library, "d3x_embedded_solve");
+  embedded->warmStart      = (int (*)(const double*, const double*)) dlsym(library, "d3x_embedded_warm_start");
+  embedded->updateMatrices = (int (*)(const double*, const double*)) dlsym(library, "d3x_embedded_update_matrices");
+  embedded->settings       = (void (*)(double*)) dlsym(library, "d3x_embedded_settings");
+  embedded->updateSettings = (int (*)(const double*)) dlsym(library, "d3x_embedded_update_settings");
+
+  if (!embedded->dims || !embedded->matrices || !embedded->solve || !embedded->warmStart || !embedded->updateMatrices
+      || !embedded->settings || !embedded->updateSettings) {
+    dlclose(library);
+    free(embedded);
+    return 0;
+  }
+
+  return (jlong) embedded;
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_dims(JNIEnv*    jniEnv,
+                                    jclass     jniClass,
+                                    jlong      handle,
+                                    jlongArray dims) {
+  long long values[D3X_EMBEDDED_DIM_COUNT];
+  d3x_embedded(handle)->dims(values);
+
+  jlong copy[D3X_EMBEDDED_DIM_COUNT];
+
+  for (int k = 0; k < D3X_EMBEDDED_DIM_COUNT; ++k)
+    copy[k] = (jlong) values[k];
+
+  (*jniEnv)->SetLongArrayRegion(jniEnv, dims, 0, D3X_EMBEDDED_DIM_COUNT, copy);
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_matrices(JNIEnv*      jniEnv,
+                                        jclass       jniClass,
+                                        jlong        handle,
+                                        jlongArray   quadColPtr,
+                                        jlongArray   quadRowInd,
+                                        jdoubleArray quadValues,
+                                        jlongArray   linColPtr,
+                                        jlongArray   linRowInd,
+                                        jdoubleArray linValues) {
+  jlong*   nativeQuadColPtr = (*jniEnv)->GetLongArrayElements(jniEnv, quadColPtr, 0);
+  jlong*   nativeQuadRowInd = (*jniEnv)->GetLongArrayElements(jniEnv, quadRowInd, 0);
+  jdouble* nativeQuadValues = (*jniEnv)->GetDoubleArrayElements(jniEnv, quadValues, 0);
+  jlong*   nativeLinColPtr  = (*jniEnv)->GetLongArrayElements(jniEnv, linColPtr, 0);
+  jlong*   nativeLinRowInd  = (*jniEnv)->GetLongArrayElements(jniEnv, linRowInd, 0);
+  jdouble* nativeLinValues  = (*jniEnv)->GetDoubleArrayElements(jniEnv, linValues, 0);
+
+  /*
+   * jlong and long long are both 64-bit integers (d3x_check_types).
+   */
+  d3x_embedded(handle)->matrices(
+    (long long*) nativeQuadColPtr,
+    (long long*) nativeQuadRowInd,
+    nativeQuadValues,
+    (long long*) nativeLinColPtr,
+    (long long*) nativeLinRowInd,
+    nativeLinValues);
+
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, linValues, nativeLinValues, 0);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, linRowInd, nativeLinRowInd, 0);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, linColPtr, nativeLinColPtr, 0);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, quadValues, nativeQuadValues, 0);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, quadRowInd, nativeQuadRowInd, 0);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, quadColPtr, nativeQuadColPtr, 0);
+}
+
+/*
+ * The solve needs no setup and allocates nothing: the vectors are pinned
+ * or copied by the JVM, passed to the generated workspace, and released.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_solve(JNIEnv*      jniEnv,
+                                     jclass       jniClass,
+                                     jlong        handle,
+                                     jdoubleArray linObjCoeff,
+                                     jdoubleArray linConLower,
+                                     jdoubleArray linConUpper,
+                                     jdoubleArray optPrimal,
+                                     jdoubleArray optDual,
+                                     jdoubleArray solveInfo) {
+  jlong timer = d3x_stats_start();
+
+  jdouble* q = linObjCoeff ? (*jniEnv)->GetDoubleArrayElements(jniEnv, linObjCoeff, 0) : NULL;
+  jdouble* l = linConLower ? (*jniEnv)->GetDoubleArrayElements(jniEnv, linConLower, 0) : NULL;
+  jdouble* u = linConUpper ? (*jniEnv)->GetDoubleArrayElements(jniEnv, linConUpper, 0) : NULL;
+  jdouble* x = (*jniEnv)->GetDoubleArrayElements(jniEnv, optPrimal, 0);
+  jdouble* y = (*jniEnv)->GetDoubleArrayElements(jniEnv, optDual, 0);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  double embeddedInfo[D3X_EMBEDDED_INFO_COUNT];
+  int status = d3x_embedded(handle)->solve(q, l, u, x, y, embeddedInfo);
+  timer = d3x_stats_lap(D3X_STAT_SOLVE, timer);
+
+  if (status != D3X_EMBEDDED_UPDATE_ERROR) {
+    jdouble infoValues[D3X_INFO_COUNT];
+
+    for (int k = 0; k < D3X_INFO_COUNT; ++k)
+      infoValues[k] = NAN;
+
+    infoValues[D3X_INFO_ITER]          = embeddedInfo[D3X_EMBEDDED_ITER];
+    infoValues[D3X_INFO_STATUS_VAL]    = embeddedInfo[D3X_EMBEDDED_STATUS_VAL];
+    infoValues[D3X_INFO_STATUS_POLISH] = 0.0;
+    infoValues[D3X_INFO_OBJ_VAL]       = embeddedInfo[D3X_EMBEDDED_OBJ_VAL];
+    infoValues[D3X_INFO_PRI_RES]       = embeddedInfo[D3X_EMBEDDED_PRI_RES];
+    infoValues[D3X_INFO_DUA_RES]       = embeddedInfo[D3X_EMBEDDED_DUA_RES];
+    infoValues[D3X_INFO_RHO_UPDATES]   = embeddedInfo[D3X_EMBEDDED_RHO_UPDATES];
+    infoValues[D3X_INFO_RHO_ESTIMATE]  = embeddedInfo[D3X_EMBEDDED_RHO_ESTIMATE];
+
+    (*jniEnv)->SetDoubleArrayRegion(jniEnv, solveInfo, 0, D3X_INFO_COUNT, infoValues);
+  }
+
+  /*
+   * The solution arrays are copied back (mode 0) only after a solve.
+   */
+  jint mode = status != D3X_EMBEDDED_UPDATE_ERROR ? 0 : JNI_ABORT;
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, optDual, y, mode);
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, optPrimal, x, mode);
+
+  if (u)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, linConUpper, u, JNI_ABORT);
+
+  if (l)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, linConLower, l, JNI_ABORT);
+
+  if (q)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, linObjCoeff, q, JNI_ABORT);
+
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+  d3x_stats_flush();
+
+  return status != D3X_EMBEDDED_UPDATE_ERROR ? (jint) status : D3X_SETUP_ERROR;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_warmStart(JNIEnv*      jniEnv,
+                                         jclass       jniClass,
+                                         jlong        handle,
+                                         jdoubleArray primal,
+                                         jdoubleArray dual) {
+  jdouble* x = primal ? (*jniEnv)->GetDoubleArrayElements(jniEnv, primal, 0) : NULL;
+  jdouble* y = dual ? (*jniEnv)->GetDoubleArrayElements(jniEnv, dual, 0) : NULL;
+
+  int status = d3x_embedded(handle)->warmStart(x, y);
+
+  if (x)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, primal, x, JNI_ABORT);
+
+  if (y)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, dual, y, JNI_ABORT);
+
+  return (jint) status;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_updateMatrices(JNIEnv*      jniEnv,
+                                              jclass       jniClass,
+                                              jlong        handle,
+                                              jdoubleArray quadValues,
+                                              jdoubleArray linValues) {
+  jdouble* Px = quadValues ? (*jniEnv)->GetDoubleArrayElements(jniEnv, quadValues, 0) : NULL;
+  jdouble* Ax = linValues ? (*jniEnv)->GetDoubleArrayElements(jniEnv, linValues, 0) : NULL;
+
+  jlong timer = d3x_stats_start();
+  int status = d3x_embedded(handle)->updateMatrices(Px, Ax);
+  d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  if (Px)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, quadValues, Px, JNI_ABORT);
+
+  if (Ax)
+    (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, linValues, Ax, JNI_ABORT);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_settings(JNIEnv*      jniEnv,
+                                        jclass       jniClass,
+                                        jlong        handle,
+                                        jdoubleArray values) {
+  double settings[D3X_EMBEDDED_SETTING_COUNT];
+  d3x_embedded(handle)->settings(settings);
+  (*jniEnv)->SetDoubleArrayRegion(jniEnv, values, 0, D3X_EMBEDDED_SETTING_COUNT, settings);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_updateSettings(JNIEnv*      jniEnv,
+                                              jclass       jniClass,
+                                              jlong        handle,
+                                              jdoubleArray values) {
+  if ((*jniEnv)->GetArrayLength(jniEnv, values) != D3X_EMBEDDED_SETTING_COUNT)
+    return D3X_EMBEDDED_UPDATE_ERROR;
+
+  double settings[D3X_EMBEDDED_SETTING_COUNT];
+  (*jniEnv)->GetDoubleArrayRegion(jniEnv, values, 0, D3X_EMBEDDED_SETTING_COUNT, settings);
+
+  jlong timer = d3x_stats_start();
+  int status = d3x_embedded(handle)->updateSettings(settings);
+  d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+/*
+ * The library is unloaded when its last handle is closed; the generated
+ * workspace (with its last solution) is reinitialized if it is loaded
+ * again.
+ */
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpEmbedded_unload(JNIEnv* jniEnv,
+                                      jclass  jniClass,
+                                      jlong   handle) {
+  D3XEmbedded* embedded = d3x_embedded(handle);
+
+  if (embedded) {
+    dlclose(embedded->library);
+    free(embedded);
+  }
+}
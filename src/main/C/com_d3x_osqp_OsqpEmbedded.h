@@ -0,0 +1,85 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class com_d3x_osqp_OsqpEmbedded */
+
+#ifndef _Included_com_d3x_osqp_OsqpEmbedded
+#define _Included_com_d3x_osqp_OsqpEmbedded
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    load
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_com_d3x_osqp_OsqpEmbedded_load
+  (JNIEnv *, jclass, jstring);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    dims
+ * Signature: (J[J)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpEmbedded_dims
+  (JNIEnv *, jclass, jlong, jlongArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    matrices
+ * Signature: (J[J[J[D[J[J[D)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpEmbedded_matrices
+  (JNIEnv *, jclass, jlong, jlongArray, jlongArray, jdoubleArray, jlongArray, jlongArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    solve
+ * Signature: (J[D[D[D[D[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpEmbedded_solve
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    warmStart
+ * Signature: (J[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpEmbedded_warmStart
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    updateMatrices
+ * Signature: (J[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpEmbedded_updateMatrices
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    settings
+ * Signature: (J[D)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpEmbedded_settings
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    updateSettings
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpEmbedded_updateSettings
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpEmbedded
+ * Method:    unload
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpEmbedded_unload
+  (JNIEnv *, jclass, jlong);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include <dlfcn.h>
+#include "osqp.h"
+#include "lin_sys.h"
+#include "d3x_osqp.h"
+#include "com_d3x_osqp_OsqpLinsys.h"
+
+/*
+ * The MKL single dynamic library, which OSQP loads at run time to provide
+ * the Pardiso solver.
+ */
+#ifdef __APPLE__
+#define D3X_MKL_LIBNAME "libmkl_rt.dylib"
+#else
+#define D3X_MKL_LIBNAME "libmkl_rt.so"
+#endif
+
+/*
+ * OSQP loads the linear system solver in osqp_setup and unloads it in
+ * osqp_cleanup, without reference counting.  A successful load here is
+ * never undone, so the library stays resident for the life of the process
+ * and concurrent workspaces never see it unloaded.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_d3x_osqp_OsqpLinsys_loadNative(JNIEnv* jniEnv,
+                                        jclass  jniClass,
+                                        jint    solverCode) {
+  if (!d3x_check_types())
+    return JNI_FALSE;
+
+  c_int status = load_linsys_solver((enum linsys_solver_type) solverCode);
+  return status == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+ * The library handle is kept open so that the thread setting survives
+ * the unloading of the solver by osqp_cleanup.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_d3x_osqp_OsqpLinsys_setMklThreadsNative(JNIEnv* jniEnv,
+                                                 jclass  jniClass,
+                                                 jint    numThreads) {
+  void* handle = dlopen(D3X_MKL_LIBNAME, RTLD_LAZY);
+
+  if (!handle)
+    return JNI_FALSE;
+
+  void (*setNumThreads)(int) = (void (*)(int)) dlsym(handle, "MKL_Set_Num_Threads");
+
+  if (!setNumThreads)
+    return JNI_FALSE;
+
+  setNumThreads(numThreads);
+  return JNI_TRUE;
+}
@@ -0,0 +1,29 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class com_d3x_osqp_OsqpLinsys */
+
+#ifndef _Included_com_d3x_osqp_OsqpLinsys
+#define _Included_com_d3x_osqp_OsqpLinsys
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     com_d3x_osqp_OsqpLinsys
+ * Method:    loadNative
+ * Signature: (I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_d3x_osqp_OsqpLinsys_loadNative
+  (JNIEnv *, jclass, jint);
+
+/*
+ * Class:     com_d3x_osqp_OsqpLinsys
+ * Method:    setMklThreadsNative
+ * Signature: (I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_d3x_osqp_OsqpLinsys_setMklThreadsNative
+  (JNIEnv *, jclass, jint);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include "osqp.h"
+#include "d3x_osqp.h"
+#include "com_d3x_osqp_OsqpNativeStats.h"
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpNativeStats_enableNative(JNIEnv*  jniEnv,
+                                               jclass   jniClass,
+                                               jboolean enabled) {
+  d3x_stats_enable(enabled == JNI_TRUE);
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpNativeStats_resetNative(JNIEnv* jniEnv,
+                                              jclass  jniClass) {
+  d3x_stats_reset();
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpNativeStats_readNative(JNIEnv*    jniEnv,
+                                             jclass     jniClass,
+                                             jlongArray values) {
+  jlong totals[2 * D3X_STAT_COUNT + D3X_ARENA_COUNT];
+  d3x_stats_read(totals);
+  d3x_arena_read(totals + 2 * D3X_STAT_COUNT);
+  (*jniEnv)->SetLongArrayRegion(jniEnv, values, 0, 2 * D3X_STAT_COUNT + D3X_ARENA_COUNT, totals);
+}
@@ -0,0 +1,37 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class com_d3x_osqp_OsqpNativeStats */
+
+#ifndef _Included_com_d3x_osqp_OsqpNativeStats
+#define _Included_com_d3x_osqp_OsqpNativeStats
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     com_d3x_osqp_OsqpNativeStats
+ * Method:    enableNative
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpNativeStats_enableNative
+  (JNIEnv *, jclass, jboolean);
+
+/*
+ * Class:     com_d3x_osqp_OsqpNativeStats
+ * Method:    resetNative
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpNativeStats_resetNative
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     com_d3x_osqp_OsqpNativeStats
+ * Method:    readNative
+ * Signature: ([J)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpNativeStats_readNative
+  (JNIEnv *, jclass, jlongArray);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
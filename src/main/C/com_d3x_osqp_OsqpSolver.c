@@ -0,0 +1,633 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include <stdio.h>
+#include "osqp.h"
+#include "lin_alg.h"
+#include "d3x_osqp.h"
+#include "com_d3x_osqp_OsqpSolver.h"
+
+/*
+ * The native handle is the address of the OSQPWorkspace, which owns
+ * private copies of the problem data and settings after setup.
+ */
+static OSQPWorkspace* d3x_workspace(jlong handle) {
+  return (OSQPWorkspace*) handle;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_d3x_osqp_OsqpSolver_setup(JNIEnv*      jniEnv,
+                                   jclass       jniClass,
+                                   jlong        numVar,
+                                   jlong        numDual,
+                                   jstring      logName,
+                                   jdoubleArray linObjCoeff,
+                                   jlongArray   quadObjColPtr,
+                                   jlongArray   quadObjRowInd,
+                                   jdoubleArray quadObjCoeff,
+                                   jlongArray   linConColPtr,
+                                   jlongArray   linConRowInd,
+                                   jdoubleArray linConCoeff,
+                                   jdoubleArray linConLower,
+                                   jdoubleArray linConUpper,
+                                   jdoubleArray paramValues) {
+  if (!d3x_check_types())
+    return 0;
+
+  /*
+   * Wrap the problem data and copy the settings.
+   */
+  D3XArrays arrays = {
+    linObjCoeff,
+    quadObjColPtr,
+    quadObjRowInd,
+    quadObjCoeff,
+    linConColPtr,
+    linConRowInd,
+    linConCoeff,
+    linConLower,
+    linConUpper
+  };
+
+  d3x_arena_begin(D3X_ARENA_SETUP_SIZE);
+
+  OSQPData* data =
+    d3x_create_data(jniEnv,
+                    numVar,
+                    numDual,
+                    &arrays);
+
+  OSQPSettings* settings =
+    d3x_create_settings(jniEnv, paramValues);
+
+  OSQPWorkspace* workspace = OSQP_NULL;
+
+  /*
+   * Create the solver workspace, which copies the data and settings,
+   * capturing the setup output in the specified log file.
+   */
+  if (data && settings) {
+    int logOpened = d3x_open_log(jniEnv, logName);
+    workspace = d3x_create_workspace(data, settings);
+    d3x_close_log(logOpened);
+  }
+
+  if (data)
+    d3x_free_data(jniEnv, &arrays, data);
+
+  d3x_arena_end();
+  d3x_stats_flush();
+  return (jlong) workspace;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_d3x_osqp_OsqpSolver_setupDirect(JNIEnv*      jniEnv,
+                                         jclass       jniClass,
+                                         jlong        numVar,
+                                         jlong        numDual,
+                                         jstring      logName,
+                                         jobject      linObjCoeff,
+                                         jobject      quadObjColPtr,
+                                         jobject      quadObjRowInd,
+                                         jobject      quadObjCoeff,
+                                         jobject      linConColPtr,
+                                         jobject      linConRowInd,
+                                         jobject      linConCoeff,
+                                         jobject      linConLower,
+                                         jobject      linConUpper,
+                                         jdoubleArray paramValues) {
+  if (!d3x_check_types())
+    return 0;
+
+  /*
+   * Refer to the problem data in place and copy the settings.
+   */
+  D3XBuffers buffers = {
+    linObjCoeff,
+    quadObjColPtr,
+    quadObjRowInd,
+    quadObjCoeff,
+    linConColPtr,
+    linConRowInd,
+    linConCoeff,
+    linConLower,
+    linConUpper
+  };
+
+  d3x_arena_begin(D3X_ARENA_SETUP_SIZE);
+
+  OSQPData* data =
+    d3x_wrap_data(jniEnv,
+                  numVar,
+                  numDual,
+                  &buffers);
+
+  OSQPSettings* settings =
+    d3x_create_settings(jniEnv, paramValues);
+
+  OSQPWorkspace* workspace = OSQP_NULL;
+
+  if (data && settings) {
+    int logOpened = d3x_open_log(jniEnv, logName);
+    workspace = d3x_create_workspace(data, settings);
+    d3x_close_log(logOpened);
+  }
+
+  d3x_arena_end();
+  d3x_stats_flush();
+  return (jlong) workspace;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_solve(JNIEnv*      jniEnv,
+                                   jclass       jniClass,
+                                   jlong        handle,
+                                   jstring      logName,
+                                   jdoubleArray optPrimal,
+                                   jdoubleArray optDual,
+                                   jdoubleArray solveInfo,
+                                   jobject      cancelFlag,
+                                   jdouble      timeLimit) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  /*
+   * The cancellation flag is written by other Java threads while the
+   * solve runs, so it is read in place from its direct buffer.
+   */
+  const jint* cancel = cancelFlag ? (const jint*) (*jniEnv)->GetDirectBufferAddress(jniEnv, cancelFlag) : NULL;
+
+  /*
+   * Solve problem and assign solution.
+   */
+  FILE* log = d3x_open_solve_log(jniEnv, logName);
+  jlong timer = d3x_stats_start();
+  c_int status = d3x_solve(workspace, cancel, timeLimit, log);
+  timer = d3x_stats_lap(D3X_STAT_SOLVE, timer);
+
+  if (status == 0) {
+    d3x_set_float_region(jniEnv, optPrimal, 0, workspace->data->n, workspace->solution->x);
+    d3x_set_float_region(jniEnv, optDual, 0, workspace->data->m, workspace->solution->y);
+    status = workspace->info->status_val;
+  }
+
+  d3x_close_solve_log(log);
+
+  jdouble infoValues[D3X_INFO_COUNT];
+  d3x_copy_info(workspace->info, infoValues);
+  (*jniEnv)->SetDoubleArrayRegion(jniEnv, solveInfo, 0, D3X_INFO_COUNT, infoValues);
+  d3x_stats_lap(D3X_STAT_SET_REGION, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+/*
+ * Solves a sequence of problems that share the matrices of the workspace
+ * and differ in the linear objective and/or the bounds, which are read
+ * from flat arrays holding one vector per problem (a null array keeps the
+ * current vector).  Each problem is warm started from the solution of the
+ * previous one when the warm start setting is on.  Problems whose update
+ * fails are not solved and keep their NaN solutions.  Each problem is
+ * solved by d3x_solve() with the time limit; once the cancellation flag
+ * is set, the problem in progress stops and the rest are not solved, and
+ * all of them report D3X_CANCELLED.
+ */
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpSolver_sweep(JNIEnv*      jniEnv,
+                                   jclass       jniClass,
+                                   jlong        handle,
+                                   jstring      logName,
+                                   jint         count,
+                                   jdoubleArray linObjCoeff,
+                                   jdoubleArray linConLower,
+                                   jdoubleArray linConUpper,
+                                   jdoubleArray optPrimal,
+                                   jdoubleArray optDual,
+                                   jintArray    solveStatus,
+                                   jobject      cancelFlag,
+                                   jdouble      timeLimit) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace || count < 1)
+    return;
+
+  const jint* cancel = cancelFlag ? (const jint*) (*jniEnv)->GetDirectBufferAddress(jniEnv, cancelFlag) : NULL;
+
+  c_int n = workspace->data->n;
+  c_int m = workspace->data->m;
+
+  d3x_arena_begin((n + 2 * m) * sizeof(c_float) + count * sizeof(jint) + 4 * D3X_ARENA_ALIGN);
+
+  c_float* q = linObjCoeff ? (c_float*) d3x_arena_alloc(n * sizeof(c_float)) : OSQP_NULL;
+  c_float* l = linConLower ? (c_float*) d3x_arena_alloc(m * sizeof(c_float)) : OSQP_NULL;
+  c_float* u = linConUpper ? (c_float*) d3x_arena_alloc(m * sizeof(c_float)) : OSQP_NULL;
+  jint* statuses = (jint*) d3x_arena_alloc(count * sizeof(jint));
+
+  if ((linObjCoeff && !q) || (linConLower && !l) || (linConUpper && !u) || !statuses) {
+    fprintf(stderr, "Failed to allocate the sweep vectors.\n");
+    d3x_arena_end();
+    return;
+  }
+
+  FILE* log = d3x_open_solve_log(jniEnv, logName);
+
+  for (jint k = 0; k < count; ++k) {
+    if (cancel && __atomic_load_n(cancel, __ATOMIC_ACQUIRE)) {
+      statuses[k] = D3X_CANCELLED;
+      continue;
+    }
+
+    jlong timer = d3x_stats_start();
+
+    if (q)
+      d3x_get_float_region(jniEnv, linObjCoeff, k * n, n, q);
+
+    if (l)
+      d3x_get_float_region(jniEnv, linConLower, k * m, m, l);
+
+    if (u)
+      d3x_get_float_region(jniEnv, linConUpper, k * m, m, u);
+
+    timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+    c_int status = 0;
+
+    if (q)
+      status = osqp_update_lin_cost(workspace, q);
+
+    if (status == 0 && l && u)
+      status = osqp_update_bounds(workspace, l, u);
+    else if (status == 0 && l)
+      status = osqp_update_lower_bound(workspace, l);
+    else if (status == 0 && u)
+      status = osqp_update_upper_bound(workspace, u);
+
+    timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+    if (status != 0) {
+      statuses[k] = D3X_SETUP_ERROR;
+      continue;
+    }
+
+    status = d3x_solve(workspace, cancel, timeLimit, log);
+    timer = d3x_stats_lap(D3X_STAT_SOLVE, timer);
+
+    if (status == 0) {
+      d3x_set_float_region(jniEnv, optPrimal, k * n, n, workspace->solution->x);
+      d3x_set_float_region(jniEnv, optDual, k * m, m, workspace->solution->y);
+      statuses[k] = (jint) workspace->info->status_val;
+    }
+    else {
+      statuses[k] = D3X_SETUP_ERROR;
+    }
+
+    d3x_stats_lap(D3X_STAT_SET_REGION, timer);
+  }
+
+  d3x_close_solve_log(log);
+  (*jniEnv)->SetIntArrayRegion(jniEnv, solveStatus, 0, count, statuses);
+
+  d3x_arena_end();
+  d3x_stats_flush();
+}
+
+/*
+ * The update functions only read the Java arrays, so the array elements are
+ * released without copying them back.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateLinCost(JNIEnv*      jniEnv,
+                                           jclass       jniClass,
+                                           jlong        handle,
+                                           jdoubleArray linObjCoeff) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  jlong timer = d3x_stats_start();
+  c_float* q = d3x_get_floats(jniEnv, linObjCoeff);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = osqp_update_lin_cost(workspace, q);
+  timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_release_floats(jniEnv, linObjCoeff, q);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateBounds(JNIEnv*      jniEnv,
+                                          jclass       jniClass,
+                                          jlong        handle,
+                                          jdoubleArray linConLower,
+                                          jdoubleArray linConUpper) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  jlong timer = d3x_stats_start();
+  c_float* l = d3x_get_floats(jniEnv, linConLower);
+  c_float* u = d3x_get_floats(jniEnv, linConUpper);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = osqp_update_bounds(workspace, l, u);
+  timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_release_floats(jniEnv, linConLower, l);
+  d3x_release_floats(jniEnv, linConUpper, u);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateLowerBound(JNIEnv*      jniEnv,
+                                              jclass       jniClass,
+                                              jlong        handle,
+                                              jdoubleArray linConLower) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  jlong timer = d3x_stats_start();
+  c_float* l = d3x_get_floats(jniEnv, linConLower);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = osqp_update_lower_bound(workspace, l);
+  timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_release_floats(jniEnv, linConLower, l);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateUpperBound(JNIEnv*      jniEnv,
+                                              jclass       jniClass,
+                                              jlong        handle,
+                                              jdoubleArray linConUpper) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  jlong timer = d3x_stats_start();
+  c_float* u = d3x_get_floats(jniEnv, linConUpper);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = osqp_update_upper_bound(workspace, u);
+  timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_release_floats(jniEnv, linConUpper, u);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+/*
+ * Only the parameters that are not NaN are updated.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateSettings(JNIEnv*      jniEnv,
+                                            jclass       jniClass,
+                                            jlong        handle,
+                                            jdoubleArray paramValues) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  if ((*jniEnv)->GetArrayLength(jniEnv, paramValues) != D3X_PARAM_COUNT)
+    return D3X_SETUP_ERROR;
+
+  jlong timer = d3x_stats_start();
+  jdouble nativeParams[D3X_PARAM_COUNT];
+  (*jniEnv)->GetDoubleArrayRegion(jniEnv, paramValues, 0, D3X_PARAM_COUNT, nativeParams);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = d3x_update_params(workspace, nativeParams);
+  d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+/*
+ * Null value arrays mean that a matrix is unchanged; null index arrays mean
+ * that every element of a matrix is replaced.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_updateMatrices(JNIEnv*      jniEnv,
+                                            jclass       jniClass,
+                                            jlong        handle,
+                                            jdoubleArray quadObjCoeff,
+                                            jlongArray   quadObjIndex,
+                                            jdoubleArray linConCoeff,
+                                            jlongArray   linConIndex) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  jsize Pn = quadObjCoeff ? (*jniEnv)->GetArrayLength(jniEnv, quadObjCoeff) : 0;
+  jsize An = linConCoeff ? (*jniEnv)->GetArrayLength(jniEnv, linConCoeff) : 0;
+
+  jlong timer = d3x_stats_start();
+  c_float* Px = quadObjCoeff ? d3x_get_floats(jniEnv, quadObjCoeff) : OSQP_NULL;
+  c_float* Ax = linConCoeff ? d3x_get_floats(jniEnv, linConCoeff) : OSQP_NULL;
+  jlong* Pi = quadObjIndex ? (*jniEnv)->GetLongArrayElements(jniEnv, quadObjIndex, 0) : OSQP_NULL;
+  jlong* Ai = linConIndex ? (*jniEnv)->GetLongArrayElements(jniEnv, linConIndex, 0) : OSQP_NULL;
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  c_int status = 0;
+
+  if (Px && Ax)
+    status = osqp_update_P_A(workspace, Px, Pi, Pn, Ax, Ai, An);
+  else if (Px)
+    status = osqp_update_P(workspace, Px, Pi, Pn);
+  else if (Ax)
+    status = osqp_update_A(workspace, Ax, Ai, An);
+
+  timer = d3x_stats_lap(D3X_STAT_UPDATE, timer);
+
+  if (Px)
+    d3x_release_floats(jniEnv, quadObjCoeff, Px);
+
+  if (Ax)
+    d3x_release_floats(jniEnv, linConCoeff, Ax);
+
+  if (Pi)
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv, quadObjIndex, Pi, JNI_ABORT);
+
+  if (Ai)
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv, linConIndex, Ai, JNI_ABORT);
+
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+  d3x_stats_flush();
+  return (jint) status;
+}
+
+/*
+ * A null primal or dual array keeps the current iterate for that vector.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_warmStart(JNIEnv*      jniEnv,
+                                       jclass       jniClass,
+                                       jlong        handle,
+                                       jdoubleArray primal,
+                                       jdoubleArray dual) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  c_float* x = primal ? d3x_get_floats(jniEnv, primal) : OSQP_NULL;
+  c_float* y = dual ? d3x_get_floats(jniEnv, dual) : OSQP_NULL;
+
+  c_int status = 0;
+
+  if (x && y)
+    status = osqp_warm_start(workspace, x, y);
+  else if (x)
+    status = osqp_warm_start_x(workspace, x);
+  else if (y)
+    status = osqp_warm_start_y(workspace, y);
+
+  if (x)
+    d3x_release_floats(jniEnv, primal, x);
+
+  if (y)
+    d3x_release_floats(jniEnv, dual, y);
+
+  return (jint) status;
+}
+
+/*
+ * Evaluates the objective function and (if the result array has room for
+ * them) the primal residual and the signed bound violations of each
+ * constraint row at a primal point, using the matrices stored in the
+ * workspace.  The workspace holds the scaled problem
+ *
+ *   P' = c D P D,  q' = c D q,  A' = E A D,  l' = E l,  u' = E u,
+ *
+ * so the point is scaled by D^{-1} and the results by 1/c and E^{-1}.
+ */
+JNIEXPORT jint JNICALL
+Java_com_d3x_osqp_OsqpSolver_evaluate(JNIEnv*      jniEnv,
+                                      jclass       jniClass,
+                                      jlong        handle,
+                                      jdoubleArray primal,
+                                      jdoubleArray values) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (!workspace)
+    return D3X_SETUP_ERROR;
+
+  OSQPData* data = workspace->data;
+  OSQPScaling* scaling = workspace->scaling;
+  jsize count = (*jniEnv)->GetArrayLength(jniEnv, values);
+
+  if (count != 1 && count != 2 + data->m)
+    return D3X_SETUP_ERROR;
+
+  d3x_arena_begin((data->n + data->m) * sizeof(c_float) + 2 * D3X_ARENA_ALIGN);
+
+  c_float* x = (c_float*) d3x_arena_alloc(data->n * sizeof(c_float));
+  c_float* y = count > 1 ? (c_float*) d3x_arena_alloc(data->m * sizeof(c_float)) : OSQP_NULL;
+
+  if (!x || (count > 1 && !y)) {
+    d3x_arena_end();
+    return D3X_SETUP_ERROR;
+  }
+
+  jlong timer = d3x_stats_start();
+  d3x_get_float_region(jniEnv, primal, 0, data->n, x);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  if (scaling)
+    vec_ew_prod(scaling->Dinv, x, x, data->n);
+
+  jdouble objective = quad_form(data->P, x) + vec_prod(data->q, x, data->n);
+
+  if (scaling)
+    objective *= scaling->cinv;
+
+  (*jniEnv)->SetDoubleArrayRegion(jniEnv, values, 0, 1, &objective);
+
+  if (y) {
+    /* Replace each row value with its violation: positive above the upper
+       bound, negative below the lower bound, and zero in between. */
+    jdouble residual = 0.0;
+    mat_vec(data->A, x, y, 0);
+
+    for (c_int row = 0; row < data->m; ++row) {
+      c_float rowScale = scaling ? scaling->Einv[row] : 1.0;
+      c_float value = rowScale * y[row];
+      c_float lower = rowScale * data->l[row];
+      c_float upper = rowScale * data->u[row];
+
+      if (value > upper)
+        y[row] = value - upper;
+      else if (value < lower)
+        y[row] = value - lower;
+      else
+        y[row] = 0.0;
+
+      residual = c_max(residual, c_absval(y[row]));
+    }
+
+    (*jniEnv)->SetDoubleArrayRegion(jniEnv, values, 1, 1, &residual);
+    d3x_set_float_region(jniEnv, values, 2, data->m, y);
+  }
+
+  d3x_stats_lap(D3X_STAT_SET_REGION, timer);
+  d3x_arena_end();
+  d3x_stats_flush();
+  return 0;
+}
+
+JNIEXPORT void JNICALL
+Java_com_d3x_osqp_OsqpSolver_cleanup(JNIEnv* jniEnv,
+                                     jclass  jniClass,
+                                     jlong   handle) {
+  OSQPWorkspace* workspace = d3x_workspace(handle);
+
+  if (workspace)
+    osqp_cleanup(workspace);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_d3x_osqp_OsqpSolver_isProfiling(JNIEnv* jniEnv,
+                                         jclass  jniClass) {
+#ifdef PROFILING
+  return JNI_TRUE;
+#else
+  return JNI_FALSE;
+#endif
+}
@@ -0,0 +1,125 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class com_d3x_osqp_OsqpSolver */
+
+#ifndef _Included_com_d3x_osqp_OsqpSolver
+#define _Included_com_d3x_osqp_OsqpSolver
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    setup
+ * Signature: (JJLjava/lang/String;[D[J[J[D[J[J[D[D[D[D)J
+ */
+JNIEXPORT jlong JNICALL Java_com_d3x_osqp_OsqpSolver_setup
+  (JNIEnv *, jclass, jlong, jlong, jstring, jdoubleArray, jlongArray, jlongArray, jdoubleArray, jlongArray, jlongArray, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    setupDirect
+ * Signature: (JJLjava/lang/String;Ljava/nio/DoubleBuffer;Ljava/nio/LongBuffer;Ljava/nio/LongBuffer;Ljava/nio/DoubleBuffer;Ljava/nio/LongBuffer;Ljava/nio/LongBuffer;Ljava/nio/DoubleBuffer;Ljava/nio/DoubleBuffer;Ljava/nio/DoubleBuffer;[D)J
+ */
+JNIEXPORT jlong JNICALL Java_com_d3x_osqp_OsqpSolver_setupDirect
+  (JNIEnv *, jclass, jlong, jlong, jstring, jobject, jobject, jobject, jobject, jobject, jobject, jobject, jobject, jobject, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    solve
+ * Signature: (JLjava/lang/String;[D[D[DLjava/nio/ByteBuffer;D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_solve
+  (JNIEnv *, jclass, jlong, jstring, jdoubleArray, jdoubleArray, jdoubleArray, jobject, jdouble);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    sweep
+ * Signature: (JLjava/lang/String;I[D[D[D[D[D[ILjava/nio/ByteBuffer;D)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpSolver_sweep
+  (JNIEnv *, jclass, jlong, jstring, jint, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray, jdoubleArray, jintArray, jobject, jdouble);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateLinCost
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateLinCost
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateBounds
+ * Signature: (J[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateBounds
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateLowerBound
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateLowerBound
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateUpperBound
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateUpperBound
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateSettings
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateSettings
+  (JNIEnv *, jclass, jlong, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    updateMatrices
+ * Signature: (J[D[J[D[J)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_updateMatrices
+  (JNIEnv *, jclass, jlong, jdoubleArray, jlongArray, jdoubleArray, jlongArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    warmStart
+ * Signature: (J[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_warmStart
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    evaluate
+ * Signature: (J[D[D)I
+ */
+JNIEXPORT jint JNICALL Java_com_d3x_osqp_OsqpSolver_evaluate
+  (JNIEnv *, jclass, jlong, jdoubleArray, jdoubleArray);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    cleanup
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_d3x_osqp_OsqpSolver_cleanup
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     com_d3x_osqp_OsqpSolver
+ * Method:    isProfiling
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_d3x_osqp_OsqpSolver_isProfiling
+  (JNIEnv *, jclass);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <math.h>
+#include <pthread.h>
+#include "osqp.h"
+#include "workspace.h"
+#include "d3x_embedded.h"
+
+/*
+ * This file is not part of the adapter library: bin/build.sh compiles it
+ * with the code generated by bin/codegen.py, whose headers (osqp.h with
+ * the EMBEDDED mode in osqp_configure.h, and workspace.h declaring the
+ * static workspace) come first on the include path.
+ */
+
+/*
+ * The generated workspace is a single global, so the calls that use it
+ * are serialized.
+ */
+static pthread_mutex_t d3x_embedded_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+D3X_EMBEDDED_EXPORT void d3x_embedded_dims(long long* dims) {
+  dims[D3X_EMBEDDED_NUM_VAR]  = workspace.data->n;
+  dims[D3X_EMBEDDED_NUM_DUAL] = workspace.data->m;
+  dims[D3X_EMBEDDED_MODE]     = EMBEDDED;
+  dims[D3X_EMBEDDED_QUAD_NNZ] = workspace.data->P->p[workspace.data->n];
+  dims[D3X_EMBEDDED_LIN_NNZ]  = workspace.data->A->p[workspace.data->n];
+}
+
+/*
+ * The workspace holds the scaled matrices P' = c D P D and A' = E A D, so
+ * the values are unscaled with the inverse scaling vectors.
+ */
+D3X_EMBEDDED_EXPORT void d3x_embedded_matrices(long long* quadColPtr,
+                                               long long* quadRowInd,
+                                               double*    quadValues,
+                                               long long* linColPtr,
+                                               long long* linRowInd,
+                                               double*    linValues) {
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  const csc* P = workspace.data->P;
+  const csc* A = workspace.data->A;
+  const OSQPScaling* scaling = workspace.scaling;
+  c_int n = workspace.data->n;
+
+  for (c_int col = 0; col <= n; ++col) {
+    quadColPtr[col] = P->p[col];
+    linColPtr[col]  = A->p[col];
+  }
+
+  for (c_int col = 0; col < n; ++col) {
+    c_float colScale = scaling ? scaling->Dinv[col] : 1.0;
+
+    for (c_int k = P->p[col]; k < P->p[col + 1]; ++k) {
+      c_int row = P->i[k];
+      quadRowInd[k] = row;
+      quadValues[k] = scaling ? P->x[k] * scaling->cinv * scaling->Dinv[row] * colScale : P->x[k];
+    }
+
+    for (c_int k = A->p[col]; k < A->p[col + 1]; ++k) {
+      c_int row = A->i[k];
+      linRowInd[k] = row;
+      linValues[k] = scaling ? A->x[k] * scaling->Einv[row] * colScale : A->x[k];
+    }
+  }
+
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+}
+
+D3X_EMBEDDED_EXPORT int d3x_embedded_solve(const double* linObjCoeff,
+                                           const double* linConLower,
+                                           const double* linConUpper,
+                                           double*       primal,
+                                           double*       dual,
+                                           double*       info) {
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  c_int status = 0;
+
+  if (linObjCoeff)
+    status = osqp_update_lin_cost(&workspace, linObjCoeff);
+
+  if (status == 0 && linConLower && linConUpper)
+    status = osqp_update_bounds(&workspace, linConLower, linConUpper);
+  else if (status == 0 && linConLower)
+    status = osqp_update_lower_bound(&workspace, linConLower);
+  else if (status == 0 && linConUpper)
+    status = osqp_update_upper_bound(&workspace, linConUpper);
+
+  if (status != 0) {
+    pthread_mutex_unlock(&d3x_embedded_mutex);
+    return D3X_EMBEDDED_UPDATE_ERROR;
+  }
+
+  osqp_solve(&workspace);
+
+  c_int n = workspace.data->n;
+  c_int m = workspace.data->m;
+
+  for (c_int k = 0; k < n; ++k)
+    primal[k] = workspace.solution->x[k];
+
+  for (c_int k = 0; k < m; ++k)
+    dual[k] = workspace.solution->y[k];
+
+  const OSQPInfo* solveInfo = workspace.info;
+
+  info[D3X_EMBEDDED_ITER]       = solveInfo->iter;
+  info[D3X_EMBEDDED_STATUS_VAL] = solveInfo->status_val;
+  info[D3X_EMBEDDED_OBJ_VAL]    = solveInfo->obj_val;
+  info[D3X_EMBEDDED_PRI_RES]    = solveInfo->pri_res;
+  info[D3X_EMBEDDED_DUA_RES]    = solveInfo->dua_res;
+
+#if EMBEDDED != 1
+  info[D3X_EMBEDDED_RHO_UPDATES]  = solveInfo->rho_updates;
+  info[D3X_EMBEDDED_RHO_ESTIMATE] = solveInfo->rho_estimate;
+#else
+  info[D3X_EMBEDDED_RHO_UPDATES]  = NAN;
+  info[D3X_EMBEDDED_RHO_ESTIMATE] = NAN;
+#endif
+
+  int result = (int) solveInfo->status_val;
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+  return result;
+}
+
+D3X_EMBEDDED_EXPORT int d3x_embedded_warm_start(const double* primal, const double* dual) {
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  c_int status = 0;
+
+  if (primal && dual)
+    status = osqp_warm_start(&workspace, primal, dual);
+  else if (primal)
+    status = osqp_warm_start_x(&workspace, primal);
+  else if (dual)
+    status = osqp_warm_start_y(&workspace, dual);
+
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+  return (int) status;
+}
+
+D3X_EMBEDDED_EXPORT int d3x_embedded_update_matrices(const double* quadValues, const double* linValues) {
+#if EMBEDDED == 2
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  c_int quadNnz = workspace.data->P->p[workspace.data->n];
+  c_int linNnz = workspace.data->A->p[workspace.data->n];
+  c_int status = 0;
+
+  if (quadValues && linValues)
+    status = osqp_update_P_A(&workspace, quadValues, OSQP_NULL, quadNnz, linValues, OSQP_NULL, linNnz);
+  else if (quadValues)
+    status = osqp_update_P(&workspace, quadValues, OSQP_NULL, quadNnz);
+  else if (linValues)
+    status = osqp_update_A(&workspace, linValues, OSQP_NULL, linNnz);
+
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+  return status == 0 ? 0 : D3X_EMBEDDED_UPDATE_ERROR;
+#else
+  return (quadValues || linValues) ? D3X_EMBEDDED_UPDATE_ERROR : 0;
+#endif
+}
+
+D3X_EMBEDDED_EXPORT void d3x_embedded_settings(double* values) {
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  const OSQPSettings* settings = workspace.settings;
+
+  values[D3X_EMBEDDED_SET_RHO]     = settings->rho;
+  values[D3X_EMBEDDED_SET_SIGMA]   = settings->sigma;
+  values[D3X_EMBEDDED_SET_SCALING] = settings->scaling;
+
+#if EMBEDDED != 1
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO]           = settings->adaptive_rho;
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO_INTERVAL]  = settings->adaptive_rho_interval;
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO_TOLERANCE] = settings->adaptive_rho_tolerance;
+#else
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO]           = 0.0;
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO_INTERVAL]  = NAN;
+  values[D3X_EMBEDDED_SET_ADAPTIVE_RHO_TOLERANCE] = NAN;
+#endif
+
+  values[D3X_EMBEDDED_SET_MAX_ITER]           = settings->max_iter;
+  values[D3X_EMBEDDED_SET_EPS_ABS]            = settings->eps_abs;
+  values[D3X_EMBEDDED_SET_EPS_REL]            = settings->eps_rel;
+  values[D3X_EMBEDDED_SET_EPS_PRIM_INF]       = settings->eps_prim_inf;
+  values[D3X_EMBEDDED_SET_EPS_DUAL_INF]       = settings->eps_dual_inf;
+  values[D3X_EMBEDDED_SET_ALPHA]              = settings->alpha;
+  values[D3X_EMBEDDED_SET_SCALED_TERMINATION] = settings->scaled_termination;
+  values[D3X_EMBEDDED_SET_CHECK_TERMINATION]  = settings->check_termination;
+  values[D3X_EMBEDDED_SET_WARM_START]         = settings->warm_start;
+
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+}
+
+static c_int d3x_embedded_update_setting(int index, double value) {
+  switch (index) {
+  case D3X_EMBEDDED_SET_MAX_ITER:
+    return osqp_update_max_iter(&workspace, (c_int) value);
+
+  case D3X_EMBEDDED_SET_EPS_ABS:
+    return osqp_update_eps_abs(&workspace, value);
+
+  case D3X_EMBEDDED_SET_EPS_REL:
+    return osqp_update_eps_rel(&workspace, value);
+
+  case D3X_EMBEDDED_SET_EPS_PRIM_INF:
+    return osqp_update_eps_prim_inf(&workspace, value);
+
+  case D3X_EMBEDDED_SET_EPS_DUAL_INF:
+    return osqp_update_eps_dual_inf(&workspace, value);
+
+  case D3X_EMBEDDED_SET_ALPHA:
+    return osqp_update_alpha(&workspace, value);
+
+  case D3X_EMBEDDED_SET_SCALED_TERMINATION:
+    return osqp_update_scaled_termination(&workspace, (c_int) value);
+
+  case D3X_EMBEDDED_SET_CHECK_TERMINATION:
+    return osqp_update_check_termination(&workspace, (c_int) value);
+
+  case D3X_EMBEDDED_SET_WARM_START:
+    return osqp_update_warm_start(&workspace, (c_int) value);
+
+#if EMBEDDED != 1
+  case D3X_EMBEDDED_SET_RHO:
+    return osqp_update_rho(&workspace, value);
+#endif
+
+  default:
+    return D3X_EMBEDDED_UPDATE_ERROR;
+  }
+}
+
+D3X_EMBEDDED_EXPORT int d3x_embedded_update_settings(const double* values) {
+  for (int index = 0; index < D3X_EMBEDDED_SETTING_COUNT; ++index) {
+    if (isnan(values[index]))
+      continue;
+
+    if (index < D3X_EMBEDDED_SET_MAX_ITER && (EMBEDDED == 1 || index != D3X_EMBEDDED_SET_RHO))
+      return D3X_EMBEDDED_UPDATE_ERROR;
+  }
+
+  pthread_mutex_lock(&d3x_embedded_mutex);
+
+  c_int status = 0;
+
+  for (int index = 0; index < D3X_EMBEDDED_SETTING_COUNT && status == 0; ++index)
+    if (!isnan(values[index]))
+      status = d3x_embedded_update_setting(index, values[index]);
+
+  pthread_mutex_unlock(&d3x_embedded_mutex);
+  return status == 0 ? 0 : D3X_EMBEDDED_UPDATE_ERROR;
+}
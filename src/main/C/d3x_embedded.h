@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef D3X_EMBEDDED_H
+#define D3X_EMBEDDED_H
+
+/*
+ * The entry points of a specialized solver library, which bin/build.sh
+ * compiles from the code generated by bin/codegen.py and d3x_embedded.c.
+ * The generated code defines the OSQP functions under the same names as
+ * the OSQP library linked into the adapter, so the adapter loads each
+ * specialized library privately (RTLD_LOCAL), the library binds its own
+ * calls internally (-Bsymbolic), and only these functions are exported.
+ *
+ * This header uses plain C types only, so that it may be included on
+ * both sides of the boundary.
+ */
+#if defined(__GNUC__)
+#define D3X_EMBEDDED_EXPORT __attribute__((visibility("default")))
+#else
+#define D3X_EMBEDDED_EXPORT
+#endif
+
+/*
+ * The status code returned when a vector or matrix update is rejected.
+ */
+#define D3X_EMBEDDED_UPDATE_ERROR (-1)
+
+/*
+ * The layout of the dimensions reported by d3x_embedded_dims, which must
+ * match com.d3x.osqp.OsqpEmbedded.
+ */
+enum {
+  D3X_EMBEDDED_NUM_VAR,
+  D3X_EMBEDDED_NUM_DUAL,
+  D3X_EMBEDDED_MODE,
+  D3X_EMBEDDED_QUAD_NNZ,
+  D3X_EMBEDDED_LIN_NNZ,
+  D3X_EMBEDDED_DIM_COUNT
+};
+
+/*
+ * The statistics reported by d3x_embedded_solve; the embedded solver
+ * keeps no timings and does not polish.
+ */
+enum {
+  D3X_EMBEDDED_ITER,
+  D3X_EMBEDDED_STATUS_VAL,
+  D3X_EMBEDDED_OBJ_VAL,
+  D3X_EMBEDDED_PRI_RES,
+  D3X_EMBEDDED_DUA_RES,
+  D3X_EMBEDDED_RHO_UPDATES,
+  D3X_EMBEDDED_RHO_ESTIMATE,
+  D3X_EMBEDDED_INFO_COUNT
+};
+
+/*
+ * The layout of the generated settings read by d3x_embedded_settings and
+ * assigned by d3x_embedded_update_settings, which must match
+ * com.d3x.osqp.OsqpEmbedded.  The generated code can change only the
+ * settings from MAX_ITER on, and RHO unless EMBEDDED=1.
+ */
+enum {
+  D3X_EMBEDDED_SET_RHO,
+  D3X_EMBEDDED_SET_SIGMA,
+  D3X_EMBEDDED_SET_SCALING,
+  D3X_EMBEDDED_SET_ADAPTIVE_RHO,
+  D3X_EMBEDDED_SET_ADAPTIVE_RHO_INTERVAL,
+  D3X_EMBEDDED_SET_ADAPTIVE_RHO_TOLERANCE,
+  D3X_EMBEDDED_SET_MAX_ITER,
+  D3X_EMBEDDED_SET_EPS_ABS,
+  D3X_EMBEDDED_SET_EPS_REL,
+  D3X_EMBEDDED_SET_EPS_PRIM_INF,
+  D3X_EMBEDDED_SET_EPS_DUAL_INF,
+  D3X_EMBEDDED_SET_ALPHA,
+  D3X_EMBEDDED_SET_SCALED_TERMINATION,
+  D3X_EMBEDDED_SET_CHECK_TERMINATION,
+  D3X_EMBEDDED_SET_WARM_START,
+  D3X_EMBEDDED_SETTING_COUNT
+};
+
+/*
+ * Copies the dimensions of the generated problem and the EMBEDDED mode
+ * (1 for vector updates, 2 for vector and matrix updates).
+ */
+D3X_EMBEDDED_EXPORT void d3x_embedded_dims(long long* dims);
+
+/*
+ * Copies the sparsity pattern and the current (unscaled) values of the
+ * quadratic objective (upper triangle) and constraint matrices.
+ */
+D3X_EMBEDDED_EXPORT void d3x_embedded_matrices(long long* quadColPtr,
+                                               long long* quadRowInd,
+                                               double*    quadValues,
+                                               long long* linColPtr,
+                                               long long* linRowInd,
+                                               double*    linValues);
+
+/*
+ * Updates the vectors that are not null, solves the problem starting from
+ * the previous solution (or the warm start), and copies the solution and
+ * D3X_EMBEDDED_INFO_COUNT statistics.  Returns the OSQP status value, or
+ * D3X_EMBEDDED_UPDATE_ERROR if an update is rejected.
+ */
+D3X_EMBEDDED_EXPORT int d3x_embedded_solve(const double* linObjCoeff,
+                                           const double* linConLower,
+                                           const double* linConUpper,
+                                           double*       primal,
+                                           double*       dual,
+                                           double*       info);
+
+/*
+ * Assigns the starting point for the next solve; either vector may be
+ * null.  Returns zero on success.
+ */
+D3X_EMBEDDED_EXPORT int d3x_embedded_warm_start(const double* primal, const double* dual);
+
+/*
+ * Replaces the values (in the generated sparsity pattern) of the quadratic
+ * objective and constraint matrices; either may be null.  Returns zero on
+ * success, or D3X_EMBEDDED_UPDATE_ERROR unless the library was generated
+ * with EMBEDDED=2.
+ */
+D3X_EMBEDDED_EXPORT int d3x_embedded_update_matrices(const double* quadValues, const double* linValues);
+
+/*
+ * Copies the D3X_EMBEDDED_SETTING_COUNT current settings; with EMBEDDED=1
+ * the step size is never adapted, and the adaptation settings are NaN.
+ */
+D3X_EMBEDDED_EXPORT void d3x_embedded_settings(double* values);
+
+/*
+ * Assigns the settings that are not NaN.  Returns zero on success, or
+ * D3X_EMBEDDED_UPDATE_ERROR if a value is rejected, or (with no setting
+ * changed) if a setting that the generated code cannot change is given.
+ */
+D3X_EMBEDDED_EXPORT int d3x_embedded_update_settings(const double* values);
+
+/*
+ * The entry points of a loaded library, resolved by the adapter.
+ */
+typedef struct {
+  void* library;
+  void (*dims)(long long*);
+  void (*matrices)(long long*, long long*, double*, long long*, long long*, double*);
+  int  (*solve)(const double*, const double*, const double*, double*, double*, double*);
+  int  (*warmStart)(const double*, const double*);
+  int  (*updateMatrices)(const double*, const double*);
+  void (*settings)(double*);
+  int  (*updateSettings)(const double*);
+} D3XEmbedded;
+
+#endif /* D3X_EMBEDDED_H */
@@ -0,0 +1,1124 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "osqp.h"
+#include "osqp_log.h"
+#include "d3x_osqp.h"
+
+/*
+ * The instrumentation counters: totals shared by all threads, and laps
+ * accumulated by the current thread since its last flush.
+ */
+static atomic_int   d3x_stats_enabled = 0;
+static atomic_llong d3x_stats_totals[2 * D3X_STAT_COUNT];
+
+static __thread jlong d3x_stats_local[2 * D3X_STAT_COUNT];
+static __thread int   d3x_stats_pending = 0;
+
+/*
+ * The arena of each thread, the number of outer scopes opened by the
+ * thread since its last flush, and the largest scope reported by it in
+ * the current statistics generation.
+ */
+typedef struct D3XArenaBlock {
+  struct D3XArenaBlock* next;
+  size_t capacity;
+  size_t used;
+} D3XArenaBlock;
+
+typedef struct {
+  D3XArenaBlock* head;
+  size_t         capacity;
+  size_t         used;
+  int            depth;
+} D3XArena;
+
+/*
+ * The smallest block taken from malloc.
+ */
+#define D3X_ARENA_MIN_BLOCK 4096
+
+static atomic_llong d3x_arena_totals[D3X_ARENA_COUNT];
+static atomic_int   d3x_arena_generation = 0;
+
+static __thread D3XArena d3x_arena = { OSQP_NULL, 0, 0, 0 };
+static __thread jlong    d3x_arena_scopes = 0;
+static __thread jlong    d3x_arena_peak = 0;
+static __thread int      d3x_arena_peak_generation = 0;
+
+static pthread_key_t  d3x_arena_key;
+static pthread_once_t d3x_arena_once = PTHREAD_ONCE_INIT;
+
+static jlong d3x_stats_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return 1000000000LL * now.tv_sec + now.tv_nsec;
+}
+
+jlong d3x_stats_start(void) {
+  if (!atomic_load_explicit(&d3x_stats_enabled, memory_order_relaxed))
+    return 0;
+
+  return d3x_stats_now();
+}
+
+jlong d3x_stats_lap(int stat, jlong start) {
+  if (!start)
+    return 0;
+
+  jlong now = d3x_stats_now();
+
+  d3x_stats_local[2 * stat] += 1;
+  d3x_stats_local[2 * stat + 1] += now - start;
+  d3x_stats_pending = 1;
+
+  return now;
+}
+
+void d3x_stats_flush(void) {
+  if (!d3x_stats_pending)
+    return;
+
+  for (int index = 0; index < 2 * D3X_STAT_COUNT; ++index) {
+    atomic_fetch_add_explicit(d3x_stats_totals + index, d3x_stats_local[index], memory_order_relaxed);
+    d3x_stats_local[index] = 0;
+  }
+
+  atomic_fetch_add_explicit(d3x_arena_totals + D3X_ARENA_SCOPES, d3x_arena_scopes, memory_order_relaxed);
+  d3x_arena_scopes = 0;
+  d3x_stats_pending = 0;
+}
+
+void d3x_stats_enable(int enabled) {
+  atomic_store(&d3x_stats_enabled, enabled);
+}
+
+void d3x_stats_reset(void) {
+  for (int index = 0; index < 2 * D3X_STAT_COUNT; ++index)
+    atomic_store(d3x_stats_totals + index, 0);
+
+  for (int index = 0; index < D3X_ARENA_COUNT; ++index)
+    atomic_store(d3x_arena_totals + index, 0);
+
+  atomic_fetch_add(&d3x_arena_generation, 1);
+}
+
+void d3x_stats_read(jlong* values) {
+  for (int index = 0; index < 2 * D3X_STAT_COUNT; ++index)
+    values[index] = atomic_load(d3x_stats_totals + index);
+}
+
+static size_t d3x_arena_round(size_t size) {
+  return (size + D3X_ARENA_ALIGN - 1) & ~((size_t) D3X_ARENA_ALIGN - 1);
+}
+
+static void d3x_arena_free_blocks(void* head) {
+  D3XArenaBlock* block = (D3XArenaBlock*) head;
+
+  while (block) {
+    D3XArenaBlock* next = block->next;
+    c_free(block);
+    block = next;
+  }
+}
+
+static void d3x_arena_create_key(void) {
+  pthread_key_create(&d3x_arena_key, d3x_arena_free_blocks);
+}
+
+/*
+ * The blocks are registered with a thread-specific key, whose destructor
+ * frees them when the thread exits.
+ */
+static void d3x_arena_register(void) {
+  pthread_once(&d3x_arena_once, d3x_arena_create_key);
+  pthread_setspecific(d3x_arena_key, d3x_arena.head);
+}
+
+static D3XArenaBlock* d3x_arena_push(size_t capacity) {
+  D3XArenaBlock* block = (D3XArenaBlock*) c_malloc(d3x_arena_round(sizeof(D3XArenaBlock)) + capacity);
+
+  if (!block)
+    return OSQP_NULL;
+
+  block->next = d3x_arena.head;
+  block->capacity = capacity;
+  block->used = 0;
+
+  d3x_arena.head = block;
+  d3x_arena.capacity += capacity;
+  d3x_arena_register();
+
+  atomic_fetch_add_explicit(d3x_arena_totals + D3X_ARENA_GROWTHS, 1, memory_order_relaxed);
+  return block;
+}
+
+void d3x_arena_begin(size_t reserve) {
+  if (d3x_arena.depth++ > 0)
+    return;
+
+  if (atomic_load_explicit(&d3x_stats_enabled, memory_order_relaxed)) {
+    ++d3x_arena_scopes;
+    d3x_stats_pending = 1;
+  }
+
+  reserve = d3x_arena_round(reserve);
+  D3XArenaBlock* head = d3x_arena.head;
+
+  if (head && !head->next && head->capacity >= reserve)
+    return;
+
+  /* Replace the blocks with one that holds everything needed so far. */
+  size_t capacity = d3x_arena.capacity > reserve ? d3x_arena.capacity : reserve;
+
+  if (capacity < D3X_ARENA_MIN_BLOCK)
+    capacity = D3X_ARENA_MIN_BLOCK;
+
+  d3x_arena_free_blocks(head);
+  d3x_arena.head = OSQP_NULL;
+  d3x_arena.capacity = 0;
+
+  if (!d3x_arena_push(capacity))
+    d3x_arena_register();
+}
+
+void* d3x_arena_alloc(size_t size) {
+  size = d3x_arena_round(size > 0 ? size : 1);
+  D3XArenaBlock* block = d3x_arena.head;
+
+  if (!block || block->capacity - block->used < size) {
+    size_t capacity = block ? 2 * block->capacity : D3X_ARENA_MIN_BLOCK;
+    block = d3x_arena_push(capacity > size ? capacity : size);
+
+    if (!block)
+      return OSQP_NULL;
+  }
+
+  void* memory = (char*) block + d3x_arena_round(sizeof(D3XArenaBlock)) + block->used;
+  block->used += size;
+  d3x_arena.used += size;
+  return memory;
+}
+
+static void d3x_arena_report_peak(jlong peak) {
+  int generation = atomic_load_explicit(&d3x_arena_generation, memory_order_relaxed);
+
+  if (generation != d3x_arena_peak_generation) {
+    d3x_arena_peak_generation = generation;
+    d3x_arena_peak = 0;
+  }
+
+  if (peak <= d3x_arena_peak)
+    return;
+
+  d3x_arena_peak = peak;
+  long long current = atomic_load_explicit(d3x_arena_totals + D3X_ARENA_PEAK_BYTES, memory_order_relaxed);
+
+  while (current < peak &&
+         !atomic_compare_exchange_weak_explicit(d3x_arena_totals + D3X_ARENA_PEAK_BYTES,
+                                                &current,
+                                                peak,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+void d3x_arena_end(void) {
+  if (--d3x_arena.depth > 0)
+    return;
+
+  d3x_arena_report_peak((jlong) d3x_arena.used);
+
+  for (D3XArenaBlock* block = d3x_arena.head; block; block = block->next)
+    block->used = 0;
+
+  d3x_arena.used = 0;
+}
+
+void d3x_arena_read(jlong* values) {
+  for (int index = 0; index < D3X_ARENA_COUNT; ++index)
+    values[index] = atomic_load(d3x_arena_totals + index);
+}
+
+int d3x_check_types(void) {
+  if (sizeof(c_int) != sizeof(long)) {
+    fprintf(stderr, "OSQP must be compiled with DLONG defined.\n");
+    return 0;
+  }
+
+#ifdef DFLOAT
+  if (sizeof(c_float) != sizeof(float)) {
+    fprintf(stderr, "OSQP must be compiled with DFLOAT defined.\n");
+    return 0;
+  }
+#else
+  if (sizeof(c_float) != sizeof(double)) {
+    fprintf(stderr, "OSQP must be compiled with DFLOAT undefined.\n");
+    return 0;
+  }
+#endif
+
+  return 1;
+}
+
+int d3x_check_params(JNIEnv* jniEnv, jdoubleArray params, jint count, jint paramCount) {
+  if (paramCount != D3X_PARAM_COUNT) {
+    fprintf(stderr, "OsqpParam defines %d parameters but the native library expects %d.\n", (int) paramCount, (int) D3X_PARAM_COUNT);
+    return 0;
+  }
+
+  if ((*jniEnv)->GetArrayLength(jniEnv, params) != (jsize) count * paramCount) {
+    fprintf(stderr, "Invalid parameter array length.\n");
+    return 0;
+  }
+
+  return 1;
+}
+
+#ifdef DFLOAT
+c_float* d3x_get_floats(JNIEnv* jniEnv, jdoubleArray array) {
+  jsize length = (*jniEnv)->GetArrayLength(jniEnv, array);
+  d3x_arena_begin(length * sizeof(c_float) + D3X_ARENA_ALIGN);
+
+  c_float* values = (c_float*) d3x_arena_alloc(length * sizeof(c_float));
+
+  if (values)
+    d3x_get_float_region(jniEnv, array, 0, length, values);
+  else
+    d3x_arena_end();
+
+  return values;
+}
+
+void d3x_release_floats(JNIEnv* jniEnv, jdoubleArray array, c_float* values) {
+  if (values)
+    d3x_arena_end();
+}
+
+/*
+ * The conversions run in a critical region, which is brief and makes no
+ * other JNI calls, so the JVM need not copy the array elements first.
+ */
+void d3x_get_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, c_float* values) {
+  jdouble* elements = (jdouble*) (*jniEnv)->GetPrimitiveArrayCritical(jniEnv, array, 0);
+
+  if (!elements)
+    return;
+
+  for (jsize index = 0; index < length; ++index)
+    values[index] = (c_float) elements[start + index];
+
+  (*jniEnv)->ReleasePrimitiveArrayCritical(jniEnv, array, elements, JNI_ABORT);
+}
+
+void d3x_set_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, const c_float* values) {
+  jdouble* elements = (jdouble*) (*jniEnv)->GetPrimitiveArrayCritical(jniEnv, array, 0);
+
+  if (!elements)
+    return;
+
+  for (jsize index = 0; index < length; ++index)
+    elements[start + index] = values[index];
+
+  (*jniEnv)->ReleasePrimitiveArrayCritical(jniEnv, array, elements, 0);
+}
+#else
+c_float* d3x_get_floats(JNIEnv* jniEnv, jdoubleArray array) {
+  return (*jniEnv)->GetDoubleArrayElements(jniEnv, array, 0);
+}
+
+void d3x_release_floats(JNIEnv* jniEnv, jdoubleArray array, c_float* values) {
+  (*jniEnv)->ReleaseDoubleArrayElements(jniEnv, array, values, JNI_ABORT);
+}
+
+void d3x_get_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, c_float* values) {
+  (*jniEnv)->GetDoubleArrayRegion(jniEnv, array, start, length, values);
+}
+
+void d3x_set_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, const c_float* values) {
+  (*jniEnv)->SetDoubleArrayRegion(jniEnv, array, start, length, values);
+}
+#endif
+
+/*
+ * Allocates a sparse matrix structure in the arena, referring to the
+ * given arrays.
+ */
+static csc* d3x_arena_csc(c_int nrow, c_int ncol, c_int nnz, c_float* x, c_int* i, c_int* p) {
+  csc* matrix = (csc*) d3x_arena_alloc(sizeof(csc));
+
+  if (!matrix)
+    return OSQP_NULL;
+
+  matrix->m     = nrow;
+  matrix->n     = ncol;
+  matrix->nzmax = nnz;
+  matrix->nz    = -1;
+  matrix->x     = x;
+  matrix->i     = i;
+  matrix->p     = p;
+  return matrix;
+}
+
+/*
+ * Wraps Java arrays holding a matrix in compressed sparse column format,
+ * without copying or converting the elements (except for the values in
+ * the single-precision build).
+ */
+static csc* d3x_create_csc(JNIEnv*      jniEnv,
+                           jlong        nrow,
+                           jlong        ncol,
+                           jlongArray   colptr,
+                           jlongArray   rowind,
+                           jdoubleArray values) {
+  jlong timer = d3x_stats_start();
+
+  jsize nnz   = (*jniEnv)->GetArrayLength(jniEnv, values);
+  jlong* Cp   = (*jniEnv)->GetLongArrayElements(jniEnv, colptr, 0);
+  jlong* Ci   = (*jniEnv)->GetLongArrayElements(jniEnv, rowind, 0);
+  c_float* Cx = d3x_get_floats(jniEnv, values);
+  timer = d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  csc* matrix = d3x_arena_csc(nrow, ncol, nnz, Cx, Ci, Cp);
+  d3x_stats_lap(D3X_STAT_CREATE_CSC, timer);
+
+  if (!matrix) {
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv, colptr, Cp, JNI_ABORT);
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv, rowind, Ci, JNI_ABORT);
+    d3x_release_floats(jniEnv, values, Cx);
+  }
+
+  return matrix;
+}
+
+/*
+ * The solver only reads the problem data, so the array elements are
+ * released with JNI_ABORT to avoid copying them back.
+ */
+static void d3x_free_csc(JNIEnv*      jniEnv,
+                         jlongArray   colptr,
+                         jlongArray   rowind,
+                         jdoubleArray values,
+                         csc*         matrix) {
+  if (!matrix)
+    return;
+
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, colptr, matrix->p, JNI_ABORT);
+  (*jniEnv)->ReleaseLongArrayElements(jniEnv, rowind, matrix->i, JNI_ABORT);
+  d3x_release_floats(jniEnv, values, matrix->x);
+}
+
+OSQPData* d3x_create_data(JNIEnv*          jniEnv,
+                          jlong            numVar,
+                          jlong            numDual,
+                          const D3XArrays* arrays) {
+  /* Allocate data structure. */
+  OSQPData* data = (OSQPData *) d3x_arena_alloc(sizeof(OSQPData));
+
+  if (!data) {
+    fprintf(stderr, "Failed to allocate OSQPData structure.\n");
+    return OSQP_NULL;
+  }
+
+  /* Populate problem data. */
+  jlong timer = d3x_stats_start();
+  data->n = numVar;
+  data->m = numDual;
+  data->q = d3x_get_floats(jniEnv, arrays->linObjCoeff);
+  data->l = d3x_get_floats(jniEnv, arrays->linConLower);
+  data->u = d3x_get_floats(jniEnv, arrays->linConUpper);
+  d3x_stats_lap(D3X_STAT_GET_ARRAYS, timer);
+
+  data->A = d3x_create_csc(jniEnv,
+                           numDual,
+                           numVar,
+                           arrays->linConColPtr,
+                           arrays->linConRowInd,
+                           arrays->linConCoeff);
+
+  data->P = d3x_create_csc(jniEnv,
+                           numVar,
+                           numVar,
+                           arrays->quadObjColPtr,
+                           arrays->quadObjRowInd,
+                           arrays->quadObjCoeff);
+
+  return data;
+}
+
+void d3x_free_data(JNIEnv*          jniEnv,
+                   const D3XArrays* arrays,
+                   OSQPData*        data) {
+  /* "Release" in exact correspondence to "Get" */
+  jlong timer = d3x_stats_start();
+  d3x_release_floats(jniEnv, arrays->linObjCoeff, data->q);
+  d3x_release_floats(jniEnv, arrays->linConLower, data->l);
+  d3x_release_floats(jniEnv, arrays->linConUpper, data->u);
+
+  d3x_free_csc(jniEnv, arrays->linConColPtr, arrays->linConRowInd, arrays->linConCoeff, data->A);
+  d3x_free_csc(jniEnv, arrays->quadObjColPtr, arrays->quadObjRowInd, arrays->quadObjCoeff, data->P);
+  d3x_stats_lap(D3X_STAT_RELEASE, timer);
+}
+
+/*
+ * Refers to a real vector held in a direct buffer in place, or (in the
+ * single-precision build) to a converted copy in the arena.
+ */
+static c_float* d3x_wrap_floats(JNIEnv* jniEnv, jobject buffer) {
+  jdouble* values = (jdouble*) (*jniEnv)->GetDirectBufferAddress(jniEnv, buffer);
+
+#ifdef DFLOAT
+  jlong length = (*jniEnv)->GetDirectBufferCapacity(jniEnv, buffer);
+
+  if (!values || length < 0)
+    return OSQP_NULL;
+
+  c_float* copy = (c_float*) d3x_arena_alloc(length * sizeof(c_float));
+
+  if (copy)
+    for (jlong index = 0; index < length; ++index)
+      copy[index] = (c_float) values[index];
+
+  return copy;
+#else
+  return values;
+#endif
+}
+
+static csc* d3x_wrap_csc(JNIEnv* jniEnv,
+                         jlong   nrow,
+                         jlong   ncol,
+                         jobject colptr,
+                         jobject rowind,
+                         jobject values) {
+  jlong nnz   = (*jniEnv)->GetDirectBufferCapacity(jniEnv, values);
+  c_int* Cp   = (c_int*) (*jniEnv)->GetDirectBufferAddress(jniEnv, colptr);
+  c_int* Ci   = (c_int*) (*jniEnv)->GetDirectBufferAddress(jniEnv, rowind);
+  c_float* Cx = d3x_wrap_floats(jniEnv, values);
+
+  if (!Cp || !Ci || !Cx || nnz < 0) {
+    fprintf(stderr, "Matrix data must be held in direct buffers.\n");
+    return OSQP_NULL;
+  }
+
+  return d3x_arena_csc(nrow, ncol, nnz, Cx, Ci, Cp);
+}
+
+OSQPData* d3x_wrap_data(JNIEnv*           jniEnv,
+                        jlong             numVar,
+                        jlong             numDual,
+                        const D3XBuffers* buffers) {
+  /* Allocate data structure. */
+  OSQPData* data = (OSQPData *) d3x_arena_alloc(sizeof(OSQPData));
+
+  if (!data) {
+    fprintf(stderr, "Failed to allocate OSQPData structure.\n");
+    return OSQP_NULL;
+  }
+
+  /* Refer to the buffer contents in place. */
+  data->n = numVar;
+  data->m = numDual;
+  data->q = d3x_wrap_floats(jniEnv, buffers->linObjCoeff);
+  data->l = d3x_wrap_floats(jniEnv, buffers->linConLower);
+  data->u = d3x_wrap_floats(jniEnv, buffers->linConUpper);
+
+  data->A = d3x_wrap_csc(jniEnv,
+                         numDual,
+                         numVar,
+                         buffers->linConColPtr,
+                         buffers->linConRowInd,
+                         buffers->linConCoeff);
+
+  data->P = d3x_wrap_csc(jniEnv,
+                         numVar,
+                         numVar,
+                         buffers->quadObjColPtr,
+                         buffers->quadObjRowInd,
+                         buffers->quadObjCoeff);
+
+  if (!data->q || !data->l || !data->u || !data->A || !data->P) {
+    fprintf(stderr, "Problem data must be held in direct buffers.\n");
+    return OSQP_NULL;
+  }
+
+  return data;
+}
+
+static int d3x_to_int(jdouble value) {
+  return (int) round(value);
+}
+
+void d3x_default_settings(OSQPSettings* settings) {
+  osqp_set_default_settings(settings);
+  settings->polish = 1;
+}
+
+static void d3x_assign_param(int paramIndex, jdouble paramValue, OSQPSettings* settings) {
+  switch (paramIndex) {
+  case D3X_PARAM_RHO:
+    settings->rho = paramValue;
+    break;
+
+  case D3X_PARAM_SIGMA:
+    settings->sigma = paramValue;
+    break;
+
+  case D3X_PARAM_ALPHA:
+    settings->alpha = paramValue;
+    break;
+
+  case D3X_PARAM_POLISH:
+    settings->polish = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_MAX_ITER:
+    settings->max_iter = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_EPS_ABS:
+    settings->eps_abs = paramValue;
+    break;
+
+  case D3X_PARAM_EPS_REL:
+    settings->eps_rel = paramValue;
+    break;
+
+  case D3X_PARAM_EPS_PRIM_INF:
+    settings->eps_prim_inf = paramValue;
+    break;
+
+  case D3X_PARAM_EPS_DUAL_INF:
+    settings->eps_dual_inf = paramValue;
+    break;
+
+  case D3X_PARAM_SCALING:
+    settings->scaling = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_ADAPTIVE_RHO:
+    settings->adaptive_rho = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_ADAPTIVE_RHO_INTERVAL:
+    settings->adaptive_rho_interval = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_ADAPTIVE_RHO_TOLERANCE:
+    settings->adaptive_rho_tolerance = paramValue;
+    break;
+
+  case D3X_PARAM_ADAPTIVE_RHO_FRACTION:
+#ifdef PROFILING
+    settings->adaptive_rho_fraction = paramValue;
+#endif
+    break;
+
+  case D3X_PARAM_DELTA:
+    settings->delta = paramValue;
+    break;
+
+  case D3X_PARAM_POLISH_REFINE_ITER:
+    settings->polish_refine_iter = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_VERBOSE:
+    settings->verbose = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_SCALED_TERMINATION:
+    settings->scaled_termination = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_CHECK_TERMINATION:
+    settings->check_termination = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_WARM_START:
+    settings->warm_start = d3x_to_int(paramValue);
+    break;
+
+  case D3X_PARAM_TIME_LIMIT:
+#ifdef PROFILING
+    settings->time_limit = paramValue;
+#endif
+    break;
+
+  case D3X_PARAM_LINSYS_SOLVER:
+    settings->linsys_solver = (enum linsys_solver_type) d3x_to_int(paramValue);
+    break;
+  }
+}
+
+void d3x_assign_params(const jdouble* paramValues, OSQPSettings* settings) {
+  for (int paramIndex = 0; paramIndex < D3X_PARAM_COUNT; ++paramIndex)
+    if (!isnan(paramValues[paramIndex]))
+      d3x_assign_param(paramIndex, paramValues[paramIndex], settings);
+}
+
+static c_int d3x_update_param(OSQPWorkspace* workspace, int paramIndex, jdouble paramValue) {
+  switch (paramIndex) {
+  case D3X_PARAM_RHO:
+    return osqp_update_rho(workspace, paramValue);
+
+  case D3X_PARAM_ALPHA:
+    return osqp_update_alpha(workspace, paramValue);
+
+  case D3X_PARAM_POLISH:
+    return osqp_update_polish(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_MAX_ITER:
+    return osqp_update_max_iter(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_EPS_ABS:
+    return osqp_update_eps_abs(workspace, paramValue);
+
+  case D3X_PARAM_EPS_REL:
+    return osqp_update_eps_rel(workspace, paramValue);
+
+  case D3X_PARAM_EPS_PRIM_INF:
+    return osqp_update_eps_prim_inf(workspace, paramValue);
+
+  case D3X_PARAM_EPS_DUAL_INF:
+    return osqp_update_eps_dual_inf(workspace, paramValue);
+
+  case D3X_PARAM_DELTA:
+    return osqp_update_delta(workspace, paramValue);
+
+  case D3X_PARAM_POLISH_REFINE_ITER:
+    return osqp_update_polish_refine_iter(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_VERBOSE:
+    return osqp_update_verbose(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_SCALED_TERMINATION:
+    return osqp_update_scaled_termination(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_CHECK_TERMINATION:
+    return osqp_update_check_termination(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_WARM_START:
+    return osqp_update_warm_start(workspace, d3x_to_int(paramValue));
+
+  case D3X_PARAM_TIME_LIMIT:
+#ifdef PROFILING
+    return osqp_update_time_limit(workspace, paramValue);
+#else
+    return 0;
+#endif
+
+  default:
+    /* The remaining settings are fixed by osqp_setup. */
+    return 1;
+  }
+}
+
+c_int d3x_update_params(OSQPWorkspace* workspace, const jdouble* paramValues) {
+  for (int paramIndex = 0; paramIndex < D3X_PARAM_COUNT; ++paramIndex) {
+    if (!isnan(paramValues[paramIndex])) {
+      c_int status = d3x_update_param(workspace, paramIndex, paramValues[paramIndex]);
+
+      if (status != 0)
+        return status;
+    }
+  }
+
+  return 0;
+}
+
+OSQPSettings* d3x_create_settings(JNIEnv* jniEnv, jdoubleArray paramValues) {
+  /* Allocate data structure. */
+  jlong timer = d3x_stats_start();
+  OSQPSettings* settings = (OSQPSettings *) d3x_arena_alloc(sizeof(OSQPSettings));
+
+  if (!settings) {
+    fprintf(stderr, "Failed to allocate OSQPSettings structure.\n");
+    return OSQP_NULL;
+  }
+
+  /* Assign default settings. */
+  d3x_default_settings(settings);
+
+  /* Assign user-defined overrides, copied in a single region transfer. */
+  if ((*jniEnv)->GetArrayLength(jniEnv, paramValues) != D3X_PARAM_COUNT) {
+    fprintf(stderr, "Invalid parameter array length.\n");
+    return OSQP_NULL;
+  }
+
+  jdouble nativeParams[D3X_PARAM_COUNT];
+  (*jniEnv)->GetDoubleArrayRegion(jniEnv, paramValues, 0, D3X_PARAM_COUNT, nativeParams);
+  d3x_assign_params(nativeParams, settings);
+
+  d3x_stats_lap(D3X_STAT_SETTINGS, timer);
+  return settings;
+}
+
+OSQPWorkspace* d3x_create_workspace(OSQPData* data, OSQPSettings* settings) {
+  OSQPWorkspace* work = OSQP_NULL;
+  jlong timer = d3x_stats_start();
+  c_int status = osqp_setup(&work, data, settings);
+  d3x_stats_lap(D3X_STAT_SETUP, timer);
+
+  if (!work) {
+    fprintf(stderr, "Failed to allocate OSQPWorkspace structure.\n");
+    return OSQP_NULL;
+  }
+
+  /* Setup error codes are positive integers. */
+  if (status != 0) {
+    fprintf(stderr, "Problem setup failed.\n");
+    osqp_cleanup(work);
+    return OSQP_NULL;
+  }
+
+  return work;
+}
+
+/*
+ * The minimum number of iterations between checks of the cancellation
+ * flag and time limit.
+ */
+#define D3X_SOLVE_CHUNK 200
+
+static c_int d3x_gcd(c_int a, c_int b) {
+  while (b) {
+    c_int r = a % b;
+    a = b;
+    b = r;
+  }
+
+  return a;
+}
+
+/*
+ * The iteration counter restarts with each call to osqp_solve(), so the
+ * chunk length is a multiple of the termination and step-size intervals;
+ * the chunked iterations then check termination and adapt the step size
+ * at the same iterations as a single solve.
+ */
+static c_int d3x_solve_chunk(const OSQPSettings* settings) {
+  c_int base = settings->check_termination > 0 ? settings->check_termination : 1;
+
+  if (settings->adaptive_rho && settings->adaptive_rho_interval > 0)
+    base = base / d3x_gcd(base, settings->adaptive_rho_interval) * settings->adaptive_rho_interval;
+
+  return base * ((D3X_SOLVE_CHUNK + base - 1) / base);
+}
+
+/*
+ * A chunk that stops at its iteration limit is continued unless it was
+ * declared (approximately) infeasible, in which case OSQP has already
+ * reset the iterates.
+ */
+static int d3x_chunk_continues(const OSQPInfo* info, c_int iterLimit) {
+  return info->iter == iterLimit &&
+    (info->status_val == OSQP_MAX_ITER_REACHED || info->status_val == OSQP_SOLVED_INACCURATE);
+}
+
+/*
+ * OSQP makes its approximate termination check when a solve reaches its
+ * iteration limit, which a single solve does only at the real max_iter.
+ * A chunk that ends early with an approximate infeasibility status has had
+ * its iterates reset, so it is run again from its start.
+ */
+static int d3x_chunk_approximate(const OSQPInfo* info, c_int iterLimit) {
+  return info->iter == iterLimit &&
+    (info->status_val == OSQP_PRIMAL_INFEASIBLE_INACCURATE || info->status_val == OSQP_DUAL_INFEASIBLE_INACCURATE);
+}
+
+/*
+ * The scaled iterates and step size at the start of a chunk.
+ */
+typedef struct {
+  c_float* x;
+  c_float* z;
+  c_float* y;
+  c_float  rho;
+} D3XIterate;
+
+static int d3x_iterate_alloc(D3XIterate* iterate, c_int n, c_int m) {
+  iterate->x = (c_float*) d3x_arena_alloc(n * sizeof(c_float));
+  iterate->z = (c_float*) d3x_arena_alloc(m * sizeof(c_float));
+  iterate->y = (c_float*) d3x_arena_alloc(m * sizeof(c_float));
+  return iterate->x && iterate->z && iterate->y;
+}
+
+static void d3x_iterate_save(D3XIterate* iterate, const OSQPWorkspace* workspace) {
+  memcpy(iterate->x, workspace->x, workspace->data->n * sizeof(c_float));
+  memcpy(iterate->z, workspace->z, workspace->data->m * sizeof(c_float));
+  memcpy(iterate->y, workspace->y, workspace->data->m * sizeof(c_float));
+  iterate->rho = workspace->settings->rho;
+}
+
+static void d3x_iterate_restore(const D3XIterate* iterate, OSQPWorkspace* workspace) {
+  memcpy(workspace->x, iterate->x, workspace->data->n * sizeof(c_float));
+  memcpy(workspace->z, iterate->z, workspace->data->m * sizeof(c_float));
+  memcpy(workspace->y, iterate->y, workspace->data->m * sizeof(c_float));
+
+  /* The step size adapted during the chunk is adapted again. */
+  if (workspace->settings->rho != iterate->rho)
+    osqp_update_rho(workspace, iterate->rho);
+}
+
+static const char* d3x_status_name(const OSQPInfo* info) {
+  switch (info->status_val) {
+  case D3X_CANCELLED:
+    return "cancelled";
+
+  case OSQP_TIME_LIMIT_REACHED:
+    return "run time limit reached";
+
+  default:
+    return info->status;
+  }
+}
+
+/*
+ * The progress of a verbose solve with its own log file: the problem and
+ * settings, one line at the end of each chunk, and the outcome.
+ */
+static void d3x_log_header(FILE* log, const OSQPWorkspace* workspace) {
+  const OSQPData* data = workspace->data;
+  const OSQPSettings* settings = workspace->settings;
+
+  fprintf(log, "-----------------------------------------------------------------\n");
+  fprintf(log, "problem:  variables n = %lld, constraints m = %lld\n", (long long) data->n, (long long) data->m);
+  fprintf(log, "          nnz(P) + nnz(A) = %lld\n", (long long) (data->P->p[data->n] + data->A->p[data->n]));
+  fprintf(log, "settings: eps_abs = %.1e, eps_rel = %.1e,\n", settings->eps_abs, settings->eps_rel);
+  fprintf(log, "          eps_prim_inf = %.1e, eps_dual_inf = %.1e,\n", settings->eps_prim_inf, settings->eps_dual_inf);
+  fprintf(log, "          rho = %.2e%s, sigma = %.2e, alpha = %.2f,\n",
+          settings->rho, settings->adaptive_rho ? " (adaptive)" : "", settings->sigma, settings->alpha);
+  fprintf(log, "          max_iter = %lld, warm start: %s, polish: %s\n",
+          (long long) settings->max_iter, settings->warm_start ? "on" : "off", settings->polish ? "on" : "off");
+  fprintf(log, "-----------------------------------------------------------------\n");
+  fprintf(log, "iter   objective    pri res    dua res    rho        time\n");
+}
+
+static void d3x_log_iteration(FILE* log, const OSQPWorkspace* workspace, c_int iter, jlong start) {
+  const OSQPInfo* info = workspace->info;
+
+  fprintf(log, "%4lld  %12.4e  %9.2e  %9.2e  %9.2e  %9.2es\n",
+          (long long) iter, info->obj_val, info->pri_res, info->dua_res,
+          workspace->settings->rho, 1.0E-09 * (d3x_stats_now() - start));
+}
+
+static void d3x_log_footer(FILE* log, const OSQPWorkspace* workspace, jlong start) {
+  const OSQPInfo* info = workspace->info;
+
+  fprintf(log, "\n");
+  fprintf(log, "status:               %s\n", d3x_status_name(info));
+
+  if (workspace->settings->polish && info->status_val == OSQP_SOLVED)
+    fprintf(log, "solution polish:      %s\n", info->status_polish == 1 ? "successful" : "unsuccessful");
+
+  fprintf(log, "number of iterations: %lld\n", (long long) info->iter);
+  fprintf(log, "optimal objective:    %.4f\n", info->obj_val);
+  fprintf(log, "run time:             %.2es\n\n", 1.0E-09 * (d3x_stats_now() - start));
+  fflush(log);
+}
+
+c_int d3x_solve(OSQPWorkspace* workspace, const jint* cancelFlag, jdouble timeLimit, FILE* log) {
+  if (log && !workspace->settings->verbose)
+    log = OSQP_NULL;
+
+  if (!cancelFlag && timeLimit <= 0.0 && !log)
+    return osqp_solve(workspace);
+
+  OSQPSettings* settings = workspace->settings;
+  OSQPInfo* info = workspace->info;
+  c_int n = workspace->data->n;
+  c_int m = workspace->data->m;
+
+  c_int maxIter = settings->max_iter;
+  c_int warmStart = settings->warm_start;
+  c_int verbose = settings->verbose;
+  c_int chunk = d3x_solve_chunk(settings);
+  c_int runChunks = 1;
+  c_int totalIter = 0;
+  c_int rhoUpdates = 0;
+  c_int status = 0;
+  jlong start = d3x_stats_now();
+
+  /* Without room for the iterates, chunks are not run again. */
+  D3XIterate iterate;
+  d3x_arena_begin((n + 2 * m) * sizeof(c_float) + 3 * D3X_ARENA_ALIGN);
+  int restorable = chunk < maxIter && d3x_iterate_alloc(&iterate, n, m);
+
+#ifdef PROFILING
+  c_float osqpTimeLimit = settings->time_limit;
+  c_float solveTime = 0.0;
+  c_float runTime = 0.0;
+#endif
+
+  /* A solve with its own log prints nothing to the OSQP log. */
+  if (log) {
+    d3x_log_header(log, workspace);
+    settings->verbose = 0;
+  }
+
+  for (;;) {
+    c_int iterLimit = c_min(runChunks * chunk, maxIter - totalIter);
+    int lastChunk = iterLimit == maxIter - totalIter;
+    settings->max_iter = iterLimit;
+
+    if (restorable && !lastChunk)
+      d3x_iterate_save(&iterate, workspace);
+
+#ifdef PROFILING
+    /* Give OSQP the remaining time, so that it also stops mid-chunk. */
+    if (timeLimit > 0.0)
+      settings->time_limit = c_max(timeLimit - 1.0E-09 * (d3x_stats_now() - start), 1.0E-09);
+#endif
+
+    /* Later chunks continue from the last iterate without printing. */
+    status = osqp_solve(workspace);
+    settings->warm_start = 1;
+    settings->verbose = 0;
+
+#ifdef PROFILING
+    solveTime += info->solve_time;
+    runTime += info->run_time;
+#endif
+
+    /*
+     * The chunk is run again together with the following ones, doubling
+     * the length each time, so the repeated iterations are bounded by the
+     * remaining ones; cancellation and the time limit are checked when
+     * the longer run ends.
+     */
+    if (status == 0 && restorable && !lastChunk && d3x_chunk_approximate(info, iterLimit)) {
+      d3x_iterate_restore(&iterate, workspace);
+      runChunks *= 2;
+      continue;
+    }
+
+    runChunks = 1;
+    totalIter += info->iter;
+    rhoUpdates += info->rho_updates;
+
+    if (log)
+      d3x_log_iteration(log, workspace, totalIter, start);
+
+    if (status != 0 || totalIter >= maxIter || !d3x_chunk_continues(info, iterLimit))
+      break;
+
+    if (cancelFlag && __atomic_load_n(cancelFlag, __ATOMIC_ACQUIRE)) {
+      info->status_val = D3X_CANCELLED;
+      break;
+    }
+
+    if (timeLimit > 0.0 && 1.0E-09 * (d3x_stats_now() - start) >= timeLimit) {
+      info->status_val = OSQP_TIME_LIMIT_REACHED;
+      break;
+    }
+  }
+
+  d3x_arena_end();
+
+  settings->max_iter = maxIter;
+  settings->warm_start = warmStart;
+  settings->verbose = verbose;
+
+  info->iter = totalIter;
+  info->rho_updates = rhoUpdates;
+
+#ifdef PROFILING
+  settings->time_limit = osqpTimeLimit;
+  info->solve_time = solveTime;
+  info->run_time = runTime;
+#endif
+
+  if (log)
+    d3x_log_footer(log, workspace, start);
+
+  return status;
+}
+
+void d3x_copy_info(const OSQPInfo* info, jdouble* values) {
+  values[D3X_INFO_ITER]          = info->iter;
+  values[D3X_INFO_STATUS_VAL]    = info->status_val;
+  values[D3X_INFO_STATUS_POLISH] = info->status_polish;
+  values[D3X_INFO_OBJ_VAL]       = info->obj_val;
+  values[D3X_INFO_PRI_RES]       = info->pri_res;
+  values[D3X_INFO_DUA_RES]       = info->dua_res;
+
+#ifdef PROFILING
+  values[D3X_INFO_SETUP_TIME]  = info->setup_time;
+  values[D3X_INFO_SOLVE_TIME]  = info->solve_time;
+  values[D3X_INFO_UPDATE_TIME] = info->update_time;
+  values[D3X_INFO_POLISH_TIME] = info->polish_time;
+  values[D3X_INFO_RUN_TIME]    = info->run_time;
+#else
+  values[D3X_INFO_SETUP_TIME]  = NAN;
+  values[D3X_INFO_SOLVE_TIME]  = NAN;
+  values[D3X_INFO_UPDATE_TIME] = NAN;
+  values[D3X_INFO_POLISH_TIME] = NAN;
+  values[D3X_INFO_RUN_TIME]    = NAN;
+#endif
+
+  values[D3X_INFO_RHO_UPDATES]  = info->rho_updates;
+  values[D3X_INFO_RHO_ESTIMATE] = info->rho_estimate;
+}
+
+/*
+ * Serializes the setups and batch solves that write to the OSQP log.
+ */
+static pthread_mutex_t d3x_log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int d3x_open_log(JNIEnv* jniEnv, jstring logName) {
+  if ((*jniEnv)->GetStringUTFLength(jniEnv, logName) == 0)
+    return 0;
+
+  const char *rawLogName = (*jniEnv)->GetStringUTFChars(jniEnv, logName, 0);
+
+  pthread_mutex_lock(&d3x_log_mutex);
+  osqp_open_log(rawLogName);
+
+  (*jniEnv)->ReleaseStringUTFChars(jniEnv, logName, rawLogName);
+  return 1;
+}
+
+void d3x_close_log(int logOpened) {
+  if (logOpened) {
+    osqp_close_log();
+    pthread_mutex_unlock(&d3x_log_mutex);
+  }
+}
+
+FILE* d3x_open_solve_log(JNIEnv* jniEnv, jstring logName) {
+  if ((*jniEnv)->GetStringUTFLength(jniEnv, logName) == 0)
+    return OSQP_NULL;
+
+  const char *rawLogName = (*jniEnv)->GetStringUTFChars(jniEnv, logName, 0);
+  FILE* log = fopen(rawLogName, "a");
+
+  if (!log)
+    fprintf(stderr, "Failed to open log file %s.\n", rawLogName);
+
+  (*jniEnv)->ReleaseStringUTFChars(jniEnv, logName, rawLogName);
+  return log;
+}
+
+void d3x_close_solve_log(FILE* log) {
+  if (log)
+    fclose(log);
+}
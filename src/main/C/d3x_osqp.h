@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef D3X_OSQP_H
+#define D3X_OSQP_H
+
+#include <jni.h>
+#include <stdio.h>
+#include "osqp.h"
+
+/*
+ * The status code used to indicate errors during problem setup.
+ */
+#define D3X_SETUP_ERROR (-1)
+
+/*
+ * The status code used to indicate a solve cancelled by the caller, which
+ * is not used by OSQP itself.
+ */
+#define D3X_CANCELLED (-11)
+
+/*
+ * Verifies that OSQP has been compiled with DLONG on, and with DFLOAT off
+ * (or on, for the single-precision library compiled with DFLOAT defined);
+ * returns a non-zero value if the native types are compatible.
+ */
+int d3x_check_types(void);
+
+/*
+ * Verifies that the packed parameter arrays hold paramCount (the number of
+ * Java OsqpParam constants) values for each of count problems, and that
+ * paramCount matches D3X_PARAM_COUNT; returns a non-zero value if it does.
+ */
+int d3x_check_params(JNIEnv* jniEnv, jdoubleArray params, jint count, jint paramCount);
+
+/*
+ * Moves real vectors between Java double arrays and OSQP, in the precision
+ * of the OSQP build.  In the default build c_float is double, so the JVM
+ * pins or copies the array elements as usual.  In the single-precision
+ * build the values are converted: d3x_get_floats() opens an arena scope
+ * for its copy, which the matching d3x_release_floats() closes, and the
+ * region functions convert in place of the Java array elements.  Arrays
+ * obtained by d3x_get_floats() are only read by the caller.
+ */
+c_float* d3x_get_floats(JNIEnv* jniEnv, jdoubleArray array);
+void d3x_release_floats(JNIEnv* jniEnv, jdoubleArray array, c_float* values);
+void d3x_get_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, c_float* values);
+void d3x_set_float_region(JNIEnv* jniEnv, jdoubleArray array, jsize start, jsize length, const c_float* values);
+
+/*
+ * The Java arrays holding the problem data for one quadratic program, with
+ * the matrices in compressed sparse column format.
+ */
+typedef struct {
+  jdoubleArray linObjCoeff;
+  jlongArray   quadObjColPtr;
+  jlongArray   quadObjRowInd;
+  jdoubleArray quadObjCoeff;
+  jlongArray   linConColPtr;
+  jlongArray   linConRowInd;
+  jdoubleArray linConCoeff;
+  jdoubleArray linConLower;
+  jdoubleArray linConUpper;
+} D3XArrays;
+
+/*
+ * Creates problem data that refers to the Java array elements directly;
+ * the data must be released by d3x_free_data() after the solver setup,
+ * which copies everything that it needs.  The wrappers are allocated in
+ * the arena scope of the calling thread.
+ */
+OSQPData* d3x_create_data(JNIEnv*          jniEnv,
+                          jlong            numVar,
+                          jlong            numDual,
+                          const D3XArrays* arrays);
+
+void d3x_free_data(JNIEnv*          jniEnv,
+                   const D3XArrays* arrays,
+                   OSQPData*        data);
+
+/*
+ * The direct buffers holding the problem data for one quadratic program,
+ * in the same layout as D3XArrays.
+ */
+typedef struct {
+  jobject linObjCoeff;
+  jobject quadObjColPtr;
+  jobject quadObjRowInd;
+  jobject quadObjCoeff;
+  jobject linConColPtr;
+  jobject linConRowInd;
+  jobject linConCoeff;
+  jobject linConLower;
+  jobject linConUpper;
+} D3XBuffers;
+
+/*
+ * Creates problem data that refers to the contents of direct buffers in
+ * place.  The wrappers are allocated in the arena scope of the calling
+ * thread and released when it ends; the buffer contents belong to Java.
+ */
+OSQPData* d3x_wrap_data(JNIEnv*           jniEnv,
+                        jlong             numVar,
+                        jlong             numDual,
+                        const D3XBuffers* buffers);
+
+/*
+ * The indexes of the solver parameters, which must match the declaration
+ * order of the com.d3x.osqp.OsqpParam enumeration.  Parameters are passed
+ * as an array of D3X_PARAM_COUNT values indexed this way, with NaN values
+ * for parameters that keep their defaults.
+ */
+enum {
+  D3X_PARAM_RHO,
+  D3X_PARAM_SIGMA,
+  D3X_PARAM_ALPHA,
+  D3X_PARAM_POLISH,
+  D3X_PARAM_MAX_ITER,
+  D3X_PARAM_EPS_ABS,
+  D3X_PARAM_EPS_REL,
+  D3X_PARAM_EPS_PRIM_INF,
+  D3X_PARAM_EPS_DUAL_INF,
+  D3X_PARAM_SCALING,
+  D3X_PARAM_ADAPTIVE_RHO,
+  D3X_PARAM_ADAPTIVE_RHO_INTERVAL,
+  D3X_PARAM_ADAPTIVE_RHO_TOLERANCE,
+  D3X_PARAM_ADAPTIVE_RHO_FRACTION,
+  D3X_PARAM_DELTA,
+  D3X_PARAM_POLISH_REFINE_ITER,
+  D3X_PARAM_VERBOSE,
+  D3X_PARAM_SCALED_TERMINATION,
+  D3X_PARAM_CHECK_TERMINATION,
+  D3X_PARAM_WARM_START,
+  D3X_PARAM_TIME_LIMIT,
+  D3X_PARAM_LINSYS_SOLVER,
+  D3X_PARAM_COUNT
+};
+
+/*
+ * Assigns the default settings used by this library, which differ from
+ * the OSQP defaults only in enabling solution polishing.
+ */
+void d3x_default_settings(OSQPSettings* settings);
+
+/*
+ * Assigns the parameters that are not NaN in an array indexed as above.
+ */
+void d3x_assign_params(const jdouble* paramValues, OSQPSettings* settings);
+
+/*
+ * Updates the parameters that are not NaN in the settings of an existing
+ * workspace; returns zero on success, or a non-zero value if a parameter
+ * cannot be updated without a new setup.
+ */
+c_int d3x_update_params(OSQPWorkspace* workspace, const jdouble* paramValues);
+
+/*
+ * Creates the settings for a new workspace in the arena scope of the
+ * calling thread, with the parameters copied from a Java array.
+ */
+OSQPSettings* d3x_create_settings(JNIEnv* jniEnv, jdoubleArray paramValues);
+
+OSQPWorkspace* d3x_create_workspace(OSQPData* data, OSQPSettings* settings);
+
+/*
+ * Solves the problem held in a workspace.  When a cancellation flag or a
+ * time limit (in seconds) is given, the ADMM iterations run in chunks of
+ * several hundred iterations, each warm started from the last iterate, and
+ * the flag and elapsed time are checked between chunks; a cancelled solve
+ * or one that runs out of time keeps the last iterate as its solution and
+ * reports D3X_CANCELLED or OSQP_TIME_LIMIT_REACHED.  The approximate
+ * termination check applies only at the real iteration limit, as in a
+ * single solve.  Only the first chunk prints its progress.  A verbose
+ * solve given a log file also runs in chunks, prints nothing to the OSQP
+ * log, and writes its progress (one line per chunk) and outcome to the
+ * log file instead.  Returns the value returned by osqp_solve().
+ */
+c_int d3x_solve(OSQPWorkspace* workspace, const jint* cancelFlag, jdouble timeLimit, FILE* log);
+
+/*
+ * The indexes of the solver statistics copied from OSQPInfo, which must
+ * match the layout read by com.d3x.osqp.OsqpInfo.
+ */
+enum {
+  D3X_INFO_ITER,
+  D3X_INFO_STATUS_VAL,
+  D3X_INFO_STATUS_POLISH,
+  D3X_INFO_OBJ_VAL,
+  D3X_INFO_PRI_RES,
+  D3X_INFO_DUA_RES,
+  D3X_INFO_SETUP_TIME,
+  D3X_INFO_SOLVE_TIME,
+  D3X_INFO_UPDATE_TIME,
+  D3X_INFO_POLISH_TIME,
+  D3X_INFO_RUN_TIME,
+  D3X_INFO_RHO_UPDATES,
+  D3X_INFO_RHO_ESTIMATE,
+  D3X_INFO_COUNT
+};
+
+/*
+ * Copies the solver statistics into an array of D3X_INFO_COUNT values;
+ * the timings are NaN unless OSQP was compiled with PROFILING on.
+ */
+void d3x_copy_info(const OSQPInfo* info, jdouble* values);
+
+/*
+ * The phases of the adapter timed by the optional native instrumentation,
+ * which must match com.d3x.osqp.OsqpNativeStats.Phase.
+ */
+enum {
+  D3X_STAT_GET_ARRAYS,
+  D3X_STAT_CREATE_CSC,
+  D3X_STAT_SETTINGS,
+  D3X_STAT_SETUP,
+  D3X_STAT_SOLVE,
+  D3X_STAT_UPDATE,
+  D3X_STAT_SET_REGION,
+  D3X_STAT_RELEASE,
+  D3X_STAT_COUNT
+};
+
+/*
+ * Starts a timer; returns zero (and costs one relaxed load) unless the
+ * instrumentation is enabled.
+ */
+jlong d3x_stats_start(void);
+
+/*
+ * Adds the time elapsed since the start of a timer to a phase and starts
+ * the timer again; the times accumulate in storage local to the calling
+ * thread until d3x_stats_flush() adds them to the global totals.
+ */
+jlong d3x_stats_lap(int stat, jlong start);
+void d3x_stats_flush(void);
+
+void d3x_stats_enable(int enabled);
+void d3x_stats_reset(void);
+
+/*
+ * Copies the global totals: for each phase, the number of laps followed
+ * by the total time in nanoseconds.
+ */
+void d3x_stats_read(jlong* values);
+
+/*
+ * A bump allocator local to the calling thread for the scratch memory of
+ * a native call: the problem wrappers, the settings, and work vectors.
+ * The memory is kept between calls, so in the steady state the adapter
+ * itself never calls malloc or free.  d3x_arena_begin() opens a scope and
+ * reserves at least the given number of bytes (the estimate for the whole
+ * call); all memory returned by d3x_arena_alloc() within the scope is
+ * released at once by the matching d3x_arena_end().  Scopes may nest; the
+ * memory is reused when the outermost scope ends.  The blocks of a thread
+ * that needed more than one are merged into one at its next outer scope,
+ * and are freed when the thread exits.
+ */
+void  d3x_arena_begin(size_t reserve);
+void* d3x_arena_alloc(size_t size);
+void  d3x_arena_end(void);
+
+/*
+ * The alignment of arena allocations, and the arena space needed by the
+ * problem wrappers and settings created for one setup.
+ */
+#define D3X_ARENA_ALIGN 16
+#define D3X_ARENA_SETUP_SIZE (sizeof(OSQPData) + 2 * sizeof(csc) + sizeof(OSQPSettings) + 4 * D3X_ARENA_ALIGN)
+
+/*
+ * The indexes of the arena statistics, which must match the layout read
+ * by com.d3x.osqp.OsqpNativeStats: the number of outer scopes (counted
+ * only while the instrumentation is enabled), the number of blocks taken
+ * from malloc, and the largest number of bytes used by one outer scope.
+ */
+enum {
+  D3X_ARENA_SCOPES,
+  D3X_ARENA_GROWTHS,
+  D3X_ARENA_PEAK_BYTES,
+  D3X_ARENA_COUNT
+};
+
+/*
+ * Copies the global arena statistics into an array of D3X_ARENA_COUNT
+ * values; d3x_stats_reset() resets them with the phase totals.
+ */
+void d3x_arena_read(jlong* values);
+
+/*
+ * Captures the OSQP console output in the named log file (if the name is
+ * not empty) until the matching call to d3x_close_log(), which must
+ * receive the value returned by d3x_open_log().  The OSQP log is shared
+ * by the process, so a lock is held while a log is open, and output that
+ * other threads print meanwhile also goes to that file.  It is used only
+ * for setups and batch solves.
+ */
+int d3x_open_log(JNIEnv* jniEnv, jstring logName);
+void d3x_close_log(int logOpened);
+
+/*
+ * Opens the named log file for appending (if the name is not empty), for
+ * a solve whose progress d3x_solve() writes itself.  Each call has its own
+ * file, so solves with log files run concurrently; returns NULL if the
+ * name is empty or the file cannot be opened.
+ */
+FILE* d3x_open_solve_log(JNIEnv* jniEnv, jstring logName);
+void  d3x_close_solve_log(FILE* log);
+
+#endif /* D3X_OSQP_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <jni.h>
+#include "osqp.h"
+#include "d3x_osqp.h"
+#include "com_d3x_osqp_OsqpSolver.h"
+
+/*
+ * The entry point of the single-precision adapter library, which holds the
+ * OsqpSolver functions compiled against an OSQP build with DFLOAT defined.
+ * The library is compiled with JNIEXPORT defined empty and all symbols
+ * hidden, so the JVM never binds OsqpSolver methods to these functions;
+ * instead they are registered here as the native methods of OsqpSingle,
+ * which declares the same methods.  Only JNI_OnLoad is exported.
+ */
+#define D3X_SINGLE_EXPORT __attribute__((visibility("default")))
+
+#define D3X_SINGLE_CLASS "com/d3x/osqp/OsqpSingle"
+
+#define D3X_SINGLE_METHOD(name, signature) { #name, signature, (void*) Java_com_d3x_osqp_OsqpSolver_##name }
+
+static JNINativeMethod d3x_single_methods[] = {
+  D3X_SINGLE_METHOD(setup,
+                    "(JJLjava/lang/String;[D[J[J[D[J[J[D[D[D[D)J"),
+  D3X_SINGLE_METHOD(setupDirect,
+                    "(JJLjava/lang/String;Ljava/nio/DoubleBuffer;Ljava/nio/LongBuffer;Ljava/nio/LongBuffer;"
+                    "Ljava/nio/DoubleBuffer;Ljava/nio/LongBuffer;Ljava/nio/LongBuffer;Ljava/nio/DoubleBuffer;"
+                    "Ljava/nio/DoubleBuffer;Ljava/nio/DoubleBuffer;[D)J"),
+  D3X_SINGLE_METHOD(solve,            "(JLjava/lang/String;[D[D[DLjava/nio/ByteBuffer;D)I"),
+  D3X_SINGLE_METHOD(sweep,            "(JLjava/lang/String;I[D[D[D[D[D[ILjava/nio/ByteBuffer;D)V"),
+  D3X_SINGLE_METHOD(updateLinCost,    "(J[D)I"),
+  D3X_SINGLE_METHOD(updateBounds,     "(J[D[D)I"),
+  D3X_SINGLE_METHOD(updateLowerBound, "(J[D)I"),
+  D3X_SINGLE_METHOD(updateUpperBound, "(J[D)I"),
+  D3X_SINGLE_METHOD(updateSettings,   "(J[D)I"),
+  D3X_SINGLE_METHOD(updateMatrices,   "(J[D[J[D[J)I"),
+  D3X_SINGLE_METHOD(warmStart,        "(J[D[D)I"),
+  D3X_SINGLE_METHOD(evaluate,         "(J[D[D)I"),
+  D3X_SINGLE_METHOD(cleanup,          "(J)V")
+};
+
+D3X_SINGLE_EXPORT jint JNICALL
+JNI_OnLoad(JavaVM* javaVM, void* reserved) {
+  JNIEnv* jniEnv = NULL;
+
+  if ((*javaVM)->GetEnv(javaVM, (void**) &jniEnv, JNI_VERSION_1_8) != JNI_OK)
+    return JNI_ERR;
+
+  if (!d3x_check_types())
+    return JNI_ERR;
+
+  jclass jniClass = (*jniEnv)->FindClass(jniEnv, D3X_SINGLE_CLASS);
+
+  if (!jniClass)
+    return JNI_ERR;
+
+  jint count = (jint) (sizeof(d3x_single_methods) / sizeof(d3x_single_methods[0]));
+
+  if ((*jniEnv)->RegisterNatives(jniEnv, jniClass, d3x_single_methods, count) != JNI_OK)
+    return JNI_ERR;
+
+  return JNI_VERSION_1_8;
+}
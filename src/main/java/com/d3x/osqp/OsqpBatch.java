@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Packs many independent quadratic programs into a few contiguous arrays
+ * and solves them all in a single native call, so that the cost of the
+ * JNI transitions and argument marshalling is paid once per batch rather
+ * than once per problem.
+ *
+ * <p>The native code solves the problems concurrently on a pool of worker
+ * threads, which claim the problems in small chunks.  Each worker keeps
+ * one workspace and reuses it for the next problem with the same sparsity
+ * pattern and parameters; no workspace survives the batch.</p>
+ *
+ * <p>A batch may instead hold problems stored in model files, which the
+ * native code maps into memory and reads in place.</p>
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpBatch {
+    private final List<Problem> problems;
+    private final List<FileProblem> files;
+
+    private int[] primalOffset = null;
+    private int[] dualOffset = null;
+    private double[] primal = null;
+    private double[] dual = null;
+    private int[] status = null;
+    private double[] info = null;
+
+    // The number of dimensions stored for each problem: the number of
+    // variables, the number of constraint rows, and the number of
+    // non-zeros in the quadratic objective and constraint matrices...
+    private static final int DIM_COUNT = 4;
+
+    // The number of dimensions stored for each model file, which the
+    // native code checks against the file header: the number of variables
+    // and the number of constraint rows...
+    private static final int FILE_DIM_COUNT = 2;
+
+    // The number of parameter slots stored for each problem; the slots
+    // are indexed by the parameter ordinal, and the native code checks
+    // this count against its own...
+    private static final int PARAM_COUNT = OsqpParam.values().length;
+
+    /**
+     * The system property that sets the default number of worker threads.
+     */
+    static final String THREADS_PROPERTY = "com.d3x.osqp.threads";
+
+    static {
+        System.loadLibrary("osqp");
+        System.loadLibrary("d3x-osqp");
+    }
+
+    private static final class Problem {
+        private final int numVar;
+        private final int numDual;
+        private final double[] linObjCoeff;
+        private final OsqpMatrix quadObj;
+        private final OsqpMatrix linCon;
+        private final double[] linConLower;
+        private final double[] linConUpper;
+        private final double[] params;
+
+        private Problem(int numVar,
+                        int numDual,
+                        double[] linObjCoeff,
+                        OsqpMatrix quadObj,
+                        OsqpMatrix linCon,
+                        double[] linConLower,
+                        double[] linConUpper,
+                        Map<OsqpParam, Double> params) {
+            this.numVar = numVar;
+            this.numDual = numDual;
+            this.linObjCoeff = linObjCoeff.clone();
+            this.quadObj = quadObj;
+            this.linCon = linCon;
+            this.linConLower = linConLower.clone();
+            this.linConUpper = linConUpper.clone();
+            this.params = OsqpParam.toArray(params);
+        }
+
+        private int indexLength() {
+            return 2 * (numVar + 1) + quadObj.nnz + linCon.nnz;
+        }
+
+        private int realLength() {
+            return numVar + quadObj.nnz + linCon.nnz + 2 * numDual;
+        }
+    }
+
+    private static final class FileProblem {
+        private final String path;
+        private final int numVar;
+        private final int numDual;
+        private final double[] params;
+
+        private FileProblem(String path, int numVar, int numDual, Map<OsqpParam, Double> params) {
+            this.path = path;
+            this.numVar = numVar;
+            this.numDual = numDual;
+            this.params = OsqpParam.toArray(params);
+        }
+    }
+
+    /**
+     * Creates an empty batch.
+     *
+     * @param capacity the expected number of problems.
+     */
+    OsqpBatch(int capacity) {
+        this.problems = new ArrayList<>(capacity);
+        this.files = new ArrayList<>();
+    }
+
+    /**
+     * Adds a problem to this batch.  The vectors are copied, so the caller
+     * may modify them after this method returns.
+     *
+     * @param numVar      the number of decision variables.
+     * @param numDual     the number of rows in the constraint matrix.
+     * @param linObjCoeff the linear objective coefficients.
+     * @param quadObj     the quadratic objective matrix (upper triangle).
+     * @param linCon      the linear constraint matrix.
+     * @param linConLower the lower bounds for the constraint rows.
+     * @param linConUpper the upper bounds for the constraint rows.
+     * @param params      the solver parameters to assign.
+     *
+     * @return the index of the problem within this batch.
+     */
+    int add(int numVar,
+            int numDual,
+            double[] linObjCoeff,
+            OsqpMatrix quadObj,
+            OsqpMatrix linCon,
+            double[] linConLower,
+            double[] linConUpper,
+            Map<OsqpParam, Double> params) {
+        if (!files.isEmpty())
+            throw new IllegalStateException("A batch may not mix model files with other problems.");
+
+        problems.add(new Problem(numVar, numDual, linObjCoeff, quadObj, linCon, linConLower, linConUpper, params));
+        status = null;
+        return problems.size() - 1;
+    }
+
+    /**
+     * Adds a problem stored in a model file to this batch.  The native code
+     * maps the file and reads the problem data in place.
+     *
+     * @param path    the model file (see {@link OsqpModelFile}).
+     * @param numVar  the number of decision variables, from the file header.
+     * @param numDual the number of constraint rows, from the file header.
+     * @param params  parameters that override those stored in the file.
+     *
+     * @return the index of the problem within this batch.
+     */
+    int addFile(String path, int numVar, int numDual, Map<OsqpParam, Double> params) {
+        if (!problems.isEmpty())
+            throw new IllegalStateException("A batch may not mix model files with other problems.");
+
+        files.add(new FileProblem(path, numVar, numDual, params));
+        status = null;
+        return files.size() - 1;
+    }
+
+    /**
+     * Returns the number of problems in this batch.
+     * @return the number of problems in this batch.
+     */
+    int size() {
+        return problems.size() + files.size();
+    }
+
+    /**
+     * Returns the default number of worker threads: the value of the
+     * {@code com.d3x.osqp.threads} system property, if it is assigned,
+     * otherwise the number of available processors.
+     *
+     * @return the default number of worker threads.
+     */
+    static int defaultThreadCount() {
+        return Integer.getInteger(THREADS_PROPERTY, Runtime.getRuntime().availableProcessors());
+    }
+
+    /**
+     * Solves every problem in this batch with one native call.
+     *
+     * @param logFile    the name of the solver log file (empty for none).
+     * @param numThreads the number of worker threads to use.
+     */
+    void solve(String logFile, int numThreads) {
+        if (!files.isEmpty()) {
+            solveModelFiles(logFile, numThreads);
+            return;
+        }
+
+        var count = problems.size();
+        var dims = new long[DIM_COUNT * count];
+        var params = new double[PARAM_COUNT * count];
+
+        primalOffset = new int[count + 1];
+        dualOffset = new int[count + 1];
+
+        var indexLength = 0;
+        var realLength = 0;
+
+        for (int k = 0; k < count; ++k) {
+            var problem = problems.get(k);
+
+            dims[DIM_COUNT * k] = problem.numVar;
+            dims[DIM_COUNT * k + 1] = problem.numDual;
+            dims[DIM_COUNT * k + 2] = problem.quadObj.nnz;
+            dims[DIM_COUNT * k + 3] = problem.linCon.nnz;
+
+            System.arraycopy(problem.params, 0, params, PARAM_COUNT * k, PARAM_COUNT);
+
+            primalOffset[k + 1] = primalOffset[k] + problem.numVar;
+            dualOffset[k + 1] = dualOffset[k] + problem.numDual;
+
+            indexLength += problem.indexLength();
+            realLength += problem.realLength();
+        }
+
+        // The native code reads the packed arrays in this order...
+        var index = new long[indexLength];
+        var reals = new double[realLength];
+
+        var indexPos = 0;
+        var realPos = 0;
+
+        for (var problem : problems) {
+            indexPos = append(problem.quadObj.colptr, index, indexPos);
+            indexPos = append(problem.quadObj.rowind, index, indexPos);
+            indexPos = append(problem.linCon.colptr, index, indexPos);
+            indexPos = append(problem.linCon.rowind, index, indexPos);
+
+            realPos = append(problem.linObjCoeff, reals, realPos);
+            realPos = append(problem.quadObj.values, reals, realPos);
+            realPos = append(problem.linCon.values, reals, realPos);
+            realPos = append(problem.linConLower, reals, realPos);
+            realPos = append(problem.linConUpper, reals, realPos);
+        }
+
+        allocateResults(count);
+        solveBatch(logFile, numThreads, count, PARAM_COUNT, dims, index, reals, params, primal, dual, status, info);
+    }
+
+    private void solveModelFiles(String logFile, int numThreads) {
+        var count = files.size();
+        var paths = new String[count];
+        var dims = new long[FILE_DIM_COUNT * count];
+        var params = new double[PARAM_COUNT * count];
+
+        primalOffset = new int[count + 1];
+        dualOffset = new int[count + 1];
+
+        for (int k = 0; k < count; ++k) {
+            var file = files.get(k);
+
+            paths[k] = file.path;
+            dims[FILE_DIM_COUNT * k] = file.numVar;
+            dims[FILE_DIM_COUNT * k + 1] = file.numDual;
+
+            System.arraycopy(file.params, 0, params, PARAM_COUNT * k, PARAM_COUNT);
+
+            primalOffset[k + 1] = primalOffset[k] + file.numVar;
+            dualOffset[k + 1] = dualOffset[k] + file.numDual;
+        }
+
+        allocateResults(count);
+        solveFiles(logFile, numThreads, count, PARAM_COUNT, paths, dims, params, primal, dual, status, info);
+    }
+
+    private void allocateResults(int count) {
+        primal = new double[primalOffset[count]];
+        dual = new double[dualOffset[count]];
+        status = new int[count];
+        info = OsqpInfo.newValues(count);
+
+        Arrays.fill(primal, Double.NaN);
+        Arrays.fill(dual, Double.NaN);
+        Arrays.fill(status, OsqpStatus.SETUP_ERROR.getCode());
+    }
+
+    private static int append(long[] source, long[] target, int position) {
+        System.arraycopy(source, 0, target, position, source.length);
+        return position + source.length;
+    }
+
+    private static int append(double[] source, double[] target, int position) {
+        System.arraycopy(source, 0, target, position, source.length);
+        return position + source.length;
+    }
+
+    private void checkSolved() {
+        if (status == null)
+            throw new IllegalStateException("The batch has not been solved.");
+    }
+
+    /**
+     * Returns the solution status for a problem in this batch.
+     *
+     * @param problem the index of the problem.
+     *
+     * @return the solution status for the specified problem.
+     */
+    OsqpStatus getStatus(int problem) {
+        checkSolved();
+        return OsqpStatus.valueOf(status[problem]);
+    }
+
+    /**
+     * Returns the solver statistics for a problem in this batch.
+     *
+     * @param problem the index of the problem.
+     *
+     * @return the solver statistics for the specified problem, or
+     * {@code null} if its setup failed.
+     */
+    OsqpInfo getInfo(int problem) {
+        checkSolved();
+
+        if (status[problem] != OsqpStatus.SETUP_ERROR.getCode())
+            return OsqpInfo.of(info, problem * OsqpInfo.SIZE);
+        else
+            return null;
+    }
+
+    /**
+     * Copies the optimal primal solution for a problem in this batch.
+     *
+     * @param problem the index of the problem.
+     * @param target  the array to receive the solution.
+     */
+    void getPrimal(int problem, double[] target) {
+        checkSolved();
+        System.arraycopy(primal, primalOffset[problem], target, 0, primalOffset[problem + 1] - primalOffset[problem]);
+    }
+
+    /**
+     * Copies the optimal dual solution for a problem in this batch.
+     *
+     * @param problem the index of the problem.
+     * @param target  the array to receive the solution.
+     */
+    void getDual(int problem, double[] target) {
+        checkSolved();
+        System.arraycopy(dual, dualOffset[problem], target, 0, dualOffset[problem + 1] - dualOffset[problem]);
+    }
+
+    private static native void solveBatch(
+            String   logFile,
+            int      numThreads,
+            int      count,
+            int      paramCount,
+            long[]   dims,
+            long[]   index,
+            double[] reals,
+            double[] params,
+            double[] primal,
+            double[] dual,
+            int[]    status,
+            double[] info);
+
+    private static native void solveFiles(
+            String   logFile,
+            int      numThreads,
+            int      count,
+            int      paramCount,
+            String[] paths,
+            long[]   dims,
+            double[] params,
+            double[] primal,
+            double[] dual,
+            int[]    status,
+            double[] info);
+}
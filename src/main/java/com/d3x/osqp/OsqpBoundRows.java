@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+
+/**
+ * Maps the decision variable bounds of a model onto the rows of the native
+ * constraint matrix.  Only the variables with at least one finite bound
+ * are given a row, in variable order, after the linear constraints; the
+ * variables that remain unbounded add nothing to the KKT system.
+ *
+ * <p>Vectors indexed by constraint row therefore have two layouts: the
+ * model layout (the linear constraints followed by every variable) and the
+ * solver layout (the linear constraints followed by the bounded variables).
+ * This class converts between them.</p>
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpBoundRows {
+    private final int numCon;
+    private final int numVar;
+    private final int[] boundVars;
+
+    private OsqpBoundRows(int numCon, int numVar, int[] boundVars) {
+        this.numCon = numCon;
+        this.numVar = numVar;
+        this.boundVars = boundVars;
+    }
+
+    /**
+     * Finds the bounded variables.
+     *
+     * @param numCon   the number of linear constraints.
+     * @param numVar   the number of decision variables.
+     * @param lower    the lower bounds in the model layout.
+     * @param upper    the upper bounds in the model layout.
+     * @param maxBound the magnitude at or above which a bound is infinite.
+     *
+     * @return the row mapping for the given bounds.
+     */
+    static OsqpBoundRows of(int numCon, int numVar, double[] lower, double[] upper, double maxBound) {
+        var boundVars = new int[numVar];
+        var count = 0;
+
+        for (int var = 0; var < numVar; ++var)
+            if (isBounded(lower[numCon + var], upper[numCon + var], maxBound))
+                boundVars[count++] = var;
+
+        return new OsqpBoundRows(numCon, numVar, Arrays.copyOf(boundVars, count));
+    }
+
+    /**
+     * Determines whether a pair of bounds restricts a variable.
+     *
+     * @param lower    the lower bound.
+     * @param upper    the upper bound.
+     * @param maxBound the magnitude at or above which a bound is infinite.
+     *
+     * @return {@code true} iff either bound is finite.
+     */
+    static boolean isBounded(double lower, double upper, double maxBound) {
+        return lower > -maxBound || upper < maxBound;
+    }
+
+    /**
+     * Determines whether this mapping has a row for every variable that is
+     * bounded by a given pair of bound vectors.
+     *
+     * @param lower    the lower bounds in the model layout.
+     * @param upper    the upper bounds in the model layout.
+     * @param maxBound the magnitude at or above which a bound is infinite.
+     *
+     * @return {@code true} iff the bounds can be expressed in the solver
+     * layout of this mapping.
+     */
+    boolean covers(double[] lower, double[] upper, double maxBound) {
+        var next = 0;
+
+        for (int var = 0; var < numVar; ++var) {
+            if (next < boundVars.length && boundVars[next] == var)
+                ++next;
+            else if (isBounded(lower[numCon + var], upper[numCon + var], maxBound))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Returns the number of rows in the solver layout.
+     * @return the number of rows in the solver layout.
+     */
+    int numRows() {
+        return numCon + boundVars.length;
+    }
+
+    // Every variable has a row, so the layouts coincide...
+    private boolean isComplete() {
+        return boundVars.length == numVar;
+    }
+
+    /**
+     * Appends a unit row for each bounded variable to the constraint matrix.
+     *
+     * @param linCon the linear constraint matrix (with {@code numCon} rows).
+     *
+     * @return the constraint matrix in the solver layout.
+     */
+    OsqpMatrix stack(OsqpMatrix linCon) {
+        return linCon.appendUnitRows(boundVars);
+    }
+
+    /**
+     * Converts a vector from the model layout to the solver layout.
+     *
+     * @param model a vector in the model layout.
+     *
+     * @return the vector in the solver layout; the argument itself if the
+     * layouts coincide.
+     */
+    double[] gather(double[] model) {
+        if (isComplete())
+            return model;
+
+        var solver = Arrays.copyOf(model, numRows());
+
+        for (int row = 0; row < boundVars.length; ++row)
+            solver[numCon + row] = model[numCon + boundVars[row]];
+
+        return solver;
+    }
+
+    /**
+     * Converts a vector from the solver layout to the model layout.
+     *
+     * @param solver a vector in the solver layout.
+     * @param model  the vector to receive the values in the model layout.
+     * @param fill   the value for the unbounded variables.
+     */
+    void scatter(double[] solver, double[] model, double fill) {
+        if (isComplete()) {
+            System.arraycopy(solver, 0, model, 0, numRows());
+            return;
+        }
+
+        System.arraycopy(solver, 0, model, 0, numCon);
+        Arrays.fill(model, numCon, numCon + numVar, fill);
+
+        for (int row = 0; row < boundVars.length; ++row)
+            model[numCon + boundVars[row]] = solver[numCon + row];
+    }
+}
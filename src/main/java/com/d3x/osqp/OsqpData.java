@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.LongBuffer;
+
+/**
+ * Holds the data for a quadratic program in off-heap memory, laid out as
+ * OSQP expects it: the linear objective and constraint bounds as dense
+ * vectors, and the quadratic objective (upper triangle) and constraint
+ * matrices in compressed sparse column format.  The native solver reads
+ * the data in place, without copying it out of the Java heap.
+ *
+ * <p>All arrays are stored in one direct buffer with native byte order.
+ * The accessors return views of the underlying storage with independent
+ * positions, which are written and read with absolute or relative puts and
+ * gets.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpData {
+    private final int numVar;
+    private final int numDual;
+    private final int quadObjNnz;
+    private final int linConNnz;
+    private final ByteBuffer buffer;
+
+    private final DoubleBuffer linObjCoeff;
+    private final DoubleBuffer linConLower;
+    private final DoubleBuffer linConUpper;
+    private final LongBuffer   quadObjColPtr;
+    private final LongBuffer   quadObjRowInd;
+    private final DoubleBuffer quadObjCoeff;
+    private final LongBuffer   linConColPtr;
+    private final LongBuffer   linConRowInd;
+    private final DoubleBuffer linConCoeff;
+
+    // Every element (c_int or c_float) occupies eight bytes...
+    private static final int ELEMENT_SIZE = 8;
+
+    private OsqpData(ByteBuffer buffer, int numVar, int numDual, int quadObjNnz, int linConNnz) {
+        if (numVar < 1 || numDual < 0 || quadObjNnz < 0 || linConNnz < 0)
+            throw new IllegalArgumentException("Invalid problem dimensions.");
+
+        if (!buffer.isDirect())
+            throw new IllegalArgumentException("Problem data must be held in a direct buffer.");
+
+        if (buffer.capacity() < byteSize(numVar, numDual, quadObjNnz, linConNnz))
+            throw new IllegalArgumentException("Problem data buffer is too small.");
+
+        this.numVar = numVar;
+        this.numDual = numDual;
+        this.quadObjNnz = quadObjNnz;
+        this.linConNnz = linConNnz;
+        this.buffer = buffer;
+
+        var offset = 0;
+
+        linObjCoeff = slice(offset, numVar).asDoubleBuffer();
+        offset += numVar;
+
+        linConLower = slice(offset, numDual).asDoubleBuffer();
+        offset += numDual;
+
+        linConUpper = slice(offset, numDual).asDoubleBuffer();
+        offset += numDual;
+
+        quadObjColPtr = slice(offset, numVar + 1).asLongBuffer();
+        offset += numVar + 1;
+
+        quadObjRowInd = slice(offset, quadObjNnz).asLongBuffer();
+        offset += quadObjNnz;
+
+        quadObjCoeff = slice(offset, quadObjNnz).asDoubleBuffer();
+        offset += quadObjNnz;
+
+        linConColPtr = slice(offset, numVar + 1).asLongBuffer();
+        offset += numVar + 1;
+
+        linConRowInd = slice(offset, linConNnz).asLongBuffer();
+        offset += linConNnz;
+
+        linConCoeff = slice(offset, linConNnz).asDoubleBuffer();
+    }
+
+    private ByteBuffer slice(int offset, int length) {
+        var view = buffer.duplicate();
+        view.position(offset * ELEMENT_SIZE);
+        view.limit((offset + length) * ELEMENT_SIZE);
+        return view.slice().order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Returns the number of bytes required to hold a quadratic program.
+     *
+     * @param numVar     the number of decision variables.
+     * @param numDual    the number of rows in the constraint matrix.
+     * @param quadObjNnz the number of non-zeros in the quadratic objective.
+     * @param linConNnz  the number of non-zeros in the constraint matrix.
+     *
+     * @return the number of bytes required to hold the problem data.
+     */
+    public static long byteSize(int numVar, int numDual, int quadObjNnz, int linConNnz) {
+        long elements = 3L * numVar + 2L * numDual + 2L + 2L * quadObjNnz + 2L * linConNnz;
+        return ELEMENT_SIZE * elements;
+    }
+
+    /**
+     * Allocates off-heap storage for a quadratic program.
+     *
+     * @param numVar     the number of decision variables.
+     * @param numDual    the number of rows in the constraint matrix.
+     * @param quadObjNnz the number of non-zeros in the quadratic objective.
+     * @param linConNnz  the number of non-zeros in the constraint matrix.
+     *
+     * @return new (zero-filled) storage for the specified problem.
+     */
+    public static OsqpData allocate(int numVar, int numDual, int quadObjNnz, int linConNnz) {
+        var size = byteSize(numVar, numDual, quadObjNnz, linConNnz);
+
+        if (size > Integer.MAX_VALUE)
+            throw new IllegalArgumentException("Problem data exceeds the maximum buffer size.");
+
+        var buffer = ByteBuffer.allocateDirect((int) size);
+        return new OsqpData(buffer, numVar, numDual, quadObjNnz, linConNnz);
+    }
+
+    /**
+     * Wraps existing off-heap storage (for example, a memory-mapped file)
+     * that holds a quadratic program in the layout used by this class.
+     *
+     * @param buffer     a direct buffer holding the problem data, starting
+     *                   at index zero (eight-byte aligned).
+     * @param numVar     the number of decision variables.
+     * @param numDual    the number of rows in the constraint matrix.
+     * @param quadObjNnz the number of non-zeros in the quadratic objective.
+     * @param linConNnz  the number of non-zeros in the constraint matrix.
+     *
+     * @return a view of the problem data held in the buffer.
+     */
+    public static OsqpData wrap(ByteBuffer buffer, int numVar, int numDual, int quadObjNnz, int linConNnz) {
+        return new OsqpData(buffer, numVar, numDual, quadObjNnz, linConNnz);
+    }
+
+    /**
+     * Validates the problem data before it is passed to native code.
+     *
+     * @throws RuntimeException unless the matrices are valid compressed
+     * sparse column matrices with the expected dimensions.
+     */
+    void validate() {
+        validateCsc(quadObjColPtr, quadObjRowInd, numVar, quadObjNnz);
+        validateCsc(linConColPtr, linConRowInd, numDual, linConNnz);
+    }
+
+    private void validateCsc(LongBuffer colptr, LongBuffer rowind, int nrow, int nnz) {
+        if (colptr.get(0) != 0 || colptr.get(numVar) != nnz)
+            throw new IllegalArgumentException("Invalid column pointer range.");
+
+        for (int col = 0; col < numVar; ++col)
+            if (colptr.get(col) > colptr.get(col + 1))
+                throw new IllegalArgumentException("Column pointers must be non-decreasing.");
+
+        for (int index = 0; index < nnz; ++index)
+            if (rowind.get(index) < 0 || rowind.get(index) >= nrow)
+                throw new IllegalArgumentException("Invalid row index.");
+    }
+
+    /**
+     * Returns the buffer that holds all problem data.
+     * @return the buffer that holds all problem data.
+     */
+    public ByteBuffer buffer() {
+        return buffer.duplicate().order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Returns the number of decision variables.
+     * @return the number of decision variables.
+     */
+    public int numVar() {
+        return numVar;
+    }
+
+    /**
+     * Returns the number of rows in the constraint matrix.
+     * @return the number of rows in the constraint matrix.
+     */
+    public int numDual() {
+        return numDual;
+    }
+
+    /**
+     * Returns the number of non-zeros in the quadratic objective matrix.
+     * @return the number of non-zeros in the quadratic objective matrix.
+     */
+    public int quadObjNnz() {
+        return quadObjNnz;
+    }
+
+    /**
+     * Returns the number of non-zeros in the constraint matrix.
+     * @return the number of non-zeros in the constraint matrix.
+     */
+    public int linConNnz() {
+        return linConNnz;
+    }
+
+    /**
+     * Returns the linear objective coefficients (length {@code numVar}).
+     * @return the linear objective coefficients.
+     */
+    public DoubleBuffer linObjCoeff() {
+        return linObjCoeff.duplicate();
+    }
+
+    /**
+     * Returns the lower constraint bounds (length {@code numDual}).
+     * @return the lower constraint bounds.
+     */
+    public DoubleBuffer linConLower() {
+        return linConLower.duplicate();
+    }
+
+    /**
+     * Returns the upper constraint bounds (length {@code numDual}).
+     * @return the upper constraint bounds.
+     */
+    public DoubleBuffer linConUpper() {
+        return linConUpper.duplicate();
+    }
+
+    /**
+     * Returns the column pointers of the quadratic objective matrix
+     * (length {@code numVar + 1}).
+     *
+     * @return the column pointers of the quadratic objective matrix.
+     */
+    public LongBuffer quadObjColPtr() {
+        return quadObjColPtr.duplicate();
+    }
+
+    /**
+     * Returns the row indexes of the quadratic objective matrix
+     * (length {@code quadObjNnz}).
+     *
+     * @return the row indexes of the quadratic objective matrix.
+     */
+    public LongBuffer quadObjRowInd() {
+        return quadObjRowInd.duplicate();
+    }
+
+    /**
+     * Returns the non-zero values of the quadratic objective matrix
+     * (length {@code quadObjNnz}).
+     *
+     * @return the non-zero values of the quadratic objective matrix.
+     */
+    public DoubleBuffer quadObjCoeff() {
+        return quadObjCoeff.duplicate();
+    }
+
+    /**
+     * Returns the column pointers of the constraint matrix (length
+     * {@code numVar + 1}).
+     *
+     * @return the column pointers of the constraint matrix.
+     */
+    public LongBuffer linConColPtr() {
+        return linConColPtr.duplicate();
+    }
+
+    /**
+     * Returns the row indexes of the constraint matrix (length
+     * {@code linConNnz}).
+     *
+     * @return the row indexes of the constraint matrix.
+     */
+    public LongBuffer linConRowInd() {
+        return linConRowInd.duplicate();
+    }
+
+    /**
+     * Returns the non-zero values of the constraint matrix (length
+     * {@code linConNnz}).
+     *
+     * @return the non-zero values of the constraint matrix.
+     */
+    public DoubleBuffer linConCoeff() {
+        return linConCoeff.duplicate();
+    }
+}
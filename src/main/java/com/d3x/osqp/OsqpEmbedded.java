@@ -0,0 +1,500 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.lang.ref.Cleaner;
+import java.nio.file.Path;
+import java.util.Arrays;
+import java.util.Map;
+import java.util.Optional;
+
+/**
+ * Solves a problem with a specialized native library generated for its
+ * dimensions and sparsity pattern by the OSQP code generator.  The library
+ * holds a static workspace that is set up and factored when it is
+ * generated, so a solve performs no setup and no dynamic allocation; only
+ * the linear objective and bound vectors (and, for libraries generated
+ * with {@code EMBEDDED=2}, the matrix values) change between solves.
+ *
+ * <p>A library is generated from a model file (see {@link OsqpModel#save})
+ * by {@code bin/build.sh}, which runs {@code bin/codegen.py} and compiles
+ * the generated code.  It may be used directly, or attached to a model of
+ * the same structure with {@link OsqpModel#setEmbeddedSolver}, which then
+ * solves through it behind the usual API.</p>
+ *
+ * <p>The vectors are in the solver layout (see {@link OsqpModel#toData}).
+ * Each library has a single workspace, so solves through the same library
+ * are serialized, and every instance loaded from the same file shares its
+ * state, including the starting point for the next solve.</p>
+ *
+ * <p>The settings are generated into the library as well.  The libraries
+ * accept new values for the iteration limit, the tolerances, the
+ * relaxation parameter, and the termination and warm start switches (and
+ * for the step size, if generated with {@code EMBEDDED=2}); the other
+ * settings must keep their generated values.  The generated code never
+ * polishes, prints, or stops on a time limit.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpEmbedded implements AutoCloseable {
+    private final Path path;
+    private final int numVar;
+    private final int numDual;
+    private final int mode;
+    private final OsqpMatrix quadObj;
+    private final OsqpMatrix linCon;
+    private final double[] generated;
+    private final Library library;
+    private final Cleaner.Cleanable cleanable;
+
+    // The statistics from the most recent solve, copied by the native
+    // code...
+    private final double[] infoValues = OsqpInfo.newValues();
+    private OsqpInfo info = null;
+
+    // Set when the library is unloaded; every call that would reach the
+    // native code checks it under the lock held by the call...
+    private boolean closed = false;
+
+    // The layout of the dimensions, which must match d3x_embedded.h...
+    private static final int NUM_VAR = 0;
+    private static final int NUM_DUAL = 1;
+    private static final int MODE = 2;
+    private static final int QUAD_NNZ = 3;
+    private static final int LIN_NNZ = 4;
+    private static final int DIM_COUNT = 5;
+
+    // The parameters in the layout of the generated settings, which must
+    // match d3x_embedded.h; the settings from MAX_ITER on are updatable...
+    private static final OsqpParam[] SETTINGS = {
+            OsqpParam.RHO,
+            OsqpParam.SIGMA,
+            OsqpParam.SCALING,
+            OsqpParam.ADAPTIVE_RHO,
+            OsqpParam.ADAPTIVE_RHO_INTERVAL,
+            OsqpParam.ADAPTIVE_RHO_TOLERANCE,
+            OsqpParam.MAX_ITER,
+            OsqpParam.EPS_ABS,
+            OsqpParam.EPS_REL,
+            OsqpParam.EPS_PRIM_INF,
+            OsqpParam.EPS_DUAL_INF,
+            OsqpParam.ALPHA,
+            OsqpParam.SCALED_TERMINATION,
+            OsqpParam.CHECK_TERMINATION,
+            OsqpParam.WARM_START
+    };
+
+    private static final int FIRST_UPDATABLE = 6;
+
+    // The relative tolerance for matrix values that are compared with the
+    // values recovered from the scaled workspace...
+    private static final double VALUE_TOLERANCE = 1.0E-09;
+
+    private static final Cleaner cleaner = Cleaner.create();
+
+    static {
+        System.loadLibrary("osqp");
+        System.loadLibrary("d3x-osqp");
+    }
+
+    // The native handle is held apart from the solver so that the
+    // cleaner action does not keep the solver itself reachable...
+    private static final class Library implements Runnable {
+        private final long handle;
+
+        private Library(long handle) {
+            this.handle = handle;
+        }
+
+        @Override
+        public void run() {
+            unload(handle);
+        }
+    }
+
+    private OsqpEmbedded(Path path, long handle) {
+        var dims = new long[DIM_COUNT];
+        dims(handle, dims);
+
+        var nvar = (int) dims[NUM_VAR];
+        var quadNnz = (int) dims[QUAD_NNZ];
+        var linNnz = (int) dims[LIN_NNZ];
+
+        var quadColPtr = new long[nvar + 1];
+        var quadRowInd = new long[quadNnz];
+        var quadValues = new double[quadNnz];
+        var linColPtr = new long[nvar + 1];
+        var linRowInd = new long[linNnz];
+        var linValues = new double[linNnz];
+        matrices(handle, quadColPtr, quadRowInd, quadValues, linColPtr, linRowInd, linValues);
+
+        var settings = new double[SETTINGS.length];
+        settings(handle, settings);
+
+        this.path = path;
+        this.numVar = nvar;
+        this.numDual = (int) dims[NUM_DUAL];
+        this.mode = (int) dims[MODE];
+        this.quadObj = OsqpMatrix.wrap(nvar, nvar, quadColPtr, quadRowInd, quadValues);
+        this.linCon = OsqpMatrix.wrap(numDual, nvar, linColPtr, linRowInd, linValues);
+        this.generated = settings;
+        this.library = new Library(handle);
+        this.cleanable = cleaner.register(this, library);
+    }
+
+    /**
+     * Loads a specialized solver library.
+     *
+     * @param path the library generated by {@code bin/build.sh}.
+     *
+     * @return the solver implemented by the library.
+     *
+     * @throws IllegalArgumentException unless the file is a specialized
+     * solver library.
+     */
+    public static OsqpEmbedded load(Path path) {
+        var handle = load(path.toAbsolutePath().toString());
+
+        if (handle == 0)
+            throw new IllegalArgumentException("Not a specialized solver library: " + path);
+
+        return new OsqpEmbedded(path, handle);
+    }
+
+    /**
+     * Returns the number of decision variables.
+     * @return the number of decision variables.
+     */
+    public int numVar() {
+        return numVar;
+    }
+
+    /**
+     * Returns the number of constraint rows (in the solver layout).
+     * @return the number of constraint rows.
+     */
+    public int numDual() {
+        return numDual;
+    }
+
+    /**
+     * Identifies libraries generated with {@code EMBEDDED=2}, which accept
+     * new matrix values in the generated sparsity pattern.
+     *
+     * @return {@code true} iff the matrix values may be updated.
+     */
+    public boolean isMatrixUpdatable() {
+        return mode == 2;
+    }
+
+    /**
+     * Determines whether this library can solve a problem with the given
+     * matrices: the sparsity patterns must match and, unless the matrix
+     * values are updatable, the values must match those generated.
+     *
+     * @param quadObj the quadratic objective matrix (upper triangle).
+     * @param linCon  the constraint matrix in the solver layout.
+     *
+     * @return {@code true} iff the matrices may be solved by this library.
+     */
+    boolean accepts(OsqpMatrix quadObj, OsqpMatrix linCon) {
+        return accepts(this.quadObj, this.linCon, isMatrixUpdatable(), quadObj, linCon);
+    }
+
+    /**
+     * Determines whether a library generated with the given matrices can
+     * solve a problem with other matrices.
+     *
+     * @param genQuadObj the generated quadratic objective matrix.
+     * @param genLinCon  the generated constraint matrix.
+     * @param updatable  whether the library accepts new matrix values.
+     * @param quadObj    the quadratic objective matrix (upper triangle).
+     * @param linCon     the constraint matrix in the solver layout.
+     *
+     * @return {@code true} iff the matrices may be solved by the library.
+     */
+    static boolean accepts(OsqpMatrix genQuadObj,
+                           OsqpMatrix genLinCon,
+                           boolean    updatable,
+                           OsqpMatrix quadObj,
+                           OsqpMatrix linCon) {
+        if (!quadObj.hasPattern(genQuadObj) || !linCon.hasPattern(genLinCon))
+            return false;
+        else if (updatable)
+            return true;
+        else
+            return sameValues(quadObj.values, genQuadObj.values) && sameValues(linCon.values, genLinCon.values);
+    }
+
+    private static boolean sameValues(double[] values1, double[] values2) {
+        for (int k = 0; k < values1.length; ++k) {
+            if (!sameValue(values1[k], values2[k]))
+                return false;
+        }
+
+        return true;
+    }
+
+    private static boolean sameValue(double value1, double value2) {
+        var scale = Math.max(1.0, Math.max(Math.abs(value1), Math.abs(value2)));
+        return Math.abs(value1 - value2) <= VALUE_TOLERANCE * scale;
+    }
+
+    /**
+     * Returns the index of a parameter in the layout of the generated
+     * settings.
+     *
+     * @param param the solver parameter.
+     *
+     * @return the index of the parameter, or {@code -1} if the generated
+     * code has no such setting.
+     */
+    static int settingIndex(OsqpParam param) {
+        for (int index = 0; index < SETTINGS.length; ++index)
+            if (SETTINGS[index] == param)
+                return index;
+
+        return -1;
+    }
+
+    /**
+     * Translates solver parameters into the new values for the generated
+     * settings.  Parameters without a generated setting (such as
+     * {@code POLISH}) are ignored, and the others that the library cannot
+     * change must keep their generated values.
+     *
+     * @param params     the assigned solver parameters.
+     * @param generated  the generated settings.
+     * @param rhoUpdates whether the library accepts a new step size.
+     *
+     * @return the new settings, with {@code NaN} for those to keep.
+     *
+     * @throws IllegalStateException if a parameter cannot be applied.
+     */
+    static double[] settingValues(Map<OsqpParam, Double> params, double[] generated, boolean rhoUpdates) {
+        var values = new double[SETTINGS.length];
+        Arrays.fill(values, Double.NaN);
+
+        for (var entry : params.entrySet()) {
+            var param = entry.getKey();
+            var value = entry.getValue();
+
+            if (param == OsqpParam.TIME_LIMIT && value > 0.0)
+                throw new IllegalStateException("Specialized solvers do not support a time limit.");
+
+            var index = settingIndex(param);
+
+            if (index < 0)
+                continue;
+
+            if (index >= FIRST_UPDATABLE || (rhoUpdates && param == OsqpParam.RHO))
+                values[index] = value;
+            else if (!Double.isNaN(generated[index]) && !sameValue(value, generated[index]))
+                throw new IllegalStateException(String.format("Parameter [%s] differs from its generated value.", param));
+        }
+
+        return values;
+    }
+
+    /**
+     * Applies solver parameters to the generated settings (see the class
+     * documentation for those that may change).
+     *
+     * @param params the solver parameters to apply.
+     *
+     * @return {@code true} iff the settings were updated.
+     *
+     * @throws IllegalStateException if a parameter cannot be applied, or
+     * if this instance has been closed.
+     */
+    public synchronized boolean updateSettings(Map<OsqpParam, Double> params) {
+        checkOpen();
+        return updateSettings(library.handle, settingValues(params, generated, isMatrixUpdatable())) == 0;
+    }
+
+    /**
+     * Assigns the matrix values, in the generated sparsity pattern; the
+     * library factors the new KKT matrix.
+     *
+     * @param quadObjValues the quadratic objective values, or {@code null}
+     *                      to keep the current values.
+     * @param linConValues  the constraint matrix values, or {@code null}
+     *                      to keep the current values.
+     *
+     * @return {@code true} iff the update succeeded.
+     *
+     * @throws IllegalStateException unless the library was generated with
+     * {@code EMBEDDED=2}, or if this instance has been closed.
+     */
+    public synchronized boolean updateMatrices(double[] quadObjValues, double[] linConValues) {
+        checkOpen();
+
+        if (!isMatrixUpdatable())
+            throw new IllegalStateException("The library was not generated with EMBEDDED=2: " + path);
+
+        if (quadObjValues != null && quadObjValues.length != quadObj.nnz)
+            throw new IllegalArgumentException("Invalid quadratic objective length.");
+
+        if (linConValues != null && linConValues.length != linCon.nnz)
+            throw new IllegalArgumentException("Invalid constraint matrix length.");
+
+        return updateMatrices(library.handle, quadObjValues, linConValues) == 0;
+    }
+
+    /**
+     * Assigns the starting point for the next solve; by default each solve
+     * starts from the previous solution.
+     *
+     * @param primal the initial primal values, or {@code null}.
+     * @param dual   the initial dual values (solver layout), or {@code null}.
+     *
+     * @return {@code true} iff the starting point was assigned.
+     *
+     * @throws IllegalStateException if this instance has been closed.
+     */
+    public synchronized boolean warmStart(double[] primal, double[] dual) {
+        checkOpen();
+
+        if (primal != null)
+            checkLength(primal, numVar);
+
+        if (dual != null)
+            checkLength(dual, numDual);
+
+        return warmStart(library.handle, primal, dual) == 0;
+    }
+
+    /**
+     * Solves the problem with new vectors.
+     *
+     * @param linObjCoeff the linear objective coefficients, or {@code null}
+     *                    to keep the current coefficients.
+     * @param linConLower the lower bounds (solver layout), or {@code null}
+     *                    to keep the current bounds.
+     * @param linConUpper the upper bounds (solver layout), or {@code null}
+     *                    to keep the current bounds.
+     * @param primal      the array to receive the primal solution.
+     * @param dual        the array to receive the dual solution.
+     *
+     * @return the solution status, or {@code SETUP_ERROR} if the vectors
+     * were rejected.
+     *
+     * @throws IllegalStateException if this instance has been closed.
+     */
+    public synchronized OsqpStatus solve(double[] linObjCoeff,
+                                         double[] linConLower,
+                                         double[] linConUpper,
+                                         double[] primal,
+                                         double[] dual) {
+        checkOpen();
+
+        if (linObjCoeff != null)
+            checkLength(linObjCoeff, numVar);
+
+        if (linConLower != null)
+            checkLength(linConLower, numDual);
+
+        if (linConUpper != null)
+            checkLength(linConUpper, numDual);
+
+        checkLength(primal, numVar);
+        checkLength(dual, numDual);
+
+        Arrays.fill(infoValues, Double.NaN);
+        var code = solve(library.handle, linObjCoeff, linConLower, linConUpper, primal, dual, infoValues);
+        var status = OsqpStatus.valueOf(code);
+
+        info = status != OsqpStatus.SETUP_ERROR ? OsqpInfo.of(infoValues, 0) : null;
+        return status;
+    }
+
+    private static void checkLength(double[] vector, int length) {
+        if (vector.length != length)
+            throw new IllegalArgumentException("Invalid vector length.");
+    }
+
+    /**
+     * Returns the solver statistics from the most recent solve.  The
+     * generated code keeps no timings and does not polish.
+     *
+     * @return the solver statistics, or an empty optional if no solve has
+     * completed.
+     */
+    public synchronized Optional<OsqpInfo> getInfo() {
+        return Optional.ofNullable(info);
+    }
+
+    /**
+     * Unloads the library (when no other instance holds it).  Any later
+     * call that would reach the library throws an exception.
+     */
+    @Override
+    public synchronized void close() {
+        closed = true;
+        cleanable.clean();
+    }
+
+    /**
+     * Identifies a closed instance.
+     *
+     * @return {@code true} iff this instance has been closed.
+     */
+    public synchronized boolean isClosed() {
+        return closed;
+    }
+
+    private void checkOpen() {
+        if (closed)
+            throw new IllegalStateException("The specialized solver has been closed: " + path);
+    }
+
+    @Override
+    public String toString() {
+        return String.format("OsqpEmbedded(%s, numVar = %d, numDual = %d, EMBEDDED = %d)", path, numVar, numDual, mode);
+    }
+
+    private static native long load(String path);
+
+    private static native void dims(long handle, long[] dims);
+
+    private static native void matrices(
+            long     handle,
+            long[]   quadColPtr,
+            long[]   quadRowInd,
+            double[] quadValues,
+            long[]   linColPtr,
+            long[]   linRowInd,
+            double[] linValues);
+
+    private static native int solve(
+            long     handle,
+            double[] linObjCoeff,
+            double[] linConLower,
+            double[] linConUpper,
+            double[] primal,
+            double[] dual,
+            double[] info);
+
+    private static native int warmStart(long handle, double[] primal, double[] dual);
+
+    private static native int updateMatrices(long handle, double[] quadValues, double[] linValues);
+
+    private static native void settings(long handle, double[] values);
+
+    private static native int updateSettings(long handle, double[] values);
+
+    private static native void unload(long handle);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+
+/**
+ * The objective value, primal residual, and bound violations of a primal
+ * point, evaluated by the native code on the problem data held in a solver
+ * workspace.
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpEvaluation {
+    private final double[] values;
+
+    // The layout of the values copied by the native code: the objective
+    // value, the primal residual, and one violation per constraint row...
+    private static final int OBJECTIVE = 0;
+    private static final int PRIMAL_RESIDUAL = 1;
+    private static final int VIOLATIONS = 2;
+
+    private OsqpEvaluation(double[] values) {
+        this.values = values;
+    }
+
+    /**
+     * Creates an evaluation from the values copied by the native code.
+     *
+     * @param values the array holding the native values.
+     *
+     * @return the evaluation stored in the given array.
+     */
+    static OsqpEvaluation of(double[] values) {
+        return new OsqpEvaluation(values);
+    }
+
+    /**
+     * Returns the length of the array that receives the native values.
+     *
+     * @param numDual the number of constraint rows.
+     *
+     * @return the length of the array that receives the native values.
+     */
+    static int size(int numDual) {
+        return VIOLATIONS + numDual;
+    }
+
+    /**
+     * Returns a copy of this evaluation with the violations rearranged in
+     * another row layout.
+     *
+     * @param violations the bound violations in the new layout.
+     *
+     * @return an evaluation with the same objective and residual.
+     */
+    OsqpEvaluation withViolations(double[] violations) {
+        var result = Arrays.copyOf(values, VIOLATIONS + violations.length);
+        System.arraycopy(violations, 0, result, VIOLATIONS, violations.length);
+        return new OsqpEvaluation(result);
+    }
+
+    /**
+     * Returns the objective function value.
+     * @return the objective function value.
+     */
+    public double getObjective() {
+        return values[OBJECTIVE];
+    }
+
+    /**
+     * Returns the primal residual: the largest bound violation in absolute
+     * value.
+     *
+     * @return the primal residual.
+     */
+    public double getPrimalResidual() {
+        return values[PRIMAL_RESIDUAL];
+    }
+
+    /**
+     * Returns the bound violation of each constraint row: the amount by which
+     * the row value exceeds its upper bound (positive) or falls short of its
+     * lower bound (negative), or zero if the bounds are satisfied.  The rows
+     * follow the constraint matrix held by the solver; evaluations returned
+     * by {@link OsqpModel} list the linear constraints followed by every
+     * decision variable (with zero for the unbounded variables).
+     *
+     * @return the bound violation of each constraint row.
+     */
+    public double[] getViolations() {
+        return Arrays.copyOfRange(values, VIOLATIONS, values.length);
+    }
+
+    /**
+     * Returns the bound violation of one constraint row.
+     *
+     * @param row the index of the constraint row.
+     *
+     * @return the bound violation of the specified row.
+     */
+    public double getViolation(int row) {
+        return values[VIOLATIONS + row];
+    }
+
+    @Override
+    public String toString() {
+        return String.format("OsqpEvaluation(obj = %g, pri_res = %g)", getObjective(), getPrimalResidual());
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.Executor;
+import java.util.concurrent.RejectedExecutionException;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.function.Supplier;
+
+/**
+ * Runs asynchronous solves on a fixed set of lanes, each served by a
+ * single daemon thread.  Every model is assigned to one lane when it is
+ * created, so its native workspace is always used by the same thread and
+ * its solves run in submission order without contending for the model
+ * lock.
+ *
+ * <p>Each lane queues a bounded number of solves; when a lane is full, the
+ * submitting thread waits for room in its queue, which throttles producers
+ * that outpace the solvers without running a solve out of order or on
+ * another thread.  A task running on a lane must therefore not submit to
+ * its own full lane and wait for the result.  A submitter interrupted
+ * while waiting receives a {@code RejectedExecutionException}.</p>
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpExecutor {
+    private final Executor[] lanes;
+
+    // Lanes are assigned by a counter that does not depend on the number
+    // of lanes, so that creating a model does not create the executor...
+    private static final AtomicInteger laneCounter = new AtomicInteger();
+
+    /**
+     * The system property that sets the number of lanes.
+     */
+    static final String LANES_PROPERTY = "com.d3x.osqp.asyncThreads";
+
+    // The number of solves that may wait in each lane...
+    private static final int QUEUE_CAPACITY = 256;
+
+    // The shared executor is created on the first asynchronous solve...
+    private static final class Holder {
+        private static final OsqpExecutor shared =
+                new OsqpExecutor(Integer.getInteger(LANES_PROPERTY, Runtime.getRuntime().availableProcessors()));
+    }
+
+    private OsqpExecutor(int laneCount) {
+        if (laneCount < 1)
+            throw new IllegalArgumentException("Number of lanes must be positive.");
+
+        this.lanes = new Executor[laneCount];
+
+        for (int index = 0; index < laneCount; ++index)
+            lanes[index] = createLane(index);
+    }
+
+    private static Executor createLane(int index) {
+        return new ThreadPoolExecutor(
+                1, 1, 0L, TimeUnit.MILLISECONDS,
+                new ArrayBlockingQueue<>(QUEUE_CAPACITY),
+                runnable -> {
+                    var thread = new Thread(runnable, "osqp-solver-" + index);
+                    thread.setDaemon(true);
+                    return thread;
+                },
+                OsqpExecutor::awaitRoom);
+    }
+
+    // Blocks the submitting thread until the lane has room for the task...
+    private static void awaitRoom(Runnable task, ThreadPoolExecutor lane) {
+        try {
+            lane.getQueue().put(task);
+        }
+        catch (InterruptedException ex) {
+            Thread.currentThread().interrupt();
+            throw new RejectedExecutionException("Interrupted while waiting for a solver lane.", ex);
+        }
+    }
+
+    /**
+     * Returns the executor shared by all models.
+     * @return the executor shared by all models.
+     */
+    static OsqpExecutor shared() {
+        return Holder.shared;
+    }
+
+    /**
+     * Assigns a lane to a new model, in round-robin order.
+     * @return the key of the assigned lane.
+     */
+    static int nextLane() {
+        return laneCounter.getAndIncrement();
+    }
+
+    /**
+     * Runs a task on a lane.
+     *
+     * @param <T>  the result type.
+     * @param lane the lane key returned by {@link #nextLane()}.
+     * @param task the task to run.
+     *
+     * @return a future that completes with the result of the task.
+     */
+    <T> CompletableFuture<T> submit(int lane, Supplier<T> task) {
+        return CompletableFuture.supplyAsync(task, lanes[Math.floorMod(lane, lanes.length)]);
+    }
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+
+/**
+ * Statistics reported by the OSQP solver for one solve: the number of
+ * iterations, the final residuals and objective value, the time spent in
+ * each phase, and the step-size adaptation.
+ *
+ * <p>The timings are reported in seconds and are {@code Double.NaN} unless
+ * the native OSQP library was compiled with profiling enabled.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpInfo {
+    private final double[] values;
+
+    // The layout of the statistics copied by the native code, which must
+    // match the indexes defined in d3x_osqp.h...
+    private static final int ITER = 0;
+    private static final int STATUS_VAL = 1;
+    private static final int STATUS_POLISH = 2;
+    private static final int OBJ_VAL = 3;
+    private static final int PRI_RES = 4;
+    private static final int DUA_RES = 5;
+    private static final int SETUP_TIME = 6;
+    private static final int SOLVE_TIME = 7;
+    private static final int UPDATE_TIME = 8;
+    private static final int POLISH_TIME = 9;
+    private static final int RUN_TIME = 10;
+    private static final int RHO_UPDATES = 11;
+    private static final int RHO_ESTIMATE = 12;
+
+    /**
+     * The number of values copied from the native solver.
+     */
+    static final int SIZE = 13;
+
+    private OsqpInfo(double[] values) {
+        this.values = values;
+    }
+
+    /**
+     * Creates solver statistics from values copied by the native code.
+     *
+     * @param values the array holding the native values.
+     * @param offset the index of the first value for this solve.
+     *
+     * @return the solver statistics stored at the given offset.
+     */
+    static OsqpInfo of(double[] values, int offset) {
+        return new OsqpInfo(Arrays.copyOfRange(values, offset, offset + SIZE));
+    }
+
+    /**
+     * Returns a copy of these statistics with a constant added to the
+     * objective value (the contribution of variables removed by presolve).
+     *
+     * @param offset the constant to add to the objective value.
+     *
+     * @return the shifted statistics.
+     */
+    OsqpInfo shiftObjective(double offset) {
+        var shifted = values.clone();
+        shifted[OBJ_VAL] += offset;
+        return new OsqpInfo(shifted);
+    }
+
+    /**
+     * Returns a new array to receive the values copied by the native code.
+     * @return a new array to receive the values copied by the native code.
+     */
+    static double[] newValues() {
+        return newValues(1);
+    }
+
+    /**
+     * Returns a new array to receive the values for several solves.
+     *
+     * @param count the number of solves.
+     *
+     * @return a new array to receive the values for the solves.
+     */
+    static double[] newValues(int count) {
+        var values = new double[count * SIZE];
+        Arrays.fill(values, Double.NaN);
+        return values;
+    }
+
+    /**
+     * Returns the number of ADMM iterations.
+     * @return the number of ADMM iterations.
+     */
+    public int getIterations() {
+        return (int) values[ITER];
+    }
+
+    /**
+     * Returns the solution status.
+     * @return the solution status.
+     */
+    public OsqpStatus getStatus() {
+        return OsqpStatus.valueOf((int) values[STATUS_VAL]);
+    }
+
+    /**
+     * Returns the native polishing status: {@code 1} if the solution was
+     * polished successfully, {@code -1} if polishing failed, and {@code 0}
+     * if it was not performed.
+     *
+     * @return the native polishing status.
+     */
+    public int getPolishStatus() {
+        return (int) values[STATUS_POLISH];
+    }
+
+    /**
+     * Returns the objective value at the solution.
+     * @return the objective value at the solution.
+     */
+    public double getObjectiveValue() {
+        return values[OBJ_VAL];
+    }
+
+    /**
+     * Returns the norm of the primal residual.
+     * @return the norm of the primal residual.
+     */
+    public double getPrimalResidual() {
+        return values[PRI_RES];
+    }
+
+    /**
+     * Returns the norm of the dual residual.
+     * @return the norm of the dual residual.
+     */
+    public double getDualResidual() {
+        return values[DUA_RES];
+    }
+
+    /**
+     * Returns the time spent in setup and factorization, in seconds.
+     * @return the time spent in setup and factorization, in seconds.
+     */
+    public double getSetupTime() {
+        return values[SETUP_TIME];
+    }
+
+    /**
+     * Returns the time spent in the ADMM iterations, in seconds.
+     * @return the time spent in the ADMM iterations, in seconds.
+     */
+    public double getSolveTime() {
+        return values[SOLVE_TIME];
+    }
+
+    /**
+     * Returns the time spent updating the workspace, in seconds.
+     * @return the time spent updating the workspace, in seconds.
+     */
+    public double getUpdateTime() {
+        return values[UPDATE_TIME];
+    }
+
+    /**
+     * Returns the time spent polishing the solution, in seconds.
+     * @return the time spent polishing the solution, in seconds.
+     */
+    public double getPolishTime() {
+        return values[POLISH_TIME];
+    }
+
+    /**
+     * Returns the total time for the solve, in seconds.
+     * @return the total time for the solve, in seconds.
+     */
+    public double getRunTime() {
+        return values[RUN_TIME];
+    }
+
+    /**
+     * Returns the number of step-size (rho) updates.
+     * @return the number of step-size (rho) updates.
+     */
+    public int getRhoUpdates() {
+        return (int) values[RHO_UPDATES];
+    }
+
+    /**
+     * Returns the final estimate of the optimal step size (rho).
+     * @return the final estimate of the optimal step size (rho).
+     */
+    public double getRhoEstimate() {
+        return values[RHO_ESTIMATE];
+    }
+
+    @Override
+    public String toString() {
+        return String.format(
+                "OsqpInfo(status = %s, iter = %d, obj = %g, pri_res = %g, dua_res = %g, " +
+                        "setup = %g, solve = %g, update = %g, polish = %g, run = %g, rho_updates = %d)",
+                getStatus(),
+                getIterations(),
+                getObjectiveValue(),
+                getPrimalResidual(),
+                getDualResidual(),
+                getSetupTime(),
+                getSolveTime(),
+                getUpdateTime(),
+                getPolishTime(),
+                getRunTime(),
+                getRhoUpdates());
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+/**
+ * Enumerates the linear system solvers that OSQP may use for the KKT
+ * system, in the order of the native {@code linsys_solver_type} codes.
+ *
+ * <p>QDLDL is built into OSQP and always available.  The MKL Pardiso
+ * solver is loaded by OSQP at run time from the MKL single dynamic library
+ * ({@code libmkl_rt}); its availability is detected once, when this class
+ * is loaded, and Pardiso factors the KKT matrix on multiple threads.</p>
+ *
+ * @author Scott Shaffer
+ */
+public enum OsqpLinsys {
+    QDLDL,
+    MKL_PARDISO;
+
+    private static final boolean[] available;
+
+    static {
+        System.loadLibrary("osqp");
+        System.loadLibrary("d3x-osqp");
+
+        var solvers = values();
+        available = new boolean[solvers.length];
+
+        for (var solver : solvers)
+            available[solver.ordinal()] = loadNative(solver.getCode());
+    }
+
+    /**
+     * Returns the native {@code linsys_solver_type} code.
+     * @return the native {@code linsys_solver_type} code.
+     */
+    public int getCode() {
+        return ordinal();
+    }
+
+    /**
+     * Identifies solvers that may be loaded in this process.
+     * @return {@code true} iff this solver may be loaded in this process.
+     */
+    public boolean isAvailable() {
+        return available[ordinal()];
+    }
+
+    /**
+     * Sets the number of threads used by MKL, and therefore by the Pardiso
+     * factorization, for workspaces created after this call.  By default,
+     * MKL uses the number of physical cores (or {@code MKL_NUM_THREADS}).
+     *
+     * @param numThreads the number of MKL threads.
+     *
+     * @return {@code true} iff the MKL library was found and updated.
+     */
+    public static boolean setPardisoThreads(int numThreads) {
+        if (numThreads < 1)
+            throw new IllegalArgumentException("Number of threads must be positive.");
+
+        return setMklThreadsNative(numThreads);
+    }
+
+    private static native boolean loadNative(int solverCode);
+
+    private static native boolean setMklThreadsNative(int numThreads);
+}
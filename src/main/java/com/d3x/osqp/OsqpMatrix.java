@@ -15,88 +15,374 @@
  */
 package com.d3x.osqp;
 
-import com.google.common.collect.Table;
+import java.util.Arrays;
 
 /**
- * Encapsulates the <em>unordered triplet</em> representation of a sparse
- * matrix: every non-zero element is encoded with its row index, column
- * index, and value in separate arrays.
+ * Encapsulates the <em>compressed sparse column</em> (CSC) representation
+ * of a sparse matrix: the row indexes and values of the non-zero elements
+ * are stored column by column, with the rows sorted within each column,
+ * and the column pointer array marks the start of each column.  This is
+ * the representation used by OSQP, so the arrays are passed directly to
+ * the native solver.
  *
  * @author Scott Shaffer
  */
 final class OsqpMatrix {
+    final int nrow;
+    final int ncol;
     final int nnz;
+    final long[] colptr;
     final long[] rowind;
-    final long[] colind;
     final double[] values;
 
     // Elements must have a magnitude larger than this threshold
     // to be considered "non-zero"...
     private static final double NON_ZERO_THRESHOLD = 1.0E-15;
 
-    private OsqpMatrix(long[] rowind, long[] colind, double[] values) {
+    private OsqpMatrix(int nrow, int ncol, long[] colptr, long[] rowind, double[] values) {
+        this.nrow = nrow;
+        this.ncol = ncol;
         this.nnz = rowind.length;
+        this.colptr = colptr;
         this.rowind = rowind;
-        this.colind = colind;
         this.values = values;
         validate();
     }
 
     private void validate() {
-        if (rowind.length != nnz)
-            throw new IllegalArgumentException("Invalid row index length.");
+        if (colptr.length != ncol + 1)
+            throw new IllegalArgumentException("Invalid column pointer length.");
 
-        if (colind.length != nnz)
-            throw new IllegalArgumentException("Invalid column index length.");
+        if (colptr[0] != 0 || colptr[ncol] != nnz)
+            throw new IllegalArgumentException("Invalid column pointer range.");
 
         if (values.length != nnz)
             throw new IllegalArgumentException("Invalid element value length.");
 
         for (var index : rowind)
-            if (index < 0)
-                throw new IllegalArgumentException("Negative row index.");
-
-        for (var index : colind)
-            if (index < 0)
-                throw new IllegalArgumentException("Negative column index.");
+            if (index < 0 || index >= nrow)
+                throw new IllegalArgumentException("Invalid row index.");
 
         for (double value : values)
             if (!Double.isFinite(value))
                 throw new IllegalArgumentException("Non-finite element value.");
     }
 
+    /**
+     * Determines whether this matrix has the same shape and non-zero pattern
+     * as another matrix.
+     *
+     * @param that the matrix to compare.
+     *
+     * @return {@code true} iff the matrices have the same non-zero pattern.
+     */
+    boolean hasPattern(OsqpMatrix that) {
+        return this.nrow == that.nrow
+                && this.ncol == that.ncol
+                && Arrays.equals(this.colptr, that.colptr)
+                && Arrays.equals(this.rowind, that.rowind);
+    }
+
+    /**
+     * Appends a row with a single unit element for each of the given
+     * columns, in column order, directly in compressed column form.
+     *
+     * @param cols the columns of the unit elements, in increasing order.
+     *
+     * @return a new matrix with {@code cols.length} additional rows.
+     */
+    OsqpMatrix appendUnitRows(int[] cols) {
+        var extra = cols.length;
+        var newColptr = new long[ncol + 1];
+        var newRowind = new long[nnz + extra];
+        var newValues = new double[nnz + extra];
+
+        var next = 0;
+        var pos = 0;
+
+        for (int col = 0; col < ncol; ++col) {
+            var start = (int) colptr[col];
+            var count = (int) colptr[col + 1] - start;
+
+            System.arraycopy(rowind, start, newRowind, pos, count);
+            System.arraycopy(values, start, newValues, pos, count);
+            pos += count;
+
+            // The new rows follow the existing rows, so the row indexes
+            // remain sorted within each column...
+            if (next < extra && cols[next] == col) {
+                newRowind[pos] = nrow + next;
+                newValues[pos] = 1.0;
+                ++pos;
+                ++next;
+            }
+
+            newColptr[col + 1] = pos;
+        }
+
+        return new OsqpMatrix(nrow + extra, ncol, newColptr, newRowind, newValues);
+    }
+
+    /**
+     * Extracts the submatrix formed by a subset of the rows and columns.
+     * The selected rows and columns keep their relative order, so the row
+     * indexes remain sorted within each column.
+     *
+     * @param rowMap  the new index of each row, or {@code -1} to drop it.
+     * @param newNrow the number of selected rows.
+     * @param colMap  the new index of each column, or {@code -1} to drop it.
+     * @param newNcol the number of selected columns.
+     *
+     * @return the selected submatrix.
+     */
+    OsqpMatrix select(int[] rowMap, int newNrow, int[] colMap, int newNcol) {
+        var newColptr = new long[newNcol + 1];
+        var newRowind = new long[nnz];
+        var newValues = new double[nnz];
+        var pos = 0;
+
+        for (int col = 0; col < ncol; ++col) {
+            var newCol = colMap[col];
+
+            if (newCol < 0)
+                continue;
+
+            var end = (int) colptr[col + 1];
+
+            for (int k = (int) colptr[col]; k < end; ++k) {
+                var newRow = rowMap[(int) rowind[k]];
+
+                if (newRow >= 0) {
+                    newRowind[pos] = newRow;
+                    newValues[pos] = values[k];
+                    ++pos;
+                }
+            }
+
+            newColptr[newCol + 1] = pos;
+        }
+
+        return new OsqpMatrix(newNrow, newNcol, newColptr, Arrays.copyOf(newRowind, pos), Arrays.copyOf(newValues, pos));
+    }
+
+    /**
+     * Computes the matrix-vector product {@code A * x} in one pass over the
+     * columns.
+     *
+     * @param x the vector to multiply (of length {@code ncol}).
+     *
+     * @return the product vector (of length {@code nrow}).
+     */
+    double[] multiply(double[] x) {
+        var y = new double[nrow];
+
+        for (int col = 0; col < ncol; ++col) {
+            var xcol = x[col];
+
+            if (xcol == 0.0)
+                continue;
+
+            var end = (int) colptr[col + 1];
+
+            for (int k = (int) colptr[col]; k < end; ++k)
+                y[(int) rowind[k]] += values[k] * xcol;
+        }
+
+        return y;
+    }
+
+    /**
+     * Computes the matrix-vector product {@code A' * y} in one pass over the
+     * columns.
+     *
+     * @param y the vector to multiply (of length {@code nrow}).
+     *
+     * @return the product vector (of length {@code ncol}).
+     */
+    double[] multiplyTranspose(double[] y) {
+        var x = new double[ncol];
+
+        for (int col = 0; col < ncol; ++col) {
+            var dot = 0.0;
+            var end = (int) colptr[col + 1];
+
+            for (int k = (int) colptr[col]; k < end; ++k)
+                dot += values[k] * y[(int) rowind[k]];
+
+            x[col] = dot;
+        }
+
+        return x;
+    }
+
+    /**
+     * Computes the matrix-vector product {@code P * x} for a symmetric
+     * matrix {@code P} whose upper triangle is stored in this matrix.
+     *
+     * @param x the vector to multiply (of length {@code ncol}).
+     *
+     * @return the product vector (of length {@code ncol}).
+     */
+    double[] multiplySymmetric(double[] x) {
+        var y = new double[ncol];
+
+        for (int col = 0; col < ncol; ++col) {
+            var end = (int) colptr[col + 1];
+
+            for (int k = (int) colptr[col]; k < end; ++k) {
+                var row = (int) rowind[k];
+                y[row] += values[k] * x[col];
+
+                if (row != col)
+                    y[col] += values[k] * x[row];
+            }
+        }
+
+        return y;
+    }
+
+    /**
+     * Computes the quadratic form {@code (1/2) x' * P * x} for a symmetric
+     * matrix {@code P} whose upper triangle is stored in this matrix.
+     *
+     * @param x the vector at which to evaluate the quadratic form.
+     *
+     * @return the value of the quadratic form.
+     */
+    double quadraticForm(double[] x) {
+        var total = 0.0;
+
+        for (int col = 0; col < ncol; ++col) {
+            var start = (int) colptr[col];
+            var end = (int) colptr[col + 1];
+
+            if (start == end)
+                continue;
+
+            var dot = 0.0;
+
+            for (int k = start; k < end; ++k)
+                dot += values[k] * x[(int) rowind[k]];
+
+            // The rows are sorted, so the diagonal element (if any) comes
+            // last and is counted once rather than twice...
+            if (rowind[end - 1] == col)
+                dot -= 0.5 * values[end - 1] * x[col];
+
+            total += dot * x[col];
+        }
+
+        return total;
+    }
+
+    /**
+     * Wraps arrays that already hold a compressed sparse column matrix,
+     * with the rows sorted within each column.
+     *
+     * @param nrow   the number of rows in the matrix.
+     * @param ncol   the number of columns in the matrix.
+     * @param colptr the column pointers (of length {@code ncol + 1}).
+     * @param rowind the row indexes of the non-zero elements.
+     * @param values the values of the non-zero elements.
+     *
+     * @return a sparse matrix backed by the given arrays.
+     *
+     * @throws IllegalArgumentException unless the arrays are consistent.
+     */
+    static OsqpMatrix wrap(int nrow, int ncol, long[] colptr, long[] rowind, double[] values) {
+        return new OsqpMatrix(nrow, ncol, colptr, rowind, values);
+    }
+
     /**
      * Builds a sparse matrix representation from its non-zero elements.
      *
-     * @param elements a table containing the non-zero matrix elements.
+     * @param elements the accumulated matrix elements.
      *
-     * @return a sparse matrix representation build from the given table.
+     * @return a sparse matrix representation built from the given elements.
      */
-    static OsqpMatrix build(Table<Integer, Integer, Double> elements) {
-        var nnz = elements.size();
-
-        var ivec = new long[nnz];
-        var jvec = new long[nnz];
-        var xvec = new double[nnz];
-        var triplet = 0;
-
-        for (var element : elements.cellSet()) {
-            var i = element.getRowKey();
-            var j = element.getColumnKey();
-            var x = element.getValue();
-
-            assert i != null;
-            assert j != null;
-            assert x != null;
-
-            if (Math.abs(x) > NON_ZERO_THRESHOLD) {
-                ivec[triplet] = i;
-                jvec[triplet] = j;
-                xvec[triplet] = x;
-                ++triplet;
+    static OsqpMatrix build(OsqpMatrixBuilder elements) {
+        return build(
+                elements.nrow(),
+                elements.ncol(),
+                elements.size(),
+                elements.rows(),
+                elements.cols(),
+                elements.values());
+    }
+
+    /**
+     * Builds a sparse matrix representation from unordered triplets: the
+     * triplets are sorted by column and by row within each column, elements
+     * at the same position are summed, and (nearly) zero elements are
+     * removed.
+     *
+     * @param nrow the number of rows in the matrix.
+     * @param ncol the number of columns in the matrix.
+     * @param size the number of triplets to read from the arrays.
+     * @param rows the row indexes of the triplets.
+     * @param cols the column indexes of the triplets.
+     * @param vals the element values of the triplets.
+     *
+     * @return a sparse matrix representation built from the given triplets.
+     */
+    static OsqpMatrix build(int nrow, int ncol, int size, int[] rows, int[] cols, double[] vals) {
+        // Two stable counting sorts, first by row and then by column,
+        // leave the triplets in column-major order...
+        var rowStart = new int[nrow + 1];
+        var colStart = new int[ncol + 1];
+
+        for (int slot = 0; slot < size; ++slot) {
+            ++rowStart[rows[slot] + 1];
+            ++colStart[cols[slot] + 1];
+        }
+
+        cumulate(rowStart);
+        cumulate(colStart);
+
+        var byRow = new int[size];
+        var byCol = new int[size];
+
+        for (int slot = 0; slot < size; ++slot)
+            byRow[rowStart[rows[slot]]++] = slot;
+
+        for (var slot : byRow)
+            byCol[colStart[cols[slot]]++] = slot;
+
+        // Sum the duplicates, which are now adjacent, and count the
+        // non-zero elements in each column...
+        var colptr = new long[ncol + 1];
+        var rowind = new long[size];
+        var values = new double[size];
+        var nnz = 0;
+
+        var next = 0;
+
+        while (next < size) {
+            var row = rows[byCol[next]];
+            var col = cols[byCol[next]];
+            var sum = 0.0;
+
+            while (next < size && rows[byCol[next]] == row && cols[byCol[next]] == col) {
+                sum += vals[byCol[next]];
+                ++next;
+            }
+
+            if (Math.abs(sum) > NON_ZERO_THRESHOLD) {
+                rowind[nnz] = row;
+                values[nnz] = sum;
+                ++colptr[col + 1];
+                ++nnz;
             }
         }
 
-        return new OsqpMatrix(ivec, jvec, xvec);
+        for (int col = 0; col < ncol; ++col)
+            colptr[col + 1] += colptr[col];
+
+        return new OsqpMatrix(nrow, ncol, colptr, Arrays.copyOf(rowind, nnz), Arrays.copyOf(values, nnz));
+    }
+
+    private static void cumulate(int[] counts) {
+        for (int index = 1; index < counts.length; ++index)
+            counts[index] += counts[index - 1];
     }
 }
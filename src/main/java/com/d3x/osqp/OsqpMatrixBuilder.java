@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+
+/**
+ * Accumulates the elements of a sparse matrix in primitive arrays: the row
+ * index, column index, and value of each element are appended to growable
+ * arrays, and an open-addressing hash index locates existing elements so
+ * that assignments to the same position replace the previous value.
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpMatrixBuilder {
+    private final int nrow;
+    private final int ncol;
+
+    private int size = 0;
+    private int[] rows;
+    private int[] cols;
+    private double[] values;
+
+    // The hash index maps the linear position (row * ncol + col) of each
+    // element to its slot in the element arrays...
+    private long[] hashKeys;
+    private int[] hashSlots;
+
+    private static final long EMPTY_KEY = -1L;
+    private static final int INITIAL_CAPACITY = 16;
+
+    OsqpMatrixBuilder(int nrow, int ncol) {
+        this.nrow = nrow;
+        this.ncol = ncol;
+        this.rows = new int[INITIAL_CAPACITY];
+        this.cols = new int[INITIAL_CAPACITY];
+        this.values = new double[INITIAL_CAPACITY];
+        allocateIndex(2 * INITIAL_CAPACITY);
+    }
+
+    private void allocateIndex(int hashCapacity) {
+        hashKeys = new long[hashCapacity];
+        hashSlots = new int[hashCapacity];
+        Arrays.fill(hashKeys, EMPTY_KEY);
+    }
+
+    private long key(int row, int col) {
+        return (long) row * ncol + col;
+    }
+
+    private int hash(long key) {
+        // Fibonacci hashing spreads the consecutive positions in a row
+        // or column across the whole table...
+        var mixed = key * 0x9E3779B97F4A7C15L;
+        return (int) (mixed ^ (mixed >>> 32)) & (hashKeys.length - 1);
+    }
+
+    private int findSlot(long key) {
+        var mask = hashKeys.length - 1;
+
+        for (int bucket = hash(key); ; bucket = (bucket + 1) & mask) {
+            if (hashKeys[bucket] == key)
+                return hashSlots[bucket];
+
+            if (hashKeys[bucket] == EMPTY_KEY)
+                return -1;
+        }
+    }
+
+    private void insertIndex(long key, int slot) {
+        var mask = hashKeys.length - 1;
+        var bucket = hash(key);
+
+        while (hashKeys[bucket] != EMPTY_KEY)
+            bucket = (bucket + 1) & mask;
+
+        hashKeys[bucket] = key;
+        hashSlots[bucket] = slot;
+    }
+
+    private void ensureCapacity(int capacity) {
+        if (capacity > rows.length) {
+            var length = Math.max(capacity, 2 * rows.length);
+            rows = Arrays.copyOf(rows, length);
+            cols = Arrays.copyOf(cols, length);
+            values = Arrays.copyOf(values, length);
+        }
+
+        // Keep the hash index at most half full...
+        if (2 * capacity > hashKeys.length) {
+            allocateIndex(Integer.highestOneBit(4 * capacity - 1));
+
+            for (int slot = 0; slot < size; ++slot)
+                insertIndex(key(rows[slot], cols[slot]), slot);
+        }
+    }
+
+    /**
+     * Returns the number of rows in the matrix.
+     * @return the number of rows in the matrix.
+     */
+    int nrow() {
+        return nrow;
+    }
+
+    /**
+     * Returns the number of columns in the matrix.
+     * @return the number of columns in the matrix.
+     */
+    int ncol() {
+        return ncol;
+    }
+
+    /**
+     * Returns the number of elements that have been assigned.
+     * @return the number of elements that have been assigned.
+     */
+    int size() {
+        return size;
+    }
+
+    /**
+     * Returns the row indexes of the assigned elements (the internal array,
+     * whose first {@code size()} entries are valid).
+     *
+     * @return the row indexes of the assigned elements.
+     */
+    int[] rows() {
+        return rows;
+    }
+
+    /**
+     * Returns the column indexes of the assigned elements (the internal
+     * array, whose first {@code size()} entries are valid).
+     *
+     * @return the column indexes of the assigned elements.
+     */
+    int[] cols() {
+        return cols;
+    }
+
+    /**
+     * Returns the values of the assigned elements (the internal array, whose
+     * first {@code size()} entries are valid).
+     *
+     * @return the values of the assigned elements.
+     */
+    double[] values() {
+        return values;
+    }
+
+    /**
+     * Returns the row index of an assigned element.
+     *
+     * @param slot the slot of the element, in the range {@code [0, size())}.
+     *
+     * @return the row index of the element in the given slot.
+     */
+    int row(int slot) {
+        return rows[slot];
+    }
+
+    /**
+     * Returns the column index of an assigned element.
+     *
+     * @param slot the slot of the element, in the range {@code [0, size())}.
+     *
+     * @return the column index of the element in the given slot.
+     */
+    int col(int slot) {
+        return cols[slot];
+    }
+
+    /**
+     * Returns the value of an assigned element.
+     *
+     * @param slot the slot of the element, in the range {@code [0, size())}.
+     *
+     * @return the value of the element in the given slot.
+     */
+    double value(int slot) {
+        return values[slot];
+    }
+
+    /**
+     * Assigns the value of a matrix element.
+     *
+     * @param row   the zero-based row index of the element.
+     * @param col   the zero-based column index of the element.
+     * @param value the value to assign.
+     *
+     * @return {@code true} if the element had not been assigned before,
+     * {@code false} if its previous value was replaced.
+     */
+    boolean put(int row, int col, double value) {
+        ensureCapacity(size + 1);
+        return putReserved(row, col, value);
+    }
+
+    /**
+     * Assigns the values of many matrix elements, reserving the storage for
+     * all of them at once.
+     *
+     * @param count     the number of elements to assign.
+     * @param rows      the zero-based row indexes, relative to the offset.
+     * @param cols      the zero-based column indexes.
+     * @param values    the values to assign.
+     * @param rowOffset the offset added to every row index.
+     *
+     * @return {@code true} if any element had not been assigned before.
+     */
+    boolean putAll(int count, int[] rows, int[] cols, double[] values, int rowOffset) {
+        ensureCapacity(size + count);
+
+        var added = false;
+
+        for (int k = 0; k < count; ++k)
+            added |= putReserved(rows[k] + rowOffset, cols[k], values[k]);
+
+        return added;
+    }
+
+    /**
+     * Assigns the values of the elements of a compressed sparse column
+     * block, reserving the storage for all of them at once.
+     *
+     * @param colptr    the column pointers of the block (one column for each
+     *                  column of this matrix).
+     * @param rowind    the row indexes of the block.
+     * @param values    the values of the block.
+     * @param rowOffset the row in this matrix of the first block row.
+     *
+     * @return {@code true} if any element had not been assigned before.
+     */
+    boolean putColumns(int[] colptr, int[] rowind, double[] values, int rowOffset) {
+        ensureCapacity(size + colptr[ncol]);
+
+        var added = false;
+
+        for (int col = 0; col < ncol; ++col)
+            for (int k = colptr[col]; k < colptr[col + 1]; ++k)
+                added |= putReserved(rowind[k] + rowOffset, col, values[k]);
+
+        return added;
+    }
+
+    // Assigns one element after the caller has reserved the storage...
+    private boolean putReserved(int row, int col, double value) {
+        var key = key(row, col);
+        var slot = findSlot(key);
+
+        if (slot >= 0) {
+            values[slot] = value;
+            return false;
+        }
+
+        insertIndex(key, size);
+
+        rows[size] = row;
+        cols[size] = col;
+        values[size] = value;
+        ++size;
+
+        return true;
+    }
+}
@@ -15,20 +15,27 @@
  */
 package com.d3x.osqp;
 
+import java.io.UncheckedIOException;
+import java.nio.file.Path;
+import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.EnumMap;
+import java.util.List;
 import java.util.Map;
 import java.util.Optional;
-
-import com.google.common.collect.Table;
-import com.google.common.collect.HashBasedTable;
+import java.util.concurrent.CompletableFuture;
 
 /**
  * Represents and solves quadratic programs using the OSQP solver.
+ *
+ * <p>The native solver workspace persists between calls to {@code solve()}
+ * until the model is modified, so repeated solves skip the problem setup.
+ * Call {@code close()} to release the workspace when the model is no longer
+ * needed.</p>
  * 
  * @author Scott Shaffer
  */
-public final class OsqpModel {
+public final class OsqpModel implements AutoCloseable {
     private final int numVar;
     private final int numCon;
     private final int numDual;
@@ -40,24 +47,85 @@ public final class OsqpModel {
     private final double[] linConLower;
     private final double[] linConUpper;
 
+    private final OsqpMatrixBuilder linConCoeff;
+    private final OsqpMatrixBuilder quadObjCoeff;
     private final Map<OsqpParam, Double> params = new EnumMap<>(OsqpParam.class);
-    private final Table<Integer, Integer, Double> linConCoeff = HashBasedTable.create();
-    private final Table<Integer, Integer, Double> quadObjCoeff = HashBasedTable.create();
+    private final Map<OsqpParam, Double> paramUpdates = new EnumMap<>(OsqpParam.class);
 
     private OsqpStatus status = OsqpStatus.UNSOLVED;
+    private OsqpInfo info = null;
+
+    // The snapshot of the current solution, created on first request and
+    // discarded whenever the status changes...
+    private OsqpSolution solution = null;
     private Optional<String> logFile = Optional.empty();
 
+    // The native workspace from the most recent setup, or null if the
+    // model structure has been modified since then; volatile so that
+    // cancel() may read it without waiting for the solve to finish...
+    private volatile OsqpSolver solver = null;
+
+    // The matrices most recently sent to the native workspace...
+    private OsqpMatrix linConMatrix = null;
+    private OsqpMatrix quadObjMatrix = null;
+
+    // The matrices built from the current coefficients, or null if a
+    // coefficient has been assigned since they were built: the linear
+    // constraints alone, and with the variable bound rows appended...
+    private OsqpMatrix conCoeffCache = null;
+    private OsqpMatrix linConCache = null;
+    private OsqpMatrix quadObjCache = null;
+
+    // The rows given to the bounded variables, or null if a variable has
+    // become bounded or unbounded since the mapping was built...
+    private OsqpBoundRows boundRowsCache = null;
+
+    // Explicit starting point for the next solve, if any...
+    private double[] warmPrimal = null;
+    private double[] warmDual = null;
+
+    // Whether to start from the previous solution automatically, whether
+    // optPrimal and optDual hold a solution to start from, and whether the
+    // workspace holds the iterate of a donor model instead...
+    private boolean autoWarmStart = true;
+    private boolean warmStartReady = false;
+    private boolean donorIterate = false;
+
+    // Whether a solve may be stopped by cancel()...
+    private boolean cancellable = false;
+
+    // Whether to reduce the problem before the native setup, and the
+    // reduction of the problem held in the native workspace (or sent to
+    // the last batch), or null if the full problem was sent...
+    private boolean presolve = false;
+    private OsqpPresolve presolved = null;
+
+    // The precision of the native workspace...
+    private OsqpPrecision precision = OsqpPrecision.DOUBLE;
+
+    // The specialized solver library that solves this model, if any, and
+    // the matrices and parameters most recently sent to it...
+    private OsqpEmbedded embedded = null;
+    private OsqpMatrix embeddedLinCon = null;
+    private OsqpMatrix embeddedQuadObj = null;
+    private Map<OsqpParam, Double> embeddedParams = null;
+
+    // The executor lane that runs the asynchronous solves of this model...
+    private final int lane = OsqpExecutor.nextLane();
+
+    // Data modified since it was last sent to the native workspace...
+    private boolean linObjDirty = false;
+    private boolean linConDirty = false;
+    private boolean quadObjDirty = false;
+    private boolean linConLowerDirty = false;
+    private boolean linConUpperDirty = false;
+
     // The value to use for "unbounded" bounds...
     private static final double MAX_BOUND = 1.0E+20;
 
     // The feasibility tolerance...
     private static final double TOLERANCE = 1.0E-12;
 
-    static {
-        System.loadLibrary("osqp");
-        System.loadLibrary("d3x-osqp");
-    }
-    
     private OsqpModel(int numVar, int numCon) {
         if (numVar < 1)
             throw new IllegalArgumentException("Number of variables must be positive.");
@@ -69,7 +137,8 @@ public final class OsqpModel {
         this.numCon = numCon;
 
         // Variable bounds are encoded as linear constraints after the
-        // user-defined linear constraints...
+        // user-defined linear constraints; the native solver receives
+        // rows only for the bounded variables...
         numDual = numCon + numVar;
         optDual = new double[numDual];
         optPrimal = new double[numVar];
@@ -78,6 +147,9 @@ public final class OsqpModel {
         linConLower = new double[numDual];
         linConUpper = new double[numDual];
 
+        linConCoeff = new OsqpMatrixBuilder(numCon, numVar);
+        quadObjCoeff = new OsqpMatrixBuilder(numVar, numVar);
+
         Arrays.fill(optDual, Double.NaN);
         Arrays.fill(optPrimal, Double.NaN);
         Arrays.fill(linConLower, -MAX_BOUND);
@@ -86,9 +158,41 @@ public final class OsqpModel {
 
     private OsqpModel reset() {
         status = OsqpStatus.UNSOLVED;
+        solution = null;
+        releaseSolver();
+        return this;
+    }
+
+    // Invalidates the current solution but keeps the native workspace,
+    // whose dirty vectors are updated before the next solve...
+    private OsqpModel invalidate() {
+        status = OsqpStatus.UNSOLVED;
+        solution = null;
         return this;
     }
 
+    private void assignBound(int boundIndex, double lower, double upper) {
+        if (linConLower[boundIndex] != lower) {
+            linConLower[boundIndex] = lower;
+            linConLowerDirty = true;
+        }
+
+        if (linConUpper[boundIndex] != upper) {
+            linConUpper[boundIndex] = upper;
+            linConUpperDirty = true;
+        }
+    }
+
+    private synchronized void releaseSolver() {
+        if (solver != null) {
+            solver.close();
+            solver = null;
+        }
+
+        // The reduction maps the solution of the released workspace only...
+        presolved = null;
+    }
+
     private void validateVariableIndex(int index) {
         if (index < 0 || index >= numVar)
             throw new IllegalArgumentException("Invalid variable index.");
@@ -109,9 +213,13 @@ public final class OsqpModel {
             throw new IllegalArgumentException("Coefficients must be finite.");
     }
 
+    private boolean isBounded(int boundIndex) {
+        return OsqpBoundRows.isBounded(linConLower[boundIndex], linConUpper[boundIndex], MAX_BOUND);
+    }
+
     private int variableBoundIndex(int varIndex) {
-        // The variable bounds are rows in the constraint matrix
-        // after all other linear constraints...
+        // The variable bounds follow the linear constraints in the bound
+        // and dual vectors (see OsqpBoundRows for the native layout)...
         return numCon + varIndex;
     }
 
@@ -119,7 +227,21 @@ public final class OsqpModel {
         if (primal.length != numVar)
             throw new IllegalArgumentException("Invalid primal vector length.");
     }
+
+    private void validateDual(double[] dual) {
+        if (dual.length != numDual)
+            throw new IllegalArgumentException("Invalid dual vector length.");
+    }
     
+    /**
+     * Releases the native solver workspace held by this model.  The model
+     * remains usable: the next call to {@code solve()} creates a new one.
+     */
+    @Override
+    public void close() {
+        releaseSolver();
+    }
+
     /**
      * Creates a new quadratic program with a fixed problem size.
      * 
@@ -133,6 +255,210 @@ public final class OsqpModel {
         return new OsqpModel(numVar, numCon);
     }
 
+    /**
+     * Creates a quadratic program whose quadratic objective matrix has the
+     * factor structure {@code P = D + B F B'}, without forming {@code P}.
+     * The model is lifted into standard sparse form: one auxiliary decision
+     * variable {@code y = B'x} is appended for each factor, with one
+     * equality constraint defining it, and the quadratic objective becomes
+     * {@code blkdiag(D, F)}.  The quadratic objective then has
+     * {@code O(n + k^2)} non-zeros rather than {@code O(n^2)}.
+     *
+     * <p>The original variables and constraints keep their indexes; the
+     * factor exposures are the variables {@code numVar} through
+     * {@code numVar + numFactor - 1}, and their defining constraints follow
+     * the {@code numCon} linear constraints.  The exposures are unbounded
+     * unless bounds are assigned to them, and their defining constraints
+     * should not be modified.</p>
+     *
+     * @param numVar    the number of original decision variables.
+     * @param numCon    the number of original linear constraints.
+     * @param diagonal  the diagonal matrix {@code D} (length {@code numVar}).
+     * @param loadings  the factor loadings {@code B} ({@code numVar} rows of
+     *                  length {@code numFactor}).
+     * @param factorCov the symmetric factor matrix {@code F} ({@code numFactor}
+     *                  rows of length {@code numFactor}); only the upper
+     *                  triangle is read.
+     *
+     * @return a new lifted quadratic program.
+     *
+     * @throws RuntimeException unless the dimensions and coefficients are
+     * valid.
+     */
+    public static OsqpModel createFactor(int numVar, int numCon, double[] diagonal, double[][] loadings, double[][] factorCov) {
+        var numFactor = factorCov.length;
+
+        if (diagonal.length != numVar || loadings.length != numVar)
+            throw new IllegalArgumentException("Invalid factor model dimensions.");
+
+        for (var row : loadings)
+            if (row.length != numFactor)
+                throw new IllegalArgumentException("Invalid factor model dimensions.");
+
+        for (var row : factorCov)
+            if (row.length != numFactor)
+                throw new IllegalArgumentException("Invalid factor model dimensions.");
+
+        var model = create(numVar + numFactor, numCon + numFactor);
+
+        // The quadratic objective is blkdiag(D, F), upper triangle only...
+        var quadSize = numVar + numFactor * (numFactor + 1) / 2;
+        var quadRows = new int[quadSize];
+        var quadCols = new int[quadSize];
+        var quadCoeffs = new double[quadSize];
+        var quadCount = 0;
+
+        for (int var = 0; var < numVar; ++var) {
+            quadRows[quadCount] = var;
+            quadCols[quadCount] = var;
+            quadCoeffs[quadCount] = diagonal[var];
+            ++quadCount;
+        }
+
+        for (int col = 0; col < numFactor; ++col) {
+            for (int row = 0; row <= col; ++row) {
+                quadRows[quadCount] = numVar + row;
+                quadCols[quadCount] = numVar + col;
+                quadCoeffs[quadCount] = factorCov[row][col];
+                ++quadCount;
+            }
+        }
+
+        // The exposure y_f is defined by the equality sum_i B_if x_i - y_f = 0;
+        // the non-zero loadings are assigned in one block...
+        var colptr = new int[numVar + numFactor + 1];
+        var rowind = new int[numVar * numFactor + numFactor];
+        var coeffs = new double[rowind.length];
+        var count = 0;
+
+        for (int var = 0; var < numVar; ++var) {
+            for (int factor = 0; factor < numFactor; ++factor) {
+                if (loadings[var][factor] != 0.0) {
+                    rowind[count] = factor;
+                    coeffs[count] = loadings[var][factor];
+                    ++count;
+                }
+            }
+
+            colptr[var + 1] = count;
+        }
+
+        for (int factor = 0; factor < numFactor; ++factor) {
+            rowind[count] = factor;
+            coeffs[count] = -1.0;
+            ++count;
+            colptr[numVar + factor + 1] = count;
+        }
+
+        var lower = new double[numCon + numFactor];
+        var upper = new double[numCon + numFactor];
+
+        Arrays.fill(lower, 0, numCon, -MAX_BOUND);
+        Arrays.fill(upper, 0, numCon, +MAX_BOUND);
+
+        return model
+                .setQuadraticObjective(quadRows, quadCols, quadCoeffs)
+                .setConstraintBlock(numCon, colptr, rowind, coeffs)
+                .setConstraintBounds(lower, upper);
+    }
+
+    /**
+     * Loads a quadratic program from a binary model file.
+     *
+     * @param path the file written by {@link #save(Path)}.
+     *
+     * @return a new model holding the stored problem and parameters.
+     *
+     * @throws UncheckedIOException if the file cannot be read.
+     * @throws RuntimeException if the file is not a valid model file.
+     */
+    public static OsqpModel load(Path path) {
+        return OsqpModelFile.map(path).toModel();
+    }
+
+    /**
+     * Creates a model from problem data in the solver layout.
+     *
+     * @param numCon the number of linear constraints.
+     * @param data   the problem data, with the bounded variable rows after
+     *               the linear constraints.
+     * @param params the solver parameters to assign.
+     *
+     * @return a new model holding the problem.
+     *
+     * @throws RuntimeException unless each row after the linear constraints
+     * is a unit row for a distinct variable.
+     */
+    static OsqpModel fromData(int numCon, OsqpData data, Map<OsqpParam, Double> params) {
+        var model = new OsqpModel(data.numVar(), numCon);
+        var numVar = model.numVar;
+        var lower = new double[data.numDual()];
+        var upper = new double[data.numDual()];
+
+        data.linObjCoeff().get(model.linObjCoeff);
+        data.linConLower().get(lower);
+        data.linConUpper().get(upper);
+
+        var quadObjColPtr = data.quadObjColPtr();
+        var quadObjRowInd = data.quadObjRowInd();
+        var quadObjCoeff = data.quadObjCoeff();
+
+        for (int col = 0; col < numVar; ++col)
+            for (var k = (int) quadObjColPtr.get(col); k < quadObjColPtr.get(col + 1); ++k)
+                model.quadObjCoeff.put((int) quadObjRowInd.get(k), col, quadObjCoeff.get(k));
+
+        // The rows after the linear constraints hold the variable bounds;
+        // each has a single unit coefficient on its variable...
+        var boundVars = new int[data.numDual() - numCon];
+        Arrays.fill(boundVars, -1);
+
+        var linConColPtr = data.linConColPtr();
+        var linConRowInd = data.linConRowInd();
+        var linConCoeff = data.linConCoeff();
+
+        for (int col = 0; col < numVar; ++col) {
+            for (var k = (int) linConColPtr.get(col); k < linConColPtr.get(col + 1); ++k) {
+                var row = (int) linConRowInd.get(k);
+
+                if (row < numCon) {
+                    model.linConCoeff.put(row, col, linConCoeff.get(k));
+                }
+                else if (boundVars[row - numCon] < 0 && linConCoeff.get(k) == 1.0) {
+                    boundVars[row - numCon] = col;
+                }
+                else {
+                    throw new IllegalArgumentException("Invalid variable bound row.");
+                }
+            }
+        }
+
+        System.arraycopy(lower, 0, model.linConLower, 0, numCon);
+        System.arraycopy(upper, 0, model.linConUpper, 0, numCon);
+
+        for (int row = 0; row < boundVars.length; ++row) {
+            if (boundVars[row] < 0)
+                throw new IllegalArgumentException("Invalid variable bound row.");
+
+            model.linConLower[model.variableBoundIndex(boundVars[row])] = lower[numCon + row];
+            model.linConUpper[model.variableBoundIndex(boundVars[row])] = upper[numCon + row];
+        }
+
+        model.params.putAll(params);
+        return model;
+    }
+
+    /**
+     * Writes this quadratic program and its solver parameters to a binary
+     * model file (see {@link OsqpModelFile}) with sequential writes.
+     *
+     * @param path the file to create or replace.
+     *
+     * @throws UncheckedIOException if the file cannot be written.
+     */
+    public synchronized void save(Path path) {
+        OsqpModelFile.write(path, numCon, toData(), params);
+    }
+
     /**
      * Returns the number of linear constraints in this quadratic program
      * (excluding the decision variable bounds).
@@ -173,29 +499,7 @@ public final class OsqpModel {
     }
 
     private double evaluateQuadratic(double... primal) {
-        var total = 0.0;
-
-        for (var cell : quadObjCoeff.cellSet()) {
-            var rowIndex = cell.getRowKey();
-            var colIndex = cell.getColumnKey();
-            var objCoeff = cell.getValue();
-
-            assert rowIndex != null;
-            assert colIndex != null;
-            assert objCoeff != null;
-
-            // The quadratic objective is (1/2) x' * P * x, and only the
-            // upper triangle of P is stored, so the diagonal terms must
-            // be multiplied by one-half...
-            var objTerm = objCoeff * primal[rowIndex] * primal[colIndex];
-
-            if (rowIndex.equals(colIndex))
-                total += 0.5 * objTerm;
-            else
-                total += objTerm;
-        }
-
-        return total;
+        return currentQuadObj().quadraticForm(primal);
     }
 
     /**
@@ -260,6 +564,23 @@ public final class OsqpModel {
             return Double.NaN;
     }
 
+    /**
+     * Returns the last iterate of the decision variables from a solve that
+     * stopped early (with status {@code MAX_ITER_REACHED},
+     * {@code TIME_LIMIT_REACHED}, or {@code CANCELLED}) or succeeded.
+     *
+     * @return the last iterate of the decision variables, or an array of
+     * {@code Double.NaN} values if the solver did not return one.
+     *
+     * @see OsqpStatus#hasIterate()
+     */
+    public double[] getIterate() {
+        if (status.hasIterate())
+            return Arrays.copyOf(optPrimal, numVar);
+        else
+            return nanArray(numVar);
+    }
+
     /**
      * Returns the optimal reduced costs for the decision variables.
      * @return the optimal reduced costs for the decision variables.
@@ -288,6 +609,38 @@ public final class OsqpModel {
             return Double.NaN;
     }
 
+    /**
+     * Returns the solver statistics from the most recent solve: the number
+     * of iterations, the residuals, and the time spent in each phase.  For
+     * a presolved model the objective value is that of the full model, but
+     * the residuals and the iteration count refer to the reduced problem.
+     *
+     * @return the solver statistics from the most recent solve, or an
+     * empty optional if the model has not been solved or the native setup
+     * failed.
+     */
+    public Optional<OsqpInfo> getInfo() {
+        return Optional.ofNullable(info);
+    }
+
+    /**
+     * Returns an immutable snapshot of the current solution.  The snapshot
+     * is created once per solve and returned by later calls until the model
+     * is solved again or modified; it is unaffected by those changes.
+     *
+     * @return a snapshot of the current solution.
+     */
+    public synchronized OsqpSolution getSolution() {
+        var snapshot = solution;
+
+        if (snapshot == null) {
+            snapshot = OsqpSolution.of(numCon, status, info, optPrimal, optDual, linObjCoeff, currentQuadObj());
+            solution = snapshot;
+        }
+
+        return snapshot;
+    }
+
     /**
      * Returns the current solver status.
      * @return the current solver status.
@@ -306,26 +659,73 @@ public final class OsqpModel {
     public boolean isFeasible(double... primal) {
         validatePrimal(primal);
 
-        for (int conIndex = 0; conIndex < numDual; ++conIndex)
-            if (!isFeasible(conIndex, primal))
+        var conValues = currentConCoeff().multiply(primal);
+
+        for (int conIndex = 0; conIndex < numCon; ++conIndex)
+            if (!isFeasible(conIndex, conValues[conIndex]))
+                return false;
+
+        for (int varIndex = 0; varIndex < numVar; ++varIndex)
+            if (!isFeasible(variableBoundIndex(varIndex), primal[varIndex]))
                 return false;
 
         return true;
     }
 
-    private boolean isFeasible(int conIndex, double[] primal) {
-        var conValue = 0.0;
-        var conCoeffs = linConCoeff.row(conIndex);
+    /**
+     * Evaluates the objective function for a given primal point with the
+     * native matrix kernels, using the problem data held in the native
+     * workspace (which is created or updated first, if necessary).
+     *
+     * @param primal the primal vector to evaluate.
+     *
+     * @return the objective function value at the given primal point.
+     *
+     * @throws IllegalStateException if the native problem setup fails or
+     * this model is presolved.
+     */
+    public synchronized double evaluateNative(double... primal) {
+        validatePrimal(primal);
+        return requireSolver().evaluateObjective(primal);
+    }
+
+    /**
+     * Evaluates the objective function, the primal residual, and the bound
+     * violations of every constraint row (the linear constraints followed
+     * by the variable bounds) with one native call, using the problem data
+     * held in the native workspace.
+     *
+     * @param primal the primal vector to evaluate.
+     *
+     * @return the evaluation at the given primal point.
+     *
+     * @throws IllegalStateException if the native problem setup fails or
+     * this model is presolved.
+     */
+    public synchronized OsqpEvaluation constraintResidualsNative(double... primal) {
+        validatePrimal(primal);
+
+        var evaluation = requireSolver().evaluate(primal);
+        var violations = new double[numDual];
+        currentBoundRows().scatter(evaluation.getViolations(), violations, 0.0);
 
-        for (var entry : conCoeffs.entrySet()) {
-            System.out.println(entry);
-            var varIndex = entry.getKey();
-            var conCoeff = entry.getValue();
+        return evaluation.withViolations(violations);
+    }
 
-            System.out.printf("%d, %d: %f%n", conIndex, varIndex, conCoeff);
-            conValue += conCoeff * primal[varIndex];
-        }
+    /**
+     * Computes the values of the linear constraints for a primal point.
+     *
+     * @param primal the primal vector to evaluate.
+     *
+     * @return the value of each linear constraint (not including the
+     * decision variable bounds) at the given primal point.
+     */
+    public double[] constraintValues(double... primal) {
+        validatePrimal(primal);
+        return currentConCoeff().multiply(primal);
+    }
 
+    private boolean isFeasible(int conIndex, double conValue) {
         var lower = linConLower[conIndex] - TOLERANCE;
         var upper = linConUpper[conIndex] + TOLERANCE;
 
@@ -356,11 +756,9 @@ public final class OsqpModel {
         validateBound(lower);
         validateBound(upper);
         validateConstraintIndex(index);
+        assignBound(index, lower, upper);
 
-        linConLower[index] = lower;
-        linConUpper[index] = upper;
-
-        return reset();
+        return invalidate();
     }
 
     /**
@@ -379,9 +777,16 @@ public final class OsqpModel {
         validateVariableIndex(varIndex);
         validateConstraintIndex(conIndex);
 
-        linConCoeff.put(conIndex, varIndex, linCoeff);
+        conCoeffCache = null;
+        linConCache = null;
 
-        return reset();
+        // A new coefficient changes the structure of the constraint
+        // matrix; a new value for an existing coefficient does not...
+        if (linConCoeff.put(conIndex, varIndex, linCoeff))
+            return reset();
+
+        linConDirty = true;
+        return invalidate();
     }
 
     /**
@@ -401,13 +806,20 @@ public final class OsqpModel {
         validateVariableIndex(index);
 
         // Variable bounds are encoded as linear constraints with a single
-        // unit coefficient on the decision variable...
+        // unit coefficient on the decision variable; only the bounded
+        // variables have rows, so a variable that becomes bounded or
+        // unbounded changes the structure of the constraint matrix...
         int boundIndex = variableBoundIndex(index);
-        linConLower[boundIndex] = lower;
-        linConUpper[boundIndex] = upper;
-        linConCoeff.put(boundIndex, index, 1.0);
+        var wasBounded = isBounded(boundIndex);
+        assignBound(boundIndex, lower, upper);
 
-        return reset();
+        if (isBounded(boundIndex) != wasBounded) {
+            boundRowsCache = null;
+            linConCache = null;
+            return reset();
+        }
+
+        return invalidate();
     }
 
     /**
@@ -425,8 +837,9 @@ public final class OsqpModel {
         validateVariableIndex(index);
 
         linObjCoeff[index] = coeff;
+        linObjDirty = true;
 
-        return reset();
+        return invalidate();
     }
 
     /**
@@ -446,107 +859,1162 @@ public final class OsqpModel {
         validateVariableIndex(index1);
         validateVariableIndex(index2);
 
-        if (index1 <= index2) {
-            quadObjCoeff.put(index1, index2, coeff);
-        }
-        else {
+        if (index1 > index2)
             throw new IllegalArgumentException("Quadratic objective coefficients must be in the upper triangle.");
-        }
 
-        return reset();
+        quadObjCache = null;
+
+        if (quadObjCoeff.put(index1, index2, coeff))
+            return reset();
+
+        quadObjDirty = true;
+        return invalidate();
     }
 
     /**
-     * Assigns the name of the solver log file.
+     * Assigns every linear objective coefficient.
      *
-     * @param logFile the name of the log file.
+     * @param coeffs the linear objective coefficients, indexed by variable.
      *
      * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the vector length and coefficients
+     * are valid.
      */
-    public OsqpModel setLogFile(String logFile) {
-        this.logFile = Optional.of(logFile);
-        return reset();
+    public OsqpModel setObjective(double[] coeffs) {
+        validatePrimal(coeffs);
+
+        for (var coeff : coeffs)
+            validateCoeff(coeff);
+
+        System.arraycopy(coeffs, 0, linObjCoeff, 0, numVar);
+        linObjDirty = true;
+
+        return invalidate();
     }
 
     /**
-     * Assigns a solver parameter.
+     * Assigns many quadratic objective coefficients in the upper triangle
+     * of the coefficient matrix, as if by repeated calls to
+     * {@link #setObjectiveCoeff(int, int, double)}.  The coefficients are
+     * validated before any is assigned.
      *
-     * @param param the parameter to assign.
-     * @param value the value to assign.
+     * @param index1 the indexes of the first decision variable.
+     * @param index2 the indexes of the second decision variable.
+     * @param coeffs the quadratic objective coefficients.
      *
      * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the arrays have the same length and
+     * every coefficient specification is valid.
      */
-    public OsqpModel setParameter(OsqpParam param, double value) {
-        params.put(param, value);
-        return reset();
+    public OsqpModel setQuadraticObjective(int[] index1, int[] index2, double[] coeffs) {
+        validateTriplets(index1, index2, coeffs, numVar, "Invalid variable index.");
+
+        for (int k = 0; k < coeffs.length; ++k)
+            if (index1[k] > index2[k])
+                throw new IllegalArgumentException("Quadratic objective coefficients must be in the upper triangle.");
+
+        quadObjCache = null;
+
+        if (quadObjCoeff.putAll(coeffs.length, index1, index2, coeffs, 0))
+            return reset();
+
+        quadObjDirty = true;
+        return invalidate();
     }
 
     /**
-     * Solves this quadratic program.
+     * Assigns many linear constraint coefficients, as if by repeated calls
+     * to {@link #setConstraintCoeff(int, int, double)}.  The coefficients
+     * are validated before any is assigned.
      *
-     * @return the solution status.
+     * @param conIndex the indexes of the linear constraints.
+     * @param varIndex the indexes of the decision variables.
+     * @param coeffs   the coefficients on the variables in the constraints.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the arrays have the same length and
+     * every coefficient specification is valid.
      */
-    public synchronized OsqpStatus solve() {
-        Arrays.fill(optDual, Double.NaN);
-        Arrays.fill(optPrimal, Double.NaN);
+    public OsqpModel setConstraintMatrix(int[] conIndex, int[] varIndex, double[] coeffs) {
+        validateTriplets(conIndex, varIndex, coeffs, numCon, "Invalid constraint index.");
 
-        var linCon = OsqpMatrix.build(linConCoeff);
-        var quadObj = OsqpMatrix.build(quadObjCoeff);
+        conCoeffCache = null;
+        linConCache = null;
 
-        var paramCount = params.size();
-        var paramNames = new String[paramCount];
-        var paramValues = new double[paramCount];
-        fillParams(paramNames, paramValues);
+        if (linConCoeff.putAll(coeffs.length, conIndex, varIndex, coeffs, 0))
+            return reset();
 
-        var code = run(
-                numVar,
-                numDual,
-                logFile.orElse(""),
-                linObjCoeff,
-                quadObj.rowind,
-                quadObj.colind,
-                quadObj.values,
-                linCon.rowind,
-                linCon.colind,
-                linCon.values,
-                linConLower,
-                linConUpper,
-                optPrimal,
-                optDual,
-                paramNames,
-                paramValues);
+        linConDirty = true;
+        return invalidate();
+    }
 
-        status = OsqpStatus.valueOf(code);
-        return status;
+    /**
+     * Assigns a block of linear constraint coefficients held in compressed
+     * sparse column format, with one column for each decision variable.
+     * The block is validated before any coefficient is assigned.
+     *
+     * @param conOffset the index of the constraint in the first block row.
+     * @param colptr    the column pointers (length {@code numVar + 1}).
+     * @param rowind    the row indexes within the block.
+     * @param coeffs    the coefficients.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the block is a valid compressed
+     * sparse column matrix that fits within the linear constraints.
+     */
+    public OsqpModel setConstraintBlock(int conOffset, int[] colptr, int[] rowind, double[] coeffs) {
+        if (colptr.length != numVar + 1 || colptr[0] != 0 || colptr[numVar] > rowind.length || rowind.length != coeffs.length)
+            throw new IllegalArgumentException("Invalid constraint block structure.");
+
+        for (int col = 0; col < numVar; ++col)
+            if (colptr[col] > colptr[col + 1])
+                throw new IllegalArgumentException("Column pointers must be non-decreasing.");
+
+        for (int k = 0; k < colptr[numVar]; ++k) {
+            validateCoeff(coeffs[k]);
+
+            if (rowind[k] < 0 || conOffset + rowind[k] < 0 || conOffset + rowind[k] >= numCon)
+                throw new IllegalArgumentException("Invalid constraint index.");
+        }
+
+        conCoeffCache = null;
+        linConCache = null;
+
+        if (linConCoeff.putColumns(colptr, rowind, coeffs, conOffset))
+            return reset();
+
+        linConDirty = true;
+        return invalidate();
+    }
+
+    /**
+     * Assigns the bounds on every linear constraint.
+     *
+     * @param lower the lower bounds, indexed by constraint.
+     * @param upper the upper bounds, indexed by constraint.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the vector lengths and bounds are valid.
+     */
+    public OsqpModel setConstraintBounds(double[] lower, double[] upper) {
+        validateBounds(lower, upper, numCon);
+
+        for (int index = 0; index < numCon; ++index)
+            assignBound(index, lower[index], upper[index]);
+
+        return invalidate();
+    }
+
+    /**
+     * Assigns the bounds on every decision variable.
+     *
+     * @param lower the lower bounds, indexed by variable.
+     * @param upper the upper bounds, indexed by variable.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the vector lengths and bounds are valid.
+     */
+    public OsqpModel setVariableBounds(double[] lower, double[] upper) {
+        validateBounds(lower, upper, numVar);
+
+        var changed = false;
+
+        for (int index = 0; index < numVar; ++index) {
+            int boundIndex = variableBoundIndex(index);
+            var wasBounded = isBounded(boundIndex);
+            assignBound(boundIndex, lower[index], upper[index]);
+            changed |= isBounded(boundIndex) != wasBounded;
+        }
+
+        if (changed) {
+            boundRowsCache = null;
+            linConCache = null;
+            return reset();
+        }
+
+        return invalidate();
+    }
+
+    // Validates the elements passed to a bulk setter in one pass, before
+    // any is assigned...
+    private void validateTriplets(int[] rows, int[] cols, double[] coeffs, int nrow, String rowMessage) {
+        if (rows.length != coeffs.length || cols.length != coeffs.length)
+            throw new IllegalArgumentException("Index and coefficient arrays must have the same length.");
+
+        for (int k = 0; k < coeffs.length; ++k) {
+            validateCoeff(coeffs[k]);
+
+            if (rows[k] < 0 || rows[k] >= nrow)
+                throw new IllegalArgumentException(rowMessage);
+
+            validateVariableIndex(cols[k]);
+        }
+    }
+
+    private static void validateBounds(double[] lower, double[] upper, int length) {
+        if (lower.length != length || upper.length != length)
+            throw new IllegalArgumentException("Invalid bound vector length.");
+
+        for (int index = 0; index < length; ++index) {
+            validateBound(lower[index]);
+            validateBound(upper[index]);
+        }
+    }
+
+    /**
+     * Specifies whether each solve should start from the solution found by
+     * the previous solve (if it was solved successfully).  Otherwise, and
+     * after an unsuccessful solve, each solve starts from the origin like
+     * the first one.  The automatic warm start is enabled by default.
+     *
+     * @param enabled whether to enable the automatic warm start.
+     *
+     * @return this object, for operator chaining.
+     */
+    public OsqpModel setWarmStart(boolean enabled) {
+        this.autoWarmStart = enabled;
+        return this;
+    }
+
+    /**
+     * Specifies whether to reduce the problem before the native setup: the
+     * fixed variables are substituted into the objective and the bounds,
+     * variables with no quadratic or constraint terms are set at their
+     * optimal bounds, empty constraints are dropped, and duplicate
+     * constraints are merged.  The solution is mapped back to the model,
+     * so the accessors are unaffected.  Presolve is disabled by default.
+     *
+     * <p>The reduction depends on the values of the data, so any change
+     * other than to an updatable parameter requires a new native setup,
+     * and the operations that read the native workspace directly (sweeps
+     * and native evaluations) are not supported.</p>
+     *
+     * @param enabled whether to presolve the problem.
+     *
+     * @return this object, for operator chaining.
+     */
+    public OsqpModel setPresolve(boolean enabled) {
+        this.presolve = enabled;
+        return reset();
+    }
+
+    /**
+     * Specifies the precision in which the native solver stores the problem
+     * and runs the ADMM iterations.  The model data and the solution remain
+     * in double precision; single precision converts them at the native
+     * boundary.  Changing the precision requires a new native setup.  Batch
+     * solves and specialized solvers always use double precision.
+     *
+     * @param precision the precision of the native workspace.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws IllegalStateException if the precision is not available.
+     *
+     * @see OsqpPrecision
+     */
+    public OsqpModel setPrecision(OsqpPrecision precision) {
+        precision.requireAvailable();
+        this.precision = precision;
+        return reset();
+    }
+
+    /**
+     * Returns the precision of the native workspace.
+     * @return the precision of the native workspace.
+     */
+    public OsqpPrecision getPrecision() {
+        return precision;
     }
 
-    private void fillParams(String[] names, double[] values) {
-        int index = 0;
-
-        for (var entry : params.entrySet()) {
-            names[index] = entry.getKey().name();
-            values[index] = entry.getValue();
-            ++index;
-        }
-    }
-
-    // OSQP uses long as the integer type so all "integer"
-    // arguments are defined as longs...
-    private native int run(
-            long     numVar,
-            long     numDual,
-            String   logFile,
-            double[] linObjCoeff,
-            long[]   quadObjRowInd,
-            long[]   quadObjColInd,
-            double[] quadObjCoeff,
-            long[]   linConRowInd,
-            long[]   linConColInd,
-            double[] linConCoeff,
-            double[] linConLower,
-            double[] linConUpper,
-            double[] optPrimal,
-            double[] optDual,
-            String[] paramNames,
-            double[] paramValues);
+    /**
+     * Solves this model with a specialized solver library generated for its
+     * structure, instead of a general OSQP workspace.  Each solve sends the
+     * linear objective and the bounds to the library; changes to the matrix
+     * values are sent only to libraries generated with {@code EMBEDDED=2}.
+     * Changed parameters are sent to the library, which rejects those it
+     * cannot change (see {@link OsqpEmbedded}); solves with a time limit
+     * or a cancellable model are rejected.  A rejected update makes the
+     * solve return {@code SETUP_ERROR}, and is repeated by the next solve.
+     * Batch solves, sweeps, and native evaluations still use the general
+     * solver.
+     *
+     * @param solver the specialized solver, or {@code null} to return to
+     *               the general solver.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws IllegalStateException if the specialized solver has been
+     * closed.
+     *
+     * @see OsqpEmbedded
+     */
+    public OsqpModel setEmbeddedSolver(OsqpEmbedded solver) {
+        if (solver != null && solver.isClosed())
+            throw new IllegalStateException("The specialized solver has been closed: " + solver);
+
+        synchronized (this) {
+            embedded = solver;
+            embeddedLinCon = null;
+            embeddedQuadObj = null;
+            embeddedParams = null;
+        }
+
+        return invalidate();
+    }
+
+    /**
+     * Specifies whether later solves may be stopped by {@link #cancel()}.
+     * Cancellable solves (and solves with a time limit) check for
+     * cancellation every few hundred iterations.
+     *
+     * @param enabled whether later solves may be cancelled.
+     *
+     * @return this object, for operator chaining.
+     */
+    public OsqpModel setCancellable(boolean enabled) {
+        synchronized (this) {
+            cancellable = enabled;
+        }
+
+        return this;
+    }
+
+    /**
+     * Requests that a cancellable solve in progress on another thread stop
+     * early.  The solve returns {@code CANCELLED} and its last iterate is
+     * available from {@link #getIterate()}.  This method does not wait for
+     * the solve to finish, and has no effect if no solve is in progress.
+     */
+    public void cancel() {
+        var current = solver;
+
+        if (current != null)
+            current.cancel();
+    }
+
+    /**
+     * Assigns the starting point for the next solve, which takes precedence
+     * over the automatic warm start.
+     *
+     * @param primal the initial values of the decision variables, or
+     *               {@code null} to start from the default primal point.
+     * @param dual   the initial dual values for the linear constraints
+     *               followed by the initial reduced costs for the decision
+     *               variables (the layout returned by {@code getDual()} and
+     *               {@code getReduced()}), or {@code null} to start from the
+     *               default dual point.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws RuntimeException unless the vector lengths are valid.
+     */
+    public OsqpModel warmStart(double[] primal, double[] dual) {
+        if (primal != null)
+            validatePrimal(primal);
+
+        if (dual != null)
+            validateDual(dual);
+
+        synchronized (this) {
+            warmPrimal = primal != null ? primal.clone() : null;
+            warmDual = dual != null ? dual.clone() : null;
+        }
+
+        return this;
+    }
+
+    /**
+     * Selects the linear system solver used to factor the KKT matrix.
+     *
+     * @param solver the linear system solver.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws IllegalStateException unless the solver is available in this
+     * process.
+     */
+    public OsqpModel setLinsysSolver(OsqpLinsys solver) {
+        if (!solver.isAvailable())
+            throw new IllegalStateException(String.format("Linear system solver [%s] is not available.", solver));
+
+        return setParameter(OsqpParam.LINSYS_SOLVER, solver.getCode());
+    }
+
+    /**
+     * Assigns the name of the solver log file.
+     *
+     * <p>Each solve and sweep appends its progress to the file itself
+     * (when the {@code VERBOSE} parameter is on), so models with log files
+     * solve concurrently.  The native setup and batch solves write to the
+     * OSQP log, which is shared by the whole process: they are serialized
+     * with each other, and the output printed by other threads while they
+     * hold it also goes to their file.</p>
+     *
+     * @param logFile the name of the log file.
+     *
+     * @return this object, for operator chaining.
+     */
+    public OsqpModel setLogFile(String logFile) {
+        // The log file is opened for each solve, so the native workspace
+        // need not be rebuilt...
+        this.logFile = Optional.of(logFile);
+        return invalidate();
+    }
+
+    /**
+     * Assigns a solver parameter.  Parameters that OSQP allows to change
+     * after the setup are sent to the existing native workspace before the
+     * next solve; the others require a new setup.
+     *
+     * @param param the parameter to assign.
+     * @param value the value to assign.
+     *
+     * @return this object, for operator chaining.
+     *
+     * @throws IllegalStateException unless the parameter is available in
+     * this process.
+     *
+     * @see OsqpParam#isAvailable()
+     * @see OsqpParam#isUpdatable()
+     */
+    public OsqpModel setParameter(OsqpParam param, double value) {
+        param.requireAvailable();
+        params.put(param, value);
+
+        if (!param.isUpdatable())
+            return reset();
+
+        paramUpdates.put(param, value);
+        return invalidate();
+    }
+
+    /**
+     * Solves this quadratic program.  The native workspace is created on the
+     * first call and reused by later calls until the model structure is
+     * modified; changes to the linear objective, the bounds, and the values
+     * (but not the sparsity pattern) of the coefficient matrices are sent to
+     * the existing workspace.
+     *
+     * @return the solution status.
+     *
+     * @throws IllegalStateException if the model does not match the
+     * structure of its specialized solver (if any).
+     */
+    public synchronized OsqpStatus solve() {
+        if (embedded != null)
+            return solveEmbedded();
+
+        prepareSolver();
+
+        if (solver != null)
+            applyWarmStart();
+
+        Arrays.fill(optDual, Double.NaN);
+        Arrays.fill(optPrimal, Double.NaN);
+        solution = null;
+
+        if (solver == null) {
+            info = null;
+            warmStartReady = false;
+            status = OsqpStatus.SETUP_ERROR;
+            return status;
+        }
+
+        solver.setCancellable(cancellable);
+        var solverPrimal = presolved != null ? nanArray(presolved.numVar()) : optPrimal;
+        var solverDual = nanArray(presolved != null ? presolved.numRows() : currentBoundRows().numRows());
+
+        var code = solver.solve(logFile.orElse(""), solverPrimal, solverDual);
+        assignResult(solverPrimal, solverDual);
+        info = modelInfo(solver.getInfo());
+
+        status = OsqpStatus.valueOf(code);
+        warmStartReady = isSolved();
+        return status;
+    }
+
+    // Solves with the specialized library, which receives the vectors with
+    // every solve, and the matrix values and parameters whenever they have
+    // changed (if the library accepts them); a rejected update is sent
+    // again with the next solve...
+    private OsqpStatus solveEmbedded() {
+        if (presolve)
+            throw new IllegalStateException("Specialized solvers do not support presolved models.");
+
+        if (cancellable)
+            throw new IllegalStateException("Specialized solvers do not support cancellation.");
+
+        var boundRows = currentBoundRows();
+        var linCon = currentLinCon();
+        var quadObj = currentQuadObj();
+
+        if (embedded.numVar() != numVar || embedded.numDual() != boundRows.numRows() || !embedded.accepts(quadObj, linCon))
+            throw new IllegalStateException("The model does not match the specialized solver: " + embedded);
+
+        Arrays.fill(optDual, Double.NaN);
+        Arrays.fill(optPrimal, Double.NaN);
+        solution = null;
+
+        if (!params.equals(embeddedParams)) {
+            if (!embedded.updateSettings(params))
+                return embeddedFailure();
+
+            embeddedParams = new EnumMap<>(params);
+        }
+
+        if (embedded.isMatrixUpdatable() && (linCon != embeddedLinCon || quadObj != embeddedQuadObj)) {
+            var updated = embedded.updateMatrices(
+                    quadObj != embeddedQuadObj ? quadObj.values : null,
+                    linCon != embeddedLinCon ? linCon.values : null);
+
+            if (!updated)
+                return embeddedFailure();
+
+            embeddedLinCon = linCon;
+            embeddedQuadObj = quadObj;
+        }
+
+        // The library starts from its previous solution unless told
+        // otherwise, as the OSQP workspace does...
+        if (warmPrimal != null || warmDual != null)
+            embedded.warmStart(warmPrimal, warmDual != null ? boundRows.gather(warmDual) : null);
+        else if (!autoWarmStart || !warmStartReady)
+            embedded.warmStart(new double[numVar], new double[boundRows.numRows()]);
+
+        warmPrimal = null;
+        warmDual = null;
+
+        var solverDual = nanArray(boundRows.numRows());
+        status = embedded.solve(linObjCoeff, boundRows.gather(linConLower), boundRows.gather(linConUpper), optPrimal, solverDual);
+        boundRows.scatter(solverDual, optDual, 0.0);
+
+        info = embedded.getInfo().orElse(null);
+        warmStartReady = isSolved();
+        return status;
+    }
+
+    private OsqpStatus embeddedFailure() {
+        info = null;
+        warmStartReady = false;
+        status = OsqpStatus.SETUP_ERROR;
+        return status;
+    }
+
+    /**
+     * Solves a family of problems that differ from this model only in the
+     * linear objective coefficients and/or the bounds, with one native call.
+     * The native workspace is set up (and factored) once, and each problem
+     * is solved in order in the same workspace, starting from the solution
+     * of the previous one.  The model itself is not changed: its own vectors
+     * are restored before the next solve.
+     *
+     * <p>Each bound vector holds the constraint bounds followed by the
+     * variable bounds (the layout of {@code getDual()} followed by that of
+     * {@code getReduced()}).  A sweep may not bound a variable that is
+     * unbounded in this model, because that variable has no row in the
+     * native constraint matrix.</p>
+     *
+     * <p>The time limit applies to each problem.  A cancelled sweep
+     * returns {@code CANCELLED} for the problem in progress (with the
+     * last iterate as its primal solution) and for every problem after
+     * it, which is not solved.</p>
+     *
+     * @param linObjCoeffs the linear objective coefficients for each problem,
+     *                     or {@code null} to use those of this model.
+     * @param lowers       the lower bounds for each problem, or {@code null}
+     *                     to use those of this model.
+     * @param uppers       the upper bounds for each problem, or {@code null}
+     *                     to use those of this model.
+     * @param primals      the arrays to receive the primal solutions.
+     * @param duals        the arrays to receive the dual solutions (in the
+     *                     layout of the bound vectors), or {@code null}.
+     *
+     * @return the solution status for each problem, in order.
+     *
+     * @throws IllegalStateException if the native problem setup fails or
+     * this model is presolved.
+     */
+    public synchronized List<OsqpStatus> sweep(double[][] linObjCoeffs,
+                                               double[][] lowers,
+                                               double[][] uppers,
+                                               double[][] primals,
+                                               double[][] duals) {
+        var count = primals.length;
+
+        checkSweep(linObjCoeffs, count, numVar);
+        checkSweep(lowers, count, numDual);
+        checkSweep(uppers, count, numDual);
+        checkSweep(primals, count, numVar);
+        checkSweep(duals, count, numDual);
+
+        var current = requireSolver();
+        var boundRows = currentBoundRows();
+        var numRows = boundRows.numRows();
+
+        for (int k = 0; k < count; ++k) {
+            var lower = lowers != null ? lowers[k] : linConLower;
+            var upper = uppers != null ? uppers[k] : linConUpper;
+
+            if (!boundRows.covers(lower, upper, MAX_BOUND))
+                throw new IllegalArgumentException("A sweep may not bound a variable that is unbounded in the model.");
+        }
+
+        var flatLinObj = linObjCoeffs != null ? new double[count * numVar] : null;
+        var flatLower = lowers != null ? new double[count * numRows] : null;
+        var flatUpper = uppers != null ? new double[count * numRows] : null;
+
+        for (int k = 0; k < count; ++k) {
+            if (flatLinObj != null)
+                System.arraycopy(linObjCoeffs[k], 0, flatLinObj, k * numVar, numVar);
+
+            if (flatLower != null)
+                System.arraycopy(boundRows.gather(lowers[k]), 0, flatLower, k * numRows, numRows);
+
+            if (flatUpper != null)
+                System.arraycopy(boundRows.gather(uppers[k]), 0, flatUpper, k * numRows, numRows);
+        }
+
+        var flatPrimal = new double[count * numVar];
+        var flatDual = new double[count * numRows];
+
+        Arrays.fill(flatPrimal, Double.NaN);
+        Arrays.fill(flatDual, Double.NaN);
+
+        applyWarmStart();
+        current.setCancellable(cancellable);
+        var codes = current.sweep(logFile.orElse(""), count, flatLinObj, flatLower, flatUpper, flatPrimal, flatDual);
+
+        // The workspace now holds the vectors of the last problem...
+        linObjDirty |= flatLinObj != null;
+        linConLowerDirty |= flatLower != null;
+        linConUpperDirty |= flatUpper != null;
+
+        var statuses = new ArrayList<OsqpStatus>(count);
+        var solverDual = new double[numRows];
+
+        for (int k = 0; k < count; ++k) {
+            System.arraycopy(flatPrimal, k * numVar, primals[k], 0, numVar);
+
+            if (duals != null) {
+                System.arraycopy(flatDual, k * numRows, solverDual, 0, numRows);
+                boundRows.scatter(solverDual, duals[k], 0.0);
+            }
+
+            statuses.add(OsqpStatus.valueOf(codes[k]));
+        }
+
+        return statuses;
+    }
+
+    private static void checkSweep(double[][] vectors, int count, int length) {
+        if (vectors == null)
+            return;
+
+        if (vectors.length != count)
+            throw new IllegalArgumentException("Sweep arrays must have the same number of problems.");
+
+        for (var vector : vectors)
+            if (vector.length != length)
+                throw new IllegalArgumentException("Invalid sweep vector length.");
+    }
+
+    /**
+     * Solves this quadratic program on a shared solver thread, so that the
+     * caller may build the next model while this one is solved.  Each model
+     * is served by one thread, which therefore owns its native workspace,
+     * and its asynchronous solves run in submission order.  The model must
+     * not be modified until the returned future completes.
+     *
+     * <p>The number of solver threads defaults to the number of available
+     * processors and may be set with the {@code com.d3x.osqp.asyncThreads}
+     * system property.  When a thread has a long queue of pending solves,
+     * this method waits until the queue has room, so the solves keep their
+     * order and their thread.</p>
+     *
+     * @return a future that completes with the solution status.
+     *
+     * @throws java.util.concurrent.RejectedExecutionException if the
+     * calling thread is interrupted while waiting for room in the queue.
+     *
+     * @see #solve()
+     */
+    public CompletableFuture<OsqpStatus> solveAsync() {
+        return OsqpExecutor.shared().submit(lane, this::solve);
+    }
+
+    /**
+     * Solves many quadratic programs with a single native call on a shared
+     * solver thread, using the default number of batch worker threads.
+     *
+     * @param models the models to solve, which must not be modified until
+     *               the returned future completes.
+     *
+     * @return a future that completes with the solution status for each
+     * model, in the same order.
+     *
+     * @see #solveAll(List)
+     */
+    public static CompletableFuture<List<OsqpStatus>> solveAllAsync(List<OsqpModel> models) {
+        var batch = List.copyOf(models);
+        return OsqpExecutor.shared().submit(OsqpExecutor.nextLane(), () -> solveAll(batch));
+    }
+
+    /**
+     * Solves many quadratic programs with a single native call, using the
+     * default number of worker threads (the {@code com.d3x.osqp.threads}
+     * system property, or the number of available processors).
+     *
+     * @param models the models to solve.
+     *
+     * @return the solution status for each model, in the same order.
+     *
+     * @see #solveAll(List, int)
+     */
+    public static List<OsqpStatus> solveAll(List<OsqpModel> models) {
+        return solveAll(models, OsqpBatch.defaultThreadCount());
+    }
+
+    /**
+     * Solves many quadratic programs with a single native call, which
+     * avoids the per-problem JNI overhead that dominates the solution
+     * time for small problems.  The problems are solved concurrently by
+     * a pool of native worker threads.
+     *
+     * <p>Each model receives its own solution, as if it had been solved
+     * by {@link #solve()}, but no native workspace is kept, warm starts
+     * are not applied, and solver output is not written to the model log
+     * files.  Workers reuse their workspace for consecutive problems with
+     * the same sparsity pattern and parameters, so the solutions agree
+     * with individual solves to within the solver tolerances.</p>
+     *
+     * @param models     the models to solve.
+     * @param numThreads the number of worker threads to use.
+     *
+     * @return the solution status for each model, in the same order.
+     */
+    public static List<OsqpStatus> solveAll(List<OsqpModel> models, int numThreads) {
+        if (numThreads < 1)
+            throw new IllegalArgumentException("Number of threads must be positive.");
+
+        var batch = new OsqpBatch(models.size());
+
+        for (var model : models)
+            model.addTo(batch);
+
+        batch.solve("", numThreads);
+
+        var statuses = new ArrayList<OsqpStatus>(models.size());
+
+        for (int index = 0; index < models.size(); ++index)
+            statuses.add(models.get(index).assignSolution(batch, index));
+
+        return statuses;
+    }
+
+    private synchronized void addTo(OsqpBatch batch) {
+        if (presolve) {
+            // The data is unchanged while a presolved workspace survives,
+            // so its reduction is the same as this one...
+            presolved = newPresolve();
+            batch.add(
+                    presolved.numVar(),
+                    presolved.numRows(),
+                    presolved.linObjCoeff(),
+                    presolved.quadObj(),
+                    presolved.linCon(),
+                    presolved.lower(),
+                    presolved.upper(),
+                    params);
+            return;
+        }
+
+        presolved = null;
+        batch.add(
+                numVar,
+                currentBoundRows().numRows(),
+                linObjCoeff,
+                currentQuadObj(),
+                currentLinCon(),
+                currentBoundRows().gather(linConLower),
+                currentBoundRows().gather(linConUpper),
+                params);
+    }
+
+    // The statistics of a presolved workspace describe the reduced problem,
+    // whose objective leaves out the removed variables...
+    private OsqpInfo modelInfo(OsqpInfo solverInfo) {
+        if (solverInfo == null || presolved == null)
+            return solverInfo;
+        else
+            return solverInfo.shiftObjective(presolved.objectiveOffset());
+    }
+
+    private synchronized OsqpStatus assignSolution(OsqpBatch batch, int index) {
+        solution = null;
+        var solverPrimal = presolved != null ? new double[presolved.numVar()] : optPrimal;
+        var solverDual = new double[presolved != null ? presolved.numRows() : currentBoundRows().numRows()];
+        batch.getPrimal(index, solverPrimal);
+        batch.getDual(index, solverDual);
+        assignResult(solverPrimal, solverDual);
+
+        info = modelInfo(batch.getInfo(index));
+        status = batch.getStatus(index);
+        warmStartReady = isSolved();
+        return status;
+    }
+
+    /**
+     * Returns the time spent inside the native adapter, accumulated over
+     * all threads since startup (or the last reset), if the native
+     * instrumentation is enabled.
+     *
+     * @return a snapshot of the native adapter timings.
+     *
+     * @see OsqpNativeStats#enable(boolean)
+     */
+    public static OsqpNativeStats nativeStats() {
+        return OsqpNativeStats.snapshot();
+    }
+
+    // Converts a solution from the solver layout to the model layout...
+    private void assignResult(double[] solverPrimal, double[] solverDual) {
+        if (presolved != null) {
+            presolved.scatter(solverPrimal, solverDual, optPrimal, optDual);
+        }
+        else {
+            if (solverPrimal != optPrimal)
+                System.arraycopy(solverPrimal, 0, optPrimal, 0, numVar);
+
+            currentBoundRows().scatter(solverDual, optDual, 0.0);
+        }
+    }
+
+    private double[] gatherPrimal(double[] primal) {
+        if (primal == null || presolved == null)
+            return primal;
+        else
+            return presolved.gatherPrimal(primal);
+    }
+
+    private double[] gatherDual(double[] dual) {
+        if (dual == null)
+            return null;
+        else if (presolved != null)
+            return presolved.gatherDual(dual);
+        else
+            return currentBoundRows().gather(dual);
+    }
+
+    private void applyWarmStart() {
+        // A failed warm start leaves the solver at its default starting
+        // point, so the return value may be ignored.  The OSQP workspace
+        // keeps the iterate of its previous solve, so a cold start must
+        // clear it...
+        if (warmPrimal != null || warmDual != null)
+            solver.warmStart(gatherPrimal(warmPrimal), gatherDual(warmDual));
+        else if (autoWarmStart && warmStartReady)
+            solver.warmStart(gatherPrimal(optPrimal), gatherDual(optDual));
+        else if (!autoWarmStart || !donorIterate)
+            solver.coldStart();
+
+        warmPrimal = null;
+        warmDual = null;
+        donorIterate = false;
+    }
+
+    // Brings the native workspace up to date with the model, creating a
+    // new workspace if necessary; the solver remains null if the setup
+    // fails...
+    private void prepareSolver() {
+        if (solver != null && !updateSolver())
+            releaseSolver();
+
+        if (solver == null)
+            solver = setupSolver();
+    }
+
+    /**
+     * Builds the sparse matrices and the bound row mapping for the current
+     * data ahead of the next solve, so that another thread may marshal this
+     * model while the solver threads are busy.
+     */
+    synchronized void marshal() {
+        currentBoundRows();
+        currentLinCon();
+        currentQuadObj();
+    }
+
+    /**
+     * Takes over the native workspace of another model with the same
+     * structure, so that the next solve sends only the changed data to the
+     * workspace instead of repeating the setup and factorization, and warm
+     * starts from the last iterate of the donor.  The models must have the
+     * same dimensions, parameters, precision, and matrix sparsity patterns
+     * (including the bounded variables), and neither may be presolved or
+     * solved by a specialized library; otherwise the workspace of the donor
+     * is released.  The donor is left without a workspace in either case.
+     *
+     * @param donor the model that gives up its workspace.
+     *
+     * @return {@code true} iff this model adopted the workspace.
+     */
+    boolean adoptSolver(OsqpModel donor) {
+        OsqpSolver donated;
+        OsqpMatrix donorLinCon;
+        OsqpMatrix donorQuadObj;
+        Map<OsqpParam, Double> donorParams;
+        OsqpPrecision donorPrecision;
+
+        synchronized (donor) {
+            donated = donor.solver;
+            donorLinCon = donor.linConMatrix;
+            donorQuadObj = donor.quadObjMatrix;
+            donorParams = new EnumMap<>(donor.params);
+            donorPrecision = donor.precision;
+
+            if (donated == null)
+                return false;
+
+            donor.solver = null;
+
+            if (donor.presolved != null || !donor.paramUpdates.isEmpty()) {
+                donated.close();
+                return false;
+            }
+        }
+
+        synchronized (this) {
+            var compatible = solver == null
+                    && !presolve
+                    && embedded == null
+                    && donor.numVar == numVar
+                    && donor.numCon == numCon
+                    && donorPrecision == precision
+                    && donorParams.equals(params)
+                    && currentLinCon().hasPattern(donorLinCon)
+                    && currentQuadObj().hasPattern(donorQuadObj);
+
+            if (!compatible) {
+                donated.close();
+                return false;
+            }
+
+            // Every vector and matrix value is compared with (or sent to)
+            // the workspace before the next solve...
+            solver = donated;
+            linConMatrix = donorLinCon;
+            quadObjMatrix = donorQuadObj;
+            paramUpdates.clear();
+            linObjDirty = true;
+            linConDirty = true;
+            quadObjDirty = true;
+            linConLowerDirty = true;
+            linConUpperDirty = true;
+            donorIterate = true;
+            invalidate();
+            return true;
+        }
+    }
+
+    // The native workspace of a presolved model holds the reduced problem,
+    // so the operations that read it directly require the full problem...
+    private OsqpSolver requireSolver() {
+        if (presolve)
+            throw new IllegalStateException("This operation is not supported for presolved models.");
+
+        prepareSolver();
+
+        if (solver == null)
+            throw new IllegalStateException("OSQP problem setup failed.");
+
+        return solver;
+    }
+
+    private boolean updateSolver() {
+        // The reduction depends on the values of the data, so a presolved
+        // workspace only receives new parameters...
+        if (presolved != null && (linObjDirty || linConDirty || quadObjDirty || linConLowerDirty || linConUpperDirty))
+            return false;
+
+        if (linConDirty || quadObjDirty) {
+            var linCon = linConDirty ? currentLinCon() : linConMatrix;
+            var quadObj = quadObjDirty ? currentQuadObj() : quadObjMatrix;
+
+            // Coefficients that become (nearly) zero are removed from the
+            // sparse matrices, which changes their non-zero patterns...
+            if (!linCon.hasPattern(linConMatrix) || !quadObj.hasPattern(quadObjMatrix))
+                return false;
+
+            if (!solver.updateMatrices(quadObjMatrix, quadObj, linConMatrix, linCon))
+                return false;
+
+            linConMatrix = linCon;
+            quadObjMatrix = quadObj;
+            linConDirty = false;
+            quadObjDirty = false;
+        }
+
+        if (!paramUpdates.isEmpty()) {
+            if (!solver.updateSettings(OsqpParam.toArray(paramUpdates)))
+                return false;
+
+            paramUpdates.clear();
+        }
+
+        if (linObjDirty) {
+            if (!solver.updateLinCost(linObjCoeff))
+                return false;
+
+            linObjDirty = false;
+        }
+
+        if (linConLowerDirty && linConUpperDirty) {
+            if (!solver.updateBounds(currentBoundRows().gather(linConLower), currentBoundRows().gather(linConUpper)))
+                return false;
+        }
+        else if (linConLowerDirty) {
+            if (!solver.updateLowerBound(currentBoundRows().gather(linConLower)))
+                return false;
+        }
+        else if (linConUpperDirty) {
+            if (!solver.updateUpperBound(currentBoundRows().gather(linConUpper)))
+                return false;
+        }
+
+        linConLowerDirty = false;
+        linConUpperDirty = false;
+        return true;
+    }
+
+    private OsqpBoundRows currentBoundRows() {
+        var boundRows = boundRowsCache;
+
+        if (boundRows == null) {
+            boundRows = OsqpBoundRows.of(numCon, numVar, linConLower, linConUpper, MAX_BOUND);
+            boundRowsCache = boundRows;
+        }
+
+        return boundRows;
+    }
+
+    private OsqpMatrix currentConCoeff() {
+        var matrix = conCoeffCache;
+
+        if (matrix == null) {
+            matrix = OsqpMatrix.build(linConCoeff);
+            conCoeffCache = matrix;
+        }
+
+        return matrix;
+    }
+
+    // The constraint matrix in the solver layout, with the unit rows for
+    // the bounded variables generated directly in compressed form...
+    private OsqpMatrix currentLinCon() {
+        var matrix = linConCache;
+
+        if (matrix == null) {
+            matrix = currentBoundRows().stack(currentConCoeff());
+            linConCache = matrix;
+        }
+
+        return matrix;
+    }
+
+    private OsqpMatrix currentQuadObj() {
+        var matrix = quadObjCache;
+
+        if (matrix == null) {
+            matrix = OsqpMatrix.build(quadObjCoeff);
+            quadObjCache = matrix;
+        }
+
+        return matrix;
+    }
+
+    private OsqpSolver setupSolver() {
+        // The new workspace receives the current data...
+        paramUpdates.clear();
+        linObjDirty = false;
+        linConDirty = false;
+        quadObjDirty = false;
+        linConLowerDirty = false;
+        linConUpperDirty = false;
+
+        if (presolve) {
+            presolved = newPresolve();
+            linConMatrix = presolved.linCon();
+            quadObjMatrix = presolved.quadObj();
+
+            return OsqpSolver.setup(
+                    presolved.numVar(),
+                    presolved.numRows(),
+                    logFile.orElse(""),
+                    presolved.linObjCoeff(),
+                    presolved.quadObj(),
+                    presolved.linCon(),
+                    presolved.lower(),
+                    presolved.upper(),
+                    OsqpParam.toArray(params),
+                    precision);
+        }
+
+        presolved = null;
+        var boundRows = currentBoundRows();
+        var linCon = currentLinCon();
+        var quadObj = currentQuadObj();
+
+        linConMatrix = linCon;
+        quadObjMatrix = quadObj;
+
+        return OsqpSolver.setup(
+                numVar,
+                boundRows.numRows(),
+                logFile.orElse(""),
+                linObjCoeff,
+                quadObj,
+                linCon,
+                boundRows.gather(linConLower),
+                boundRows.gather(linConUpper),
+                OsqpParam.toArray(params),
+                precision);
+    }
+
+    private OsqpPresolve newPresolve() {
+        return OsqpPresolve.of(linObjCoeff, currentQuadObj(), currentConCoeff(), linConLower, linConUpper, MAX_BOUND);
+    }
+
+    /**
+     * Copies the problem data into off-heap storage in the layout used by
+     * the native solver.  The bounds on the bounded variables appear as the
+     * last rows of the constraint matrix, after the linear constraints, in
+     * variable order; unbounded variables have no rows.
+     *
+     * @return the problem data for this model.
+     */
+    public OsqpData toData() {
+        var boundRows = currentBoundRows();
+        var linCon = currentLinCon();
+        var quadObj = currentQuadObj();
+        var data = OsqpData.allocate(numVar, boundRows.numRows(), quadObj.nnz, linCon.nnz);
+
+        data.linObjCoeff().put(linObjCoeff);
+        data.linConLower().put(boundRows.gather(linConLower));
+        data.linConUpper().put(boundRows.gather(linConUpper));
+        data.quadObjColPtr().put(quadObj.colptr);
+        data.quadObjRowInd().put(quadObj.rowind);
+        data.quadObjCoeff().put(quadObj.values);
+        data.linConColPtr().put(linCon.colptr);
+        data.linConRowInd().put(linCon.rowind);
+        data.linConCoeff().put(linCon.values);
+
+        return data;
+    }
 }
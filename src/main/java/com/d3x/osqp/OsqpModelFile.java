@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.io.IOException;
+import java.io.UncheckedIOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.EnumMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Optional;
+
+/**
+ * Stores a quadratic program in a compact, versioned binary file that may
+ * be mapped into memory and passed to the native solver without copying.
+ *
+ * <p>A file holds a fixed header (an eight-byte magic string followed by
+ * seven 64-bit words: the format version, the number of variables, linear
+ * constraints, and constraint rows, the number of non-zeros in the
+ * quadratic objective and constraint matrices, and the number of stored
+ * parameters), the parameter values indexed by ordinal (with
+ * {@code Double.NaN} for the defaults), and then the problem data in the
+ * layout of {@link OsqpData}, including the bounded variable rows.  All
+ * values are written in the native byte order of the machine that saved
+ * the file.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpModelFile {
+    private final int numCon;
+    private final OsqpData data;
+    private final EnumMap<OsqpParam, Double> params;
+
+    // The layout of the header, which must match the native loader in
+    // com_d3x_osqp_OsqpBatch.c...
+    private static final byte[] MAGIC = "D3XOSQP\0".getBytes(StandardCharsets.US_ASCII);
+    private static final long VERSION = 1;
+    private static final int HEADER_SIZE = 64;
+    private static final int VALUE_SIZE = 8;
+
+    private OsqpModelFile(int numCon, OsqpData data, EnumMap<OsqpParam, Double> params) {
+        this.numCon = numCon;
+        this.data = data;
+        this.params = params;
+    }
+
+    /**
+     * The dimensions and parameters read from the header of a file.
+     */
+    static final class Header {
+        final int numVar;
+        final int numCon;
+        final int numDual;
+        final int quadObjNnz;
+        final int linConNnz;
+        final int paramCount;
+
+        private Header(ByteBuffer buffer) {
+            var magic = new byte[MAGIC.length];
+            buffer.position(0);
+            buffer.get(magic);
+
+            if (!Arrays.equals(magic, MAGIC))
+                throw new IllegalArgumentException("Not an OSQP model file.");
+
+            var version = buffer.getLong();
+
+            if (version != VERSION) {
+                if (Long.reverseBytes(version) == VERSION)
+                    throw new IllegalArgumentException("The model file was written with a different byte order.");
+                else
+                    throw new IllegalArgumentException("Unsupported model file version: " + version);
+            }
+
+            numVar = toInt(buffer.getLong());
+            numCon = toInt(buffer.getLong());
+            numDual = toInt(buffer.getLong());
+            quadObjNnz = toInt(buffer.getLong());
+            linConNnz = toInt(buffer.getLong());
+            paramCount = toInt(buffer.getLong());
+
+            if (numCon > numDual || numDual > numCon + numVar)
+                throw new IllegalArgumentException("Invalid model file dimensions.");
+        }
+
+        private static int toInt(long value) {
+            if (value < 0 || value > Integer.MAX_VALUE)
+                throw new IllegalArgumentException("Invalid model file dimensions.");
+
+            return (int) value;
+        }
+
+        long dataOffset() {
+            return HEADER_SIZE + (long) VALUE_SIZE * paramCount;
+        }
+
+        long fileSize() {
+            return dataOffset() + OsqpData.byteSize(numVar, numDual, quadObjNnz, linConNnz);
+        }
+    }
+
+    /**
+     * Writes a quadratic program to a file with sequential writes.
+     *
+     * @param path   the file to create or replace.
+     * @param numCon the number of linear constraints (the leading rows of
+     *               the constraint matrix).
+     * @param data   the problem data in the solver layout.
+     * @param params the solver parameters to store.
+     *
+     * @throws UncheckedIOException if the file cannot be written.
+     */
+    public static void write(Path path, int numCon, OsqpData data, Map<OsqpParam, Double> params) {
+        if (numCon < 0 || numCon > data.numDual() || data.numDual() > numCon + data.numVar())
+            throw new IllegalArgumentException("Invalid number of linear constraints.");
+
+        var paramValues = OsqpParam.toArray(params);
+        var header = ByteBuffer.allocate(HEADER_SIZE + VALUE_SIZE * paramValues.length).order(ByteOrder.nativeOrder());
+
+        header.put(MAGIC);
+        header.putLong(VERSION);
+        header.putLong(data.numVar());
+        header.putLong(numCon);
+        header.putLong(data.numDual());
+        header.putLong(data.quadObjNnz());
+        header.putLong(data.linConNnz());
+        header.putLong(paramValues.length);
+
+        for (var value : paramValues)
+            header.putDouble(value);
+
+        header.flip();
+
+        var body = data.buffer();
+        body.limit((int) OsqpData.byteSize(data.numVar(), data.numDual(), data.quadObjNnz(), data.linConNnz()));
+
+        try (var channel = FileChannel.open(path,
+                StandardOpenOption.CREATE,
+                StandardOpenOption.TRUNCATE_EXISTING,
+                StandardOpenOption.WRITE)) {
+            var buffers = new ByteBuffer[] { header, body };
+
+            while (body.hasRemaining())
+                channel.write(buffers);
+        }
+        catch (IOException ex) {
+            throw new UncheckedIOException(ex);
+        }
+    }
+
+    /**
+     * Maps a model file into memory.  The problem data remain in the
+     * mapped file, so they may be passed to {@link OsqpSolver#create} or
+     * loaded into a model without an intermediate copy.
+     *
+     * @param path the file to map.
+     *
+     * @return a read-only view of the file contents.
+     *
+     * @throws UncheckedIOException if the file cannot be read.
+     * @throws RuntimeException if the file is not a valid model file.
+     */
+    public static OsqpModelFile map(Path path) {
+        try (var channel = FileChannel.open(path, StandardOpenOption.READ)) {
+            var size = channel.size();
+
+            if (size < HEADER_SIZE)
+                throw new IllegalArgumentException("Not an OSQP model file.");
+
+            var buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, size).order(ByteOrder.nativeOrder());
+            var header = new Header(buffer);
+
+            if (size < header.fileSize())
+                throw new IllegalArgumentException("The model file is truncated.");
+
+            var params = new EnumMap<OsqpParam, Double>(OsqpParam.class);
+
+            for (var param : OsqpParam.values()) {
+                if (param.ordinal() < header.paramCount) {
+                    var value = buffer.getDouble(HEADER_SIZE + VALUE_SIZE * param.ordinal());
+
+                    if (!Double.isNaN(value))
+                        params.put(param, value);
+                }
+            }
+
+            buffer.position((int) header.dataOffset());
+
+            var data = OsqpData.wrap(buffer.slice(),
+                    header.numVar,
+                    header.numDual,
+                    header.quadObjNnz,
+                    header.linConNnz);
+
+            data.validate();
+            return new OsqpModelFile(header.numCon, data, params);
+        }
+        catch (IOException ex) {
+            throw new UncheckedIOException(ex);
+        }
+    }
+
+    /**
+     * Reads the header of a model file without mapping its contents.
+     *
+     * @param path the file to read.
+     *
+     * @return the header of the file.
+     */
+    static Header readHeader(Path path) {
+        try (var channel = FileChannel.open(path, StandardOpenOption.READ)) {
+            var buffer = ByteBuffer.allocate(HEADER_SIZE).order(ByteOrder.nativeOrder());
+
+            while (buffer.hasRemaining())
+                if (channel.read(buffer) < 0)
+                    throw new IllegalArgumentException("Not an OSQP model file.");
+
+            var header = new Header(buffer);
+
+            if (channel.size() < header.fileSize())
+                throw new IllegalArgumentException("The model file is truncated.");
+
+            return header;
+        }
+        catch (IOException ex) {
+            throw new UncheckedIOException(ex);
+        }
+    }
+
+    /**
+     * Solves the problems stored in several model files with one native
+     * call.  The native code maps each file and reads the problem data in
+     * place, so the data never enter the Java heap; the solutions are not
+     * retained.
+     *
+     * @param paths      the model files to solve.
+     * @param params     parameters that override those stored in every file.
+     * @param numThreads the number of worker threads to use.
+     *
+     * @return the solver statistics for each file, in the same order, or
+     * an empty optional for a file whose setup failed.
+     *
+     * @throws RuntimeException if a file cannot be read or is not a valid
+     * model file.
+     */
+    public static List<Optional<OsqpInfo>> solveAll(List<Path> paths, Map<OsqpParam, Double> params, int numThreads) {
+        if (numThreads < 1)
+            throw new IllegalArgumentException("Number of threads must be positive.");
+
+        var batch = new OsqpBatch(paths.size());
+
+        for (var path : paths) {
+            var header = readHeader(path);
+            batch.addFile(path.toString(), header.numVar, header.numDual, params);
+        }
+
+        batch.solve("", numThreads);
+
+        var results = new ArrayList<Optional<OsqpInfo>>(paths.size());
+
+        for (int index = 0; index < paths.size(); ++index)
+            results.add(Optional.ofNullable(batch.getInfo(index)));
+
+        return results;
+    }
+
+    /**
+     * Creates a new model holding the problem stored in this file.
+     * @return a new model holding the problem stored in this file.
+     */
+    public OsqpModel toModel() {
+        return OsqpModel.fromData(numCon, data, params);
+    }
+
+    /**
+     * Returns the number of linear constraints (not including the variable
+     * bounds).
+     *
+     * @return the number of linear constraints.
+     */
+    public int numCon() {
+        return numCon;
+    }
+
+    /**
+     * Returns the problem data, which are views of the mapped file.
+     * @return the problem data.
+     */
+    public OsqpData data() {
+        return data;
+    }
+
+    /**
+     * Returns the stored solver parameters.
+     * @return the stored solver parameters.
+     */
+    public Map<OsqpParam, Double> params() {
+        return new EnumMap<>(params);
+    }
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+/**
+ * A snapshot of the time spent inside the native adapter itself, as
+ * opposed to the solver: pinning and copying Java arrays, wrapping the
+ * sparse matrices, assigning settings, copying results back, and
+ * releasing arrays, alongside the calls into OSQP.
+ *
+ * <p>The instrumentation is disabled by default, in which case each timer
+ * costs a single relaxed load.  It may be enabled with {@link #enable} or
+ * the {@code com.d3x.osqp.nativeStats} system property.  The times are
+ * measured with a monotonic clock and accumulated by each native thread,
+ * then added to process-wide totals at the end of each native call.</p>
+ *
+ * <p>The snapshot also reports on the scratch memory arenas that each
+ * native thread keeps between calls: the number of native calls that used
+ * an arena (counted while the instrumentation is enabled), the number of
+ * arena blocks taken from the system allocator, and the largest number of
+ * bytes used by one call.  In the steady state the number of blocks stops
+ * growing.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpNativeStats {
+    private final long[] values;
+
+    /**
+     * Enumerates the timed phases, in the order of the native indexes
+     * (defined in d3x_osqp.h).
+     */
+    public enum Phase {
+        /** Pinning or copying Java arrays. */
+        GET_ARRAYS,
+
+        /** Wrapping Java arrays in sparse matrix structures. */
+        CREATE_CSC,
+
+        /** Allocating and assigning the solver settings. */
+        SETTINGS,
+
+        /** Calls to {@code osqp_setup}. */
+        SETUP,
+
+        /** Calls to {@code osqp_solve}. */
+        SOLVE,
+
+        /** Calls to the {@code osqp_update_*} functions. */
+        UPDATE,
+
+        /** Copying solutions and statistics back to Java. */
+        SET_REGION,
+
+        /** Releasing Java arrays and freeing the wrappers. */
+        RELEASE
+    }
+
+    /**
+     * The system property that enables the instrumentation at startup.
+     */
+    public static final String ENABLE_PROPERTY = "com.d3x.osqp.nativeStats";
+
+    // The arena statistics follow the phase counts and times, in the
+    // order of the native indexes (defined in d3x_osqp.h)...
+    private static final int ARENA_SCOPES = 2 * Phase.values().length;
+    private static final int ARENA_GROWTHS = ARENA_SCOPES + 1;
+    private static final int ARENA_PEAK_BYTES = ARENA_SCOPES + 2;
+    private static final int SIZE = ARENA_SCOPES + 3;
+
+    static {
+        System.loadLibrary("osqp");
+        System.loadLibrary("d3x-osqp");
+
+        if (Boolean.getBoolean(ENABLE_PROPERTY))
+            enableNative(true);
+    }
+
+    private OsqpNativeStats(long[] values) {
+        this.values = values;
+    }
+
+    /**
+     * Enables or disables the native instrumentation.
+     *
+     * @param enabled whether to time the native phases.
+     */
+    public static void enable(boolean enabled) {
+        enableNative(enabled);
+    }
+
+    /**
+     * Resets the process-wide totals to zero.
+     */
+    public static void reset() {
+        resetNative();
+    }
+
+    /**
+     * Returns the process-wide totals accumulated since startup or the
+     * last reset.
+     *
+     * @return a snapshot of the native totals.
+     */
+    public static OsqpNativeStats snapshot() {
+        var values = new long[SIZE];
+        readNative(values);
+        return new OsqpNativeStats(values);
+    }
+
+    /**
+     * Returns the number of times that a phase was timed.
+     *
+     * @param phase the phase of interest.
+     *
+     * @return the number of times that the phase was timed.
+     */
+    public long getCount(Phase phase) {
+        return values[2 * phase.ordinal()];
+    }
+
+    /**
+     * Returns the total time spent in a phase.
+     *
+     * @param phase the phase of interest.
+     *
+     * @return the total time spent in the phase, in nanoseconds.
+     */
+    public long getNanos(Phase phase) {
+        return values[2 * phase.ordinal() + 1];
+    }
+
+    /**
+     * Returns the number of native calls that used a scratch arena.
+     * @return the number of native calls that used a scratch arena.
+     */
+    public long getArenaCalls() {
+        return values[ARENA_SCOPES];
+    }
+
+    /**
+     * Returns the number of arena blocks taken from the system allocator.
+     * @return the number of arena blocks taken from the system allocator.
+     */
+    public long getArenaGrowths() {
+        return values[ARENA_GROWTHS];
+    }
+
+    /**
+     * Returns the largest number of arena bytes used by one native call.
+     * @return the largest number of arena bytes used by one native call.
+     */
+    public long getArenaPeakBytes() {
+        return values[ARENA_PEAK_BYTES];
+    }
+
+    /**
+     * Returns the difference between this snapshot and an earlier one.
+     * The arena peak is not a total, so the later value is kept.
+     *
+     * @param earlier the earlier snapshot.
+     *
+     * @return the counts and times accumulated between the snapshots.
+     */
+    public OsqpNativeStats minus(OsqpNativeStats earlier) {
+        var delta = new long[values.length];
+
+        for (int index = 0; index < values.length; ++index)
+            delta[index] = values[index] - earlier.values[index];
+
+        delta[ARENA_PEAK_BYTES] = values[ARENA_PEAK_BYTES];
+        return new OsqpNativeStats(delta);
+    }
+
+    @Override
+    public String toString() {
+        var builder = new StringBuilder("OsqpNativeStats(");
+
+        for (var phase : Phase.values()) {
+            if (phase.ordinal() > 0)
+                builder.append(", ");
+
+            builder.append(String.format("%s = %d / %.3f ms", phase, getCount(phase), 1.0E-06 * getNanos(phase)));
+        }
+
+        builder.append(String.format(", ARENA = %d calls / %d blocks / %d bytes peak",
+                getArenaCalls(), getArenaGrowths(), getArenaPeakBytes()));
+
+        return builder.append(")").toString();
+    }
+
+    private static native void enableNative(boolean enabled);
+
+    private static native void resetNative();
+
+    private static native void readNative(long[] values);
+}
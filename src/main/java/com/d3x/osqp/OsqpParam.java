@@ -15,19 +15,99 @@
  */
 package com.d3x.osqp;
 
+import java.util.Arrays;
+import java.util.Map;
+
 /**
  * Enumerates the parameters that may be passed to the OSQP solver.
+ * The declaration order must match the parameter indexes defined in the
+ * native library (d3x_osqp.h).
+ *
+ * <p>Parameters are passed to the native library as an array indexed by
+ * ordinal, with {@code Double.NaN} for those that keep their defaults.
+ * Integer and boolean settings are rounded to the nearest integer;
+ * boolean settings are enabled by {@code 1} and disabled by {@code 0}.</p>
  *
  * @author Scott Shaffer
  */
 public enum OsqpParam {
-    RHO,
-    SIGMA,
-    ALPHA,
-    POLISH,
-    MAX_ITER,
-    EPS_ABS,
-    EPS_REL,
-    EPS_PRIM_INF,
-    EPS_DUAL_INF;
+    RHO(true),
+    SIGMA(false),
+    ALPHA(true),
+    POLISH(true),
+    MAX_ITER(true),
+    EPS_ABS(true),
+    EPS_REL(true),
+    EPS_PRIM_INF(true),
+    EPS_DUAL_INF(true),
+    SCALING(false),
+    ADAPTIVE_RHO(false),
+    ADAPTIVE_RHO_INTERVAL(false),
+    ADAPTIVE_RHO_TOLERANCE(false),
+    ADAPTIVE_RHO_FRACTION(false), // Requires OSQP compiled with PROFILING
+    DELTA(true),
+    POLISH_REFINE_ITER(true),
+    VERBOSE(true),
+    SCALED_TERMINATION(true),
+    CHECK_TERMINATION(true),
+    WARM_START(true),
+    TIME_LIMIT(true), // Seconds; checked every few hundred iterations (every iteration with PROFILING)
+    LINSYS_SOLVER(false); // 0 = QDLDL, 1 = MKL Pardiso
+
+    private final boolean updatable;
+
+    OsqpParam(boolean updatable) {
+        this.updatable = updatable;
+    }
+
+    /**
+     * Identifies parameters that may be changed in an existing native
+     * workspace without repeating the setup.
+     *
+     * @return {@code true} iff this parameter may be updated in place.
+     */
+    public boolean isUpdatable() {
+        return updatable;
+    }
+
+    /**
+     * Identifies parameters that have an effect in this process: the
+     * adaptive step size fraction is ignored unless the native OSQP
+     * library was compiled with profiling enabled.
+     *
+     * @return {@code true} iff this parameter is honoured by the native
+     * library.
+     */
+    public boolean isAvailable() {
+        return this != ADAPTIVE_RHO_FRACTION || OsqpSolver.PROFILING;
+    }
+
+    /**
+     * Ensures that this parameter has an effect in this process.
+     *
+     * @throws IllegalStateException unless this parameter is available.
+     */
+    void requireAvailable() {
+        if (!isAvailable())
+            throw new IllegalStateException(String.format("Parameter [%s] requires OSQP compiled with PROFILING.", this));
+    }
+
+    /**
+     * Returns parameter values in the fixed layout passed to the native
+     * library.
+     *
+     * @param params the parameters to assign.
+     *
+     * @return an array indexed by ordinal, with {@code Double.NaN} for
+     * parameters that are not assigned.
+     */
+    static double[] toArray(Map<OsqpParam, Double> params) {
+        var values = new double[values().length];
+        Arrays.fill(values, Double.NaN);
+
+        for (var entry : params.entrySet())
+            values[entry.getKey().ordinal()] = entry.getValue();
+
+        return values;
+    }
 }
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+import java.util.List;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.CompletionException;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicLongArray;
+import java.util.concurrent.atomic.AtomicReference;
+import java.util.function.Consumer;
+import java.util.stream.Stream;
+
+/**
+ * Solves an unbounded sequence of models in three overlapping stages, so
+ * that a long stream of scenarios keeps every core busy without being
+ * collected in memory first.
+ *
+ * <ul>
+ *   <li>{@code MARSHAL}: the calling thread pulls each model from the
+ *   source and builds its sparse matrices.</li>
+ *   <li>{@code SOLVE}: a pool of solver threads solves the models.  Each
+ *   thread hands its native workspace from one model to the next whenever
+ *   they share a structure (see below), so consecutive scenarios skip the
+ *   setup and factorization and warm start from the previous iterate.</li>
+ *   <li>{@code DELIVER}: one delivery thread passes the solutions to the
+ *   consumer, in the order of the source.</li>
+ * </ul>
+ *
+ * <p>At most {@code capacity} models are in flight (pulled but not yet
+ * delivered) at any time; the calling thread waits for room before pulling
+ * the next model, so a slow solver or consumer throttles the source.</p>
+ *
+ * <p>A workspace passes between models with the same dimensions,
+ * parameters, precision, and matrix sparsity patterns (including the
+ * bounded variables) that are neither presolved nor solved by a specialized
+ * library; any other model gets a new workspace.  Either way, the models
+ * are left without a workspace when the pipeline returns, and remain
+ * usable.  A model may not be modified while it is in the pipeline.</p>
+ *
+ * <p>If the source, a solve, or the consumer throws an exception, the
+ * pipeline stops pulling models, discards the models in flight without
+ * delivering them, and rethrows the first exception.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpPipeline {
+    private final Consumer<OsqpSolution> sink;
+    private final int parallelism;
+    private final int capacity;
+
+    // Permits for the models in flight, taken before a model is pulled
+    // and returned after it is delivered...
+    private final Semaphore permits;
+
+    // The models waiting for a solver thread, and all the models in
+    // flight in source order; the permits bound both queues...
+    private final BlockingQueue<Task> work = new LinkedBlockingQueue<>();
+    private final BlockingQueue<Task> delivery = new LinkedBlockingQueue<>();
+
+    // The first exception thrown by any stage...
+    private final AtomicReference<Throwable> failure = new AtomicReference<>();
+
+    // The number of models, busy time, and waiting time for each stage,
+    // indexed by 3 * ordinal...
+    private final AtomicLongArray counters = new AtomicLongArray(3 * Stage.values().length);
+
+    private final AtomicLong reused = new AtomicLong();
+    private long peakInFlight = 0;
+
+    /**
+     * The default number of models in flight for each solver thread.
+     */
+    public static final int CAPACITY_PER_THREAD = 4;
+
+    /**
+     * Enumerates the pipeline stages.
+     */
+    public enum Stage {
+        /** Pulling models from the source and building their matrices. */
+        MARSHAL,
+
+        /** Solving models on the solver threads. */
+        SOLVE,
+
+        /** Passing solutions to the consumer. */
+        DELIVER
+    }
+
+    private static final class Task {
+        private final OsqpModel model;
+        private final CompletableFuture<OsqpSolution> result = new CompletableFuture<>();
+
+        private Task(OsqpModel model) {
+            this.model = model;
+        }
+    }
+
+    // Marks the end of the work and delivery queues...
+    private static final Task END = new Task(null);
+
+    private OsqpPipeline(Consumer<OsqpSolution> sink, int parallelism, int capacity) {
+        if (parallelism < 1)
+            throw new IllegalArgumentException("Parallelism must be positive.");
+
+        if (capacity < 1)
+            throw new IllegalArgumentException("Capacity must be positive.");
+
+        this.sink = sink;
+        this.parallelism = parallelism;
+        this.capacity = capacity;
+        this.permits = new Semaphore(capacity);
+    }
+
+    /**
+     * Solves a sequence of models with {@link #CAPACITY_PER_THREAD} models
+     * in flight for each solver thread.
+     *
+     * @param models      the models to solve.
+     * @param sink        the consumer of the solutions, called on the
+     *                    delivery thread in the order of the models.
+     * @param parallelism the number of solver threads.
+     *
+     * @return the statistics for each stage.
+     */
+    public static Stats solve(Iterator<OsqpModel> models, Consumer<OsqpSolution> sink, int parallelism) {
+        return solve(models, sink, parallelism, CAPACITY_PER_THREAD * parallelism);
+    }
+
+    /**
+     * Solves a stream of models with {@link #CAPACITY_PER_THREAD} models in
+     * flight for each solver thread.  The stream is consumed lazily, one
+     * model at a time.
+     *
+     * @param models      the models to solve.
+     * @param sink        the consumer of the solutions, called on the
+     *                    delivery thread in the order of the models.
+     * @param parallelism the number of solver threads.
+     *
+     * @return the statistics for each stage.
+     */
+    public static Stats solve(Stream<OsqpModel> models, Consumer<OsqpSolution> sink, int parallelism) {
+        return solve(models.iterator(), sink, parallelism);
+    }
+
+    /**
+     * Solves a sequence of models, returning when every solution has been
+     * delivered.
+     *
+     * @param models      the models to solve.
+     * @param sink        the consumer of the solutions, called on the
+     *                    delivery thread in the order of the models.
+     * @param parallelism the number of solver threads.
+     * @param capacity    the largest number of models in flight.
+     *
+     * @return the statistics for each stage.
+     *
+     * @throws RuntimeException the first exception thrown by the source, a
+     * solve, or the consumer.
+     */
+    public static Stats solve(Iterator<OsqpModel> models, Consumer<OsqpSolution> sink, int parallelism, int capacity) {
+        return new OsqpPipeline(sink, parallelism, capacity).run(models);
+    }
+
+    private Stats run(Iterator<OsqpModel> models) {
+        var threads = new ArrayList<Thread>(parallelism + 1);
+
+        for (int index = 0; index < parallelism; ++index)
+            threads.add(startThread(this::solveModels, "osqp-pipeline-solver-" + index));
+
+        threads.add(startThread(this::deliverSolutions, "osqp-pipeline-delivery"));
+
+        var start = System.nanoTime();
+
+        try {
+            pullModels(models);
+        }
+        catch (RuntimeException | Error ex) {
+            fail(ex);
+        }
+        catch (InterruptedException ex) {
+            Thread.currentThread().interrupt();
+            fail(new IllegalStateException("The pipeline was interrupted.", ex));
+        }
+        finally {
+            for (int index = 0; index < parallelism; ++index)
+                work.add(END);
+
+            delivery.add(END);
+            joinAll(threads);
+        }
+
+        var elapsed = System.nanoTime() - start;
+        var thrown = failure.get();
+
+        if (thrown instanceof RuntimeException)
+            throw (RuntimeException) thrown;
+        else if (thrown instanceof Error)
+            throw (Error) thrown;
+        else if (thrown != null)
+            throw new IllegalStateException(thrown);
+
+        return new Stats(this, elapsed);
+    }
+
+    private static Thread startThread(Runnable runnable, String name) {
+        var thread = new Thread(runnable, name);
+        thread.setDaemon(true);
+        thread.start();
+        return thread;
+    }
+
+    private static void joinAll(List<Thread> threads) {
+        var interrupted = false;
+
+        for (var thread : threads) {
+            while (thread.isAlive()) {
+                try {
+                    thread.join();
+                }
+                catch (InterruptedException ex) {
+                    interrupted = true;
+                }
+            }
+        }
+
+        if (interrupted)
+            Thread.currentThread().interrupt();
+    }
+
+    private void fail(Throwable thrown) {
+        failure.compareAndSet(null, thrown);
+    }
+
+    private boolean failed() {
+        return failure.get() != null;
+    }
+
+    private void record(Stage stage, long waitStart, long busyStart) {
+        var now = System.nanoTime();
+        var index = 3 * stage.ordinal();
+
+        counters.incrementAndGet(index);
+        counters.addAndGet(index + 1, now - busyStart);
+        counters.addAndGet(index + 2, busyStart - waitStart);
+    }
+
+    private void pullModels(Iterator<OsqpModel> models) throws InterruptedException {
+        while (!failed()) {
+            var waitStart = System.nanoTime();
+            permits.acquire();
+            var busyStart = System.nanoTime();
+
+            if (failed() || !models.hasNext()) {
+                permits.release();
+                return;
+            }
+
+            var model = models.next();
+            model.marshal();
+
+            var task = new Task(model);
+            delivery.add(task);
+            work.add(task);
+
+            peakInFlight = Math.max(peakInFlight, capacity - permits.availablePermits());
+            record(Stage.MARSHAL, waitStart, busyStart);
+        }
+    }
+
+    // Each solver thread keeps the workspace of the model that it solved
+    // last, to give to the next model...
+    private void solveModels() {
+        OsqpModel previous = null;
+
+        try {
+            while (true) {
+                var waitStart = System.nanoTime();
+                var task = work.take();
+                var busyStart = System.nanoTime();
+
+                if (task == END)
+                    break;
+
+                // Models in flight after a failure are discarded...
+                if (failed()) {
+                    task.result.complete(null);
+                    continue;
+                }
+
+                try {
+                    if (previous != null && task.model.adoptSolver(previous))
+                        reused.incrementAndGet();
+
+                    previous = task.model;
+                    task.model.solve();
+                    task.result.complete(task.model.getSolution());
+                }
+                catch (RuntimeException | Error ex) {
+                    task.result.completeExceptionally(ex);
+                }
+
+                record(Stage.SOLVE, waitStart, busyStart);
+            }
+        }
+        catch (InterruptedException ex) {
+            fail(new IllegalStateException("The pipeline was interrupted.", ex));
+        }
+        finally {
+            if (previous != null)
+                previous.close();
+        }
+    }
+
+    // The delivery thread keeps draining the queue after a failure, so that
+    // the calling thread always gets its permits back...
+    private void deliverSolutions() {
+        try {
+            while (true) {
+                var waitStart = System.nanoTime();
+                var task = delivery.take();
+
+                if (task == END)
+                    break;
+
+                OsqpSolution solution = null;
+
+                try {
+                    solution = task.result.join();
+                }
+                catch (CompletionException ex) {
+                    fail(ex.getCause());
+                }
+
+                var busyStart = System.nanoTime();
+
+                try {
+                    if (solution != null && !failed()) {
+                        sink.accept(solution);
+                        record(Stage.DELIVER, waitStart, busyStart);
+                    }
+                }
+                catch (RuntimeException | Error ex) {
+                    fail(ex);
+                }
+                finally {
+                    permits.release();
+                }
+            }
+        }
+        catch (InterruptedException ex) {
+            fail(new IllegalStateException("The pipeline was interrupted.", ex));
+        }
+    }
+
+    /**
+     * The throughput of each stage of one pipeline run: the number of
+     * models that passed through it, the time that it spent working on
+     * them, and the time that it spent waiting for them (for the permits of
+     * the models in flight, for {@code MARSHAL}).  The times of the
+     * {@code SOLVE} stage are summed over the solver threads.
+     */
+    public static final class Stats {
+        private final long[] values;
+        private final long elapsedNanos;
+        private final long reusedWorkspaces;
+        private final long peakInFlight;
+
+        private Stats(OsqpPipeline pipeline, long elapsedNanos) {
+            this.values = new long[pipeline.counters.length()];
+            this.elapsedNanos = elapsedNanos;
+            this.reusedWorkspaces = pipeline.reused.get();
+            this.peakInFlight = pipeline.peakInFlight;
+
+            for (int index = 0; index < values.length; ++index)
+                values[index] = pipeline.counters.get(index);
+        }
+
+        /**
+         * Returns the number of models that passed through a stage.
+         *
+         * @param stage the stage of interest.
+         *
+         * @return the number of models that passed through the stage.
+         */
+        public long getCount(Stage stage) {
+            return values[3 * stage.ordinal()];
+        }
+
+        /**
+         * Returns the time that a stage spent working on models.
+         *
+         * @param stage the stage of interest.
+         *
+         * @return the busy time of the stage, in nanoseconds.
+         */
+        public long getBusyNanos(Stage stage) {
+            return values[3 * stage.ordinal() + 1];
+        }
+
+        /**
+         * Returns the time that a stage spent waiting for models.
+         *
+         * @param stage the stage of interest.
+         *
+         * @return the waiting time of the stage, in nanoseconds.
+         */
+        public long getWaitNanos(Stage stage) {
+            return values[3 * stage.ordinal() + 2];
+        }
+
+        /**
+         * Returns the number of models that a stage processes per second of
+         * busy time (on each thread, for {@code SOLVE}).
+         *
+         * @param stage the stage of interest.
+         *
+         * @return the throughput of the stage, in models per second.
+         */
+        public double getThroughput(Stage stage) {
+            var busy = getBusyNanos(stage);
+            return busy > 0 ? 1.0E+09 * getCount(stage) / busy : Double.NaN;
+        }
+
+        /**
+         * Returns the wall-clock time of the pipeline run.
+         * @return the wall-clock time of the pipeline run, in nanoseconds.
+         */
+        public long getElapsedNanos() {
+            return elapsedNanos;
+        }
+
+        /**
+         * Returns the number of models that adopted the workspace of the
+         * model solved before them.
+         *
+         * @return the number of models that skipped the native setup.
+         */
+        public long getReusedWorkspaces() {
+            return reusedWorkspaces;
+        }
+
+        /**
+         * Returns the largest number of models in flight at once.
+         * @return the largest number of models in flight at once.
+         */
+        public long getPeakInFlight() {
+            return peakInFlight;
+        }
+
+        @Override
+        public String toString() {
+            var builder = new StringBuilder("OsqpPipeline.Stats(");
+
+            for (var stage : Stage.values()) {
+                builder.append(String.format("%s = %d / %.3f ms busy / %.3f ms waiting, ",
+                        stage, getCount(stage), 1.0E-06 * getBusyNanos(stage), 1.0E-06 * getWaitNanos(stage)));
+            }
+
+            builder.append(String.format("elapsed = %.3f ms, reused = %d, peak = %d",
+                    1.0E-06 * elapsedNanos, reusedWorkspaces, peakInFlight));
+
+            return builder.append(")").toString();
+        }
+    }
+}
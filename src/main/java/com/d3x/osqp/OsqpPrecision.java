@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+/**
+ * Enumerates the floating-point precisions in which OSQP may solve a
+ * problem.
+ *
+ * <p>The default, double precision, uses the standard adapter library.
+ * Single precision uses a second adapter library linked against an OSQP
+ * build with {@code DFLOAT} defined ({@code libd3x-osqp-single}, built by
+ * {@code bin/build.sh} when {@code SINGLE_OSQP_DIR} is assigned).  The
+ * problem data and results are converted between {@code double} and
+ * {@code float} at the native boundary, so the Java API is unchanged.
+ * Single precision halves the memory traffic of the ADMM iterations and
+ * the factorization, at the cost of accuracy: tolerances much tighter than
+ * {@code 1.0E-05} (relative) may not be attainable.  Its availability is
+ * detected once, when the library is first needed.</p>
+ *
+ * @author Scott Shaffer
+ */
+public enum OsqpPrecision {
+    DOUBLE,
+    SINGLE;
+
+    /**
+     * Identifies precisions that may be used in this process.
+     * @return {@code true} iff the adapter library for this precision may
+     * be loaded in this process.
+     */
+    public boolean isAvailable() {
+        return this == DOUBLE || OsqpSingle.AVAILABLE;
+    }
+
+    /**
+     * Ensures that this precision may be used in this process.
+     *
+     * @throws IllegalStateException unless this precision is available.
+     */
+    void requireAvailable() {
+        if (!isAvailable())
+            throw new IllegalStateException("The single-precision OSQP library is not available.");
+    }
+}
@@ -0,0 +1,552 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.util.Arrays;
+import java.util.HashMap;
+
+/**
+ * Reduces a model before it is sent to the native solver, and maps the
+ * solution of the reduced problem back to the model.  The reduction:
+ *
+ * <ul>
+ *     <li>substitutes the fixed variables (those with equal finite bounds)
+ *     into the objective and the constraint bounds;</li>
+ *     <li>removes the empty columns (variables with no quadratic term
+ *     involving another free variable and no constraint coefficients), whose
+ *     optimal values follow from the sign of their linear coefficients;</li>
+ *     <li>drops the feasible constraints that have no coefficients on the
+ *     remaining variables; and</li>
+ *     <li>merges duplicate constraints (with identical coefficients) into
+ *     one row with the intersection of their bounds.</li>
+ * </ul>
+ *
+ * <p>The reduced problem is held in the solver layout (see
+ * {@link OsqpBoundRows}).  The dual values of the dropped and duplicate
+ * rows are zero, and the reduced costs of the removed variables are
+ * recovered from the stationarity condition {@code Px + q + A'y = 0}.</p>
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpPresolve {
+    private final int numVar;
+    private final int numCon;
+    private final int[] keptVars;
+    private final int[] keptRows;
+    private final double[] removedValues;
+
+    private final double[] linObjCoeff;
+    private final OsqpMatrix quadObj;
+    private final OsqpMatrix conCoeff;
+
+    private final OsqpBoundRows boundRows;
+    private final double[] reducedLinObj;
+    private final OsqpMatrix reducedQuadObj;
+    private final OsqpMatrix reducedLinCon;
+    private final double[] reducedLower;
+    private final double[] reducedUpper;
+    private final double objectiveOffset;
+
+    // Empty constraints whose bounds contain zero to within this tolerance
+    // are dropped...
+    private static final double TOLERANCE = 1.0E-12;
+
+    private OsqpPresolve(int numVar,
+                         int numCon,
+                         int[] keptVars,
+                         int[] keptRows,
+                         double[] removedValues,
+                         double[] linObjCoeff,
+                         OsqpMatrix quadObj,
+                         OsqpMatrix conCoeff,
+                         OsqpBoundRows boundRows,
+                         double[] reducedLinObj,
+                         OsqpMatrix reducedQuadObj,
+                         OsqpMatrix reducedLinCon,
+                         double[] reducedLower,
+                         double[] reducedUpper,
+                         double objectiveOffset) {
+        this.numVar = numVar;
+        this.numCon = numCon;
+        this.keptVars = keptVars;
+        this.keptRows = keptRows;
+        this.removedValues = removedValues;
+        this.linObjCoeff = linObjCoeff;
+        this.quadObj = quadObj;
+        this.conCoeff = conCoeff;
+        this.boundRows = boundRows;
+        this.reducedLinObj = reducedLinObj;
+        this.reducedQuadObj = reducedQuadObj;
+        this.reducedLinCon = reducedLinCon;
+        this.reducedLower = reducedLower;
+        this.reducedUpper = reducedUpper;
+        this.objectiveOffset = objectiveOffset;
+    }
+
+    /**
+     * Reduces a model.
+     *
+     * @param linObjCoeff the linear objective coefficients.
+     * @param quadObj     the quadratic objective matrix (upper triangle).
+     * @param conCoeff    the linear constraint matrix ({@code numCon} rows).
+     * @param lower       the lower bounds in the model layout.
+     * @param upper       the upper bounds in the model layout.
+     * @param maxBound    the magnitude at or above which a bound is infinite.
+     *
+     * @return the reduced problem.
+     */
+    static OsqpPresolve of(double[] linObjCoeff,
+                           OsqpMatrix quadObj,
+                           OsqpMatrix conCoeff,
+                           double[] lower,
+                           double[] upper,
+                           double maxBound) {
+        var numVar = conCoeff.ncol;
+        var numCon = conCoeff.nrow;
+        var removed = findRemovedVars(numCon, numVar, linObjCoeff, quadObj, conCoeff, lower, upper, maxBound);
+
+        var colMap = new int[numVar];
+        var numKept = 0;
+
+        for (int var = 0; var < numVar; ++var)
+            colMap[var] = Double.isNaN(removed[var]) ? numKept++ : -1;
+
+        var keptVars = new int[numKept];
+
+        for (int var = 0; var < numVar; ++var)
+            if (colMap[var] >= 0)
+                keptVars[colMap[var]] = var;
+
+        // Substitute the removed variables into the objective and the
+        // constraint bounds...
+        var fixed = new double[numVar];
+
+        for (int var = 0; var < numVar; ++var)
+            fixed[var] = colMap[var] < 0 ? removed[var] : 0.0;
+
+        var quadShift = quadObj.multiplySymmetric(fixed);
+        var conShift = conCoeff.multiply(fixed);
+
+        // The removed variables contribute q_f'x_f + x_f'P_ff x_f / 2 to the
+        // objective, which the reduced problem leaves out...
+        var objectiveOffset = 0.0;
+
+        for (int var = 0; var < numVar; ++var)
+            objectiveOffset += fixed[var] * (linObjCoeff[var] + 0.5 * quadShift[var]);
+        var conLower = new double[numCon];
+        var conUpper = new double[numCon];
+
+        for (int con = 0; con < numCon; ++con) {
+            conLower[con] = lower[con] > -maxBound ? lower[con] - conShift[con] : lower[con];
+            conUpper[con] = upper[con] < maxBound ? upper[con] - conShift[con] : upper[con];
+        }
+
+        var identity = new int[numCon];
+
+        for (int con = 0; con < numCon; ++con)
+            identity[con] = con;
+
+        var rowMap = findKeptRows(conCoeff.select(identity, numCon, colMap, numKept), conLower, conUpper);
+        var numRow = 0;
+
+        for (int con = 0; con < numCon; ++con)
+            if (rowMap[con] >= 0)
+                ++numRow;
+
+        var keptRows = new int[numRow];
+
+        for (int con = 0; con < numCon; ++con)
+            if (rowMap[con] >= 0)
+                keptRows[rowMap[con]] = con;
+
+        // The reduced problem in the model layout, then the solver layout...
+        var reducedLinObj = new double[numKept];
+        var modelLower = new double[numRow + numKept];
+        var modelUpper = new double[numRow + numKept];
+
+        for (int row = 0; row < numRow; ++row) {
+            modelLower[row] = conLower[keptRows[row]];
+            modelUpper[row] = conUpper[keptRows[row]];
+        }
+
+        for (int col = 0; col < numKept; ++col) {
+            var var = keptVars[col];
+            reducedLinObj[col] = linObjCoeff[var] + quadShift[var];
+            modelLower[numRow + col] = lower[numCon + var];
+            modelUpper[numRow + col] = upper[numCon + var];
+        }
+
+        var boundRows = OsqpBoundRows.of(numRow, numKept, modelLower, modelUpper, maxBound);
+        var reducedQuadObj = quadObj.select(colMap, numKept, colMap, numKept);
+        var reducedLinCon = boundRows.stack(conCoeff.select(rowMap, numRow, colMap, numKept));
+
+        return new OsqpPresolve(
+                numVar,
+                numCon,
+                keptVars,
+                keptRows,
+                removed,
+                linObjCoeff.clone(),
+                quadObj,
+                conCoeff,
+                boundRows,
+                reducedLinObj,
+                reducedQuadObj,
+                reducedLinCon,
+                boundRows.gather(modelLower),
+                boundRows.gather(modelUpper),
+                objectiveOffset);
+    }
+
+    // Returns the values of the removed variables, with NaN for the
+    // variables that remain in the reduced problem...
+    private static double[] findRemovedVars(int numCon,
+                                            int numVar,
+                                            double[] linObjCoeff,
+                                            OsqpMatrix quadObj,
+                                            OsqpMatrix conCoeff,
+                                            double[] lower,
+                                            double[] upper,
+                                            double maxBound) {
+        var removed = new double[numVar];
+        var fixed = new double[numVar];
+        var numRemoved = 0;
+
+        for (int var = 0; var < numVar; ++var) {
+            var lo = lower[numCon + var];
+            var hi = upper[numCon + var];
+
+            if (lo == hi && Math.abs(lo) < maxBound) {
+                removed[var] = lo;
+                fixed[var] = lo;
+                ++numRemoved;
+            }
+            else {
+                removed[var] = Double.NaN;
+            }
+        }
+
+        // Count the quadratic terms that couple each variable to the free
+        // variables; the terms with fixed variables become linear...
+        var quadShift = quadObj.multiplySymmetric(fixed);
+        var coupling = new int[numVar];
+
+        for (int col = 0; col < numVar; ++col) {
+            var end = (int) quadObj.colptr[col + 1];
+
+            for (int k = (int) quadObj.colptr[col]; k < end; ++k) {
+                var row = (int) quadObj.rowind[k];
+
+                if (Double.isNaN(removed[row]) && Double.isNaN(removed[col])) {
+                    ++coupling[row];
+
+                    if (row != col)
+                        ++coupling[col];
+                }
+            }
+        }
+
+        for (int var = 0; var < numVar; ++var) {
+            if (!Double.isNaN(removed[var]) || coupling[var] > 0 || conCoeff.colptr[var + 1] > conCoeff.colptr[var])
+                continue;
+
+            var value = emptyColumnValue(
+                    linObjCoeff[var] + quadShift[var],
+                    lower[numCon + var],
+                    upper[numCon + var],
+                    maxBound);
+
+            if (!Double.isNaN(value)) {
+                removed[var] = value;
+                ++numRemoved;
+            }
+        }
+
+        // The native solver requires at least one variable, so a problem
+        // that would be reduced to nothing keeps all of its variables...
+        if (numRemoved == numVar)
+            Arrays.fill(removed, Double.NaN);
+
+        return removed;
+    }
+
+    // An empty column minimizes a linear term on its own, so its optimal
+    // value is the bound that the objective favors (or NaN if that bound
+    // is infinite, which leaves the unboundedness for the solver)...
+    private static double emptyColumnValue(double linCoeff, double lower, double upper, double maxBound) {
+        if (linCoeff > 0.0)
+            return lower > -maxBound ? lower : Double.NaN;
+        else if (linCoeff < 0.0)
+            return upper < maxBound ? upper : Double.NaN;
+        else if (lower > 0.0)
+            return lower;
+        else if (upper < 0.0)
+            return upper;
+        else
+            return 0.0;
+    }
+
+    // Returns the new index of each constraint row, or -1 for the rows that
+    // are dropped; the bounds of duplicate rows are merged into the first
+    // row of each group...
+    private static int[] findKeptRows(OsqpMatrix linCon, double[] conLower, double[] conUpper) {
+        var numCon = linCon.nrow;
+        var rowStart = new int[numCon + 1];
+
+        for (int k = 0; k < linCon.nnz; ++k)
+            ++rowStart[(int) linCon.rowind[k] + 1];
+
+        for (int row = 0; row < numCon; ++row)
+            rowStart[row + 1] += rowStart[row];
+
+        // Transpose the coefficients, leaving the columns sorted within
+        // each row...
+        var rowCols = new int[linCon.nnz];
+        var rowValues = new double[linCon.nnz];
+        var next = Arrays.copyOf(rowStart, numCon);
+
+        for (int col = 0; col < linCon.ncol; ++col) {
+            var end = (int) linCon.colptr[col + 1];
+
+            for (int k = (int) linCon.colptr[col]; k < end; ++k) {
+                var row = (int) linCon.rowind[k];
+                rowCols[next[row]] = col;
+                rowValues[next[row]] = linCon.values[k];
+                ++next[row];
+            }
+        }
+
+        // Rows with the same hash are chained, most recent first...
+        var rowMap = new int[numCon];
+        var sameHash = new int[numCon];
+        var lastRows = new HashMap<Integer, Integer>();
+        var numKept = 0;
+
+        for (int row = 0; row < numCon; ++row) {
+            var start = rowStart[row];
+            var end = rowStart[row + 1];
+
+            if (start == end) {
+                if (conLower[row] <= TOLERANCE && conUpper[row] >= -TOLERANCE) {
+                    rowMap[row] = -1;
+                }
+                else {
+                    // Infeasible empty rows are left for the solver to report...
+                    rowMap[row] = numKept++;
+                }
+
+                continue;
+            }
+
+            var hash = rowHash(rowCols, rowValues, start, end);
+            var first = lastRows.getOrDefault(hash, -1);
+
+            while (first >= 0
+                    && !(Arrays.equals(rowCols, start, end, rowCols, rowStart[first], rowStart[first + 1])
+                    && Arrays.equals(rowValues, start, end, rowValues, rowStart[first], rowStart[first + 1])))
+                first = sameHash[first];
+
+            if (first >= 0) {
+                var mergedLower = Math.max(conLower[first], conLower[row]);
+                var mergedUpper = Math.min(conUpper[first], conUpper[row]);
+
+                // Conflicting bounds are left for the solver to report...
+                if (mergedLower <= mergedUpper) {
+                    conLower[first] = mergedLower;
+                    conUpper[first] = mergedUpper;
+                    rowMap[row] = -1;
+                    continue;
+                }
+            }
+
+            sameHash[row] = lastRows.getOrDefault(hash, -1);
+            lastRows.put(hash, row);
+            rowMap[row] = numKept++;
+        }
+
+        return rowMap;
+    }
+
+    private static int rowHash(int[] cols, double[] values, int start, int end) {
+        var hash = 1;
+
+        for (int k = start; k < end; ++k)
+            hash = 31 * (31 * hash + cols[k]) + Double.hashCode(values[k]);
+
+        return hash;
+    }
+
+    /**
+     * Returns the number of decision variables in the reduced problem.
+     * @return the number of decision variables in the reduced problem.
+     */
+    int numVar() {
+        return keptVars.length;
+    }
+
+    /**
+     * Returns the number of rows in the reduced problem (solver layout).
+     * @return the number of rows in the reduced problem.
+     */
+    int numRows() {
+        return boundRows.numRows();
+    }
+
+    /**
+     * Returns the number of variables removed by the reduction.
+     * @return the number of variables removed by the reduction.
+     */
+    int countRemovedVars() {
+        return numVar - keptVars.length;
+    }
+
+    /**
+     * Returns the number of linear constraints removed by the reduction.
+     * @return the number of linear constraints removed by the reduction.
+     */
+    int countRemovedRows() {
+        return numCon - keptRows.length;
+    }
+
+    /**
+     * Returns the linear objective coefficients of the reduced problem.
+     * @return the linear objective coefficients of the reduced problem.
+     */
+    double[] linObjCoeff() {
+        return reducedLinObj;
+    }
+
+    /**
+     * Returns the quadratic objective matrix of the reduced problem.
+     * @return the quadratic objective matrix of the reduced problem.
+     */
+    OsqpMatrix quadObj() {
+        return reducedQuadObj;
+    }
+
+    /**
+     * Returns the constraint matrix of the reduced problem.
+     * @return the constraint matrix of the reduced problem.
+     */
+    OsqpMatrix linCon() {
+        return reducedLinCon;
+    }
+
+    /**
+     * Returns the lower bounds of the reduced problem.
+     * @return the lower bounds of the reduced problem.
+     */
+    double[] lower() {
+        return reducedLower;
+    }
+
+    /**
+     * Returns the upper bounds of the reduced problem.
+     * @return the upper bounds of the reduced problem.
+     */
+    double[] upper() {
+        return reducedUpper;
+    }
+
+    /**
+     * Returns the constant that the removed variables add to the objective
+     * value of the reduced problem.
+     *
+     * @return the objective of the model less that of the reduced problem.
+     */
+    double objectiveOffset() {
+        return objectiveOffset;
+    }
+
+    /**
+     * Converts a primal vector from the model to the reduced problem.
+     *
+     * @param primal a primal vector for the model.
+     *
+     * @return the primal vector for the reduced problem.
+     */
+    double[] gatherPrimal(double[] primal) {
+        var reduced = new double[keptVars.length];
+
+        for (int col = 0; col < keptVars.length; ++col)
+            reduced[col] = primal[keptVars[col]];
+
+        return reduced;
+    }
+
+    /**
+     * Converts a dual vector from the model layout to the solver layout of
+     * the reduced problem.
+     *
+     * @param dual a dual vector in the model layout.
+     *
+     * @return the dual vector in the solver layout of the reduced problem.
+     */
+    double[] gatherDual(double[] dual) {
+        var numRow = keptRows.length;
+        var reduced = new double[numRow + keptVars.length];
+
+        for (int row = 0; row < numRow; ++row)
+            reduced[row] = dual[keptRows[row]];
+
+        for (int col = 0; col < keptVars.length; ++col)
+            reduced[numRow + col] = dual[numCon + keptVars[col]];
+
+        return boundRows.gather(reduced);
+    }
+
+    /**
+     * Converts a solution of the reduced problem to a solution of the model.
+     *
+     * @param solverPrimal the primal solution of the reduced problem.
+     * @param solverDual   the dual solution of the reduced problem, in the
+     *                     solver layout.
+     * @param primal       the array to receive the primal solution.
+     * @param dual         the array to receive the dual solution, in the
+     *                     model layout.
+     */
+    void scatter(double[] solverPrimal, double[] solverDual, double[] primal, double[] dual) {
+        var numRow = keptRows.length;
+        var reduced = new double[numRow + keptVars.length];
+        boundRows.scatter(solverDual, reduced, 0.0);
+
+        System.arraycopy(removedValues, 0, primal, 0, numVar);
+        Arrays.fill(dual, 0, numCon + numVar, 0.0);
+
+        for (int col = 0; col < keptVars.length; ++col) {
+            primal[keptVars[col]] = solverPrimal[col];
+            dual[numCon + keptVars[col]] = reduced[numRow + col];
+        }
+
+        for (int row = 0; row < numRow; ++row)
+            dual[keptRows[row]] = reduced[row];
+
+        // The reduced costs of the removed variables satisfy the
+        // stationarity condition Px + q + A'y + z = 0...
+        var gradient = quadObj.multiplySymmetric(primal);
+        var conDual = conCoeff.multiplyTranspose(Arrays.copyOf(dual, numCon));
+
+        for (int var = 0; var < numVar; ++var)
+            if (!Double.isNaN(removedValues[var]))
+                dual[numCon + var] = -(gradient[var] + linObjCoeff[var] + conDual[var]);
+    }
+
+    @Override
+    public String toString() {
+        return String.format("OsqpPresolve(vars = %d -> %d, rows = %d -> %d)",
+                numVar, keptVars.length, numCon, keptRows.length);
+    }
+}
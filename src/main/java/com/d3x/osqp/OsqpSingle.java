@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.nio.ByteBuffer;
+import java.nio.DoubleBuffer;
+import java.nio.LongBuffer;
+
+/**
+ * Declares the native methods of the single-precision adapter library,
+ * which mirror those of {@link OsqpSolver} and take the same arguments;
+ * the library registers its functions for these methods when it is loaded.
+ * The native handles refer to single-precision workspaces, which may only
+ * be passed back to this class.
+ *
+ * @author Scott Shaffer
+ */
+final class OsqpSingle {
+    /**
+     * Whether the single-precision adapter library was loaded.
+     */
+    static final boolean AVAILABLE = load();
+
+    private OsqpSingle() {
+    }
+
+    private static boolean load() {
+        try {
+            System.loadLibrary("d3x-osqp-single");
+            return true;
+        }
+        catch (UnsatisfiedLinkError error) {
+            return false;
+        }
+    }
+
+    // OSQP uses long as the integer type so all "integer"
+    // arguments are defined as longs...
+    static native long setup(
+            long     numVar,
+            long     numDual,
+            String   logFile,
+            double[] linObjCoeff,
+            long[]   quadObjColPtr,
+            long[]   quadObjRowInd,
+            double[] quadObjCoeff,
+            long[]   linConColPtr,
+            long[]   linConRowInd,
+            double[] linConCoeff,
+            double[] linConLower,
+            double[] linConUpper,
+            double[] paramValues);
+
+    static native long setupDirect(
+            long         numVar,
+            long         numDual,
+            String       logFile,
+            DoubleBuffer linObjCoeff,
+            LongBuffer   quadObjColPtr,
+            LongBuffer   quadObjRowInd,
+            DoubleBuffer quadObjCoeff,
+            LongBuffer   linConColPtr,
+            LongBuffer   linConRowInd,
+            DoubleBuffer linConCoeff,
+            DoubleBuffer linConLower,
+            DoubleBuffer linConUpper,
+            double[]     paramValues);
+
+    static native int solve(
+            long       handle,
+            String     logFile,
+            double[]   optPrimal,
+            double[]   optDual,
+            double[]   solveInfo,
+            ByteBuffer cancelFlag,
+            double     timeLimit);
+
+    static native void sweep(
+            long       handle,
+            String     logFile,
+            int        count,
+            double[]   linObjCoeff,
+            double[]   linConLower,
+            double[]   linConUpper,
+            double[]   optPrimal,
+            double[]   optDual,
+            int[]      status,
+            ByteBuffer cancelFlag,
+            double     timeLimit);
+
+    static native int updateLinCost(long handle, double[] linObjCoeff);
+
+    static native int updateBounds(long handle, double[] linConLower, double[] linConUpper);
+
+    static native int updateLowerBound(long handle, double[] linConLower);
+
+    static native int updateUpperBound(long handle, double[] linConUpper);
+
+    static native int updateSettings(long handle, double[] paramValues);
+
+    static native int updateMatrices(
+            long     handle,
+            double[] quadObjCoeff,
+            long[]   quadObjIndex,
+            double[] linConCoeff,
+            long[]   linConIndex);
+
+    static native int warmStart(long handle, double[] primal, double[] dual);
+
+    static native int evaluate(long handle, double[] primal, double[] values);
+
+    static native void cleanup(long handle);
+}
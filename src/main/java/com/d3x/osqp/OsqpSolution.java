@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.nio.DoubleBuffer;
+import java.util.Arrays;
+import java.util.Optional;
+
+/**
+ * An immutable snapshot of the solution of a quadratic program: the status
+ * and statistics, the optimal primal values, the dual values for the linear
+ * constraints, and the reduced costs for the decision variables.
+ *
+ * <p>The accessors do not allocate: the vectors may be read element by
+ * element, copied into arrays owned by the caller, or viewed through
+ * read-only buffers (each call returns a new view over the same storage).
+ * The vectors hold {@code Double.NaN} values unless the problem was solved.
+ * The objective value is computed on first use.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpSolution {
+    private final int numVar;
+    private final int numCon;
+    private final OsqpStatus status;
+    private final OsqpInfo info;
+    private final double[] primal;
+    private final double[] dual;
+    private final double[] linObjCoeff;
+    private final OsqpMatrix quadObj;
+
+    // The objective value, or NaN until it has been computed; the
+    // computation is idempotent, so a race only repeats it...
+    private volatile double objective = Double.NaN;
+
+    private OsqpSolution(int numVar,
+                         int numCon,
+                         OsqpStatus status,
+                         OsqpInfo info,
+                         double[] primal,
+                         double[] dual,
+                         double[] linObjCoeff,
+                         OsqpMatrix quadObj) {
+        this.numVar = numVar;
+        this.numCon = numCon;
+        this.status = status;
+        this.info = info;
+        this.primal = primal;
+        this.dual = dual;
+        this.linObjCoeff = linObjCoeff;
+        this.quadObj = quadObj;
+    }
+
+    /**
+     * Creates a solution snapshot, copying the vectors.
+     *
+     * @param numCon      the number of linear constraints.
+     * @param status      the solution status.
+     * @param info        the solver statistics (or {@code null}).
+     * @param primal      the primal solution (length {@code numVar}).
+     * @param dual        the dual solution in the model layout: the linear
+     *                    constraints followed by the variable bounds.
+     * @param linObjCoeff the linear objective coefficients.
+     * @param quadObj     the quadratic objective matrix (upper triangle).
+     *
+     * @return the solution snapshot.
+     */
+    static OsqpSolution of(int numCon,
+                           OsqpStatus status,
+                           OsqpInfo info,
+                           double[] primal,
+                           double[] dual,
+                           double[] linObjCoeff,
+                           OsqpMatrix quadObj) {
+        var numVar = primal.length;
+        var primalCopy = new double[numVar];
+        var dualCopy = new double[dual.length];
+
+        if (status.equals(OsqpStatus.SOLVED)) {
+            System.arraycopy(primal, 0, primalCopy, 0, numVar);
+            System.arraycopy(dual, 0, dualCopy, 0, dual.length);
+        }
+        else {
+            Arrays.fill(primalCopy, Double.NaN);
+            Arrays.fill(dualCopy, Double.NaN);
+        }
+
+        return new OsqpSolution(numVar, numCon, status, info, primalCopy, dualCopy, linObjCoeff.clone(), quadObj);
+    }
+
+    /**
+     * Returns the solution status.
+     * @return the solution status.
+     */
+    public OsqpStatus getStatus() {
+        return status;
+    }
+
+    /**
+     * Identifies solutions that are optimal to within the solver tolerances.
+     * @return {@code true} iff the problem was solved.
+     */
+    public boolean isSolved() {
+        return status.equals(OsqpStatus.SOLVED);
+    }
+
+    /**
+     * Returns the solver statistics.
+     * @return the solver statistics, or an empty optional if the native
+     * setup failed.
+     */
+    public Optional<OsqpInfo> getInfo() {
+        return Optional.ofNullable(info);
+    }
+
+    /**
+     * Returns the number of decision variables.
+     * @return the number of decision variables.
+     */
+    public int countVariables() {
+        return numVar;
+    }
+
+    /**
+     * Returns the number of linear constraints.
+     * @return the number of linear constraints.
+     */
+    public int countConstraints() {
+        return numCon;
+    }
+
+    /**
+     * Returns the objective function value at the optimal primal values,
+     * computing it on first use.
+     *
+     * @return the objective function value, or {@code Double.NaN} unless
+     * the problem was solved.
+     */
+    public double getObjective() {
+        var value = objective;
+
+        if (Double.isNaN(value) && isSolved()) {
+            value = quadObj.quadraticForm(primal);
+
+            for (int index = 0; index < numVar; ++index)
+                value += linObjCoeff[index] * primal[index];
+
+            objective = value;
+        }
+
+        return value;
+    }
+
+    /**
+     * Returns the optimal value of a decision variable.
+     *
+     * @param index the zero-based ordinal index of the decision variable.
+     *
+     * @return the optimal value of the decision variable.
+     */
+    public double getOptimal(int index) {
+        return primal[checkIndex(index, numVar)];
+    }
+
+    /**
+     * Returns the optimal dual value for a linear constraint.
+     *
+     * @param index the zero-based ordinal index of the constraint.
+     *
+     * @return the optimal dual value for the constraint.
+     */
+    public double getDual(int index) {
+        return dual[checkIndex(index, numCon)];
+    }
+
+    /**
+     * Returns the optimal reduced cost for a decision variable.
+     *
+     * @param index the zero-based ordinal index of the decision variable.
+     *
+     * @return the optimal reduced cost for the decision variable.
+     */
+    public double getReduced(int index) {
+        return dual[numCon + checkIndex(index, numVar)];
+    }
+
+    private static int checkIndex(int index, int length) {
+        if (index < 0 || index >= length)
+            throw new IllegalArgumentException("Invalid index.");
+
+        return index;
+    }
+
+    /**
+     * Returns a read-only view of the optimal values of the decision
+     * variables.
+     *
+     * @return a read-only view of the optimal primal values.
+     */
+    public DoubleBuffer optimal() {
+        return DoubleBuffer.wrap(primal).asReadOnlyBuffer();
+    }
+
+    /**
+     * Returns a read-only view of the optimal dual values for the linear
+     * constraints.
+     *
+     * @return a read-only view of the optimal dual values.
+     */
+    public DoubleBuffer dual() {
+        return DoubleBuffer.wrap(dual, 0, numCon).slice().asReadOnlyBuffer();
+    }
+
+    /**
+     * Returns a read-only view of the optimal reduced costs for the
+     * decision variables.
+     *
+     * @return a read-only view of the optimal reduced costs.
+     */
+    public DoubleBuffer reduced() {
+        return DoubleBuffer.wrap(dual, numCon, numVar).slice().asReadOnlyBuffer();
+    }
+
+    /**
+     * Copies the optimal values of the decision variables.
+     *
+     * @param target the array to receive the values (length at least
+     *               {@code countVariables()}).
+     */
+    public void copyOptimalInto(double[] target) {
+        System.arraycopy(primal, 0, target, 0, numVar);
+    }
+
+    /**
+     * Copies the optimal dual values for the linear constraints.
+     *
+     * @param target the array to receive the values (length at least
+     *               {@code countConstraints()}).
+     */
+    public void copyDualInto(double[] target) {
+        System.arraycopy(dual, 0, target, 0, numCon);
+    }
+
+    /**
+     * Copies the optimal reduced costs for the decision variables.
+     *
+     * @param target the array to receive the values (length at least
+     *               {@code countVariables()}).
+     */
+    public void copyReducedInto(double[] target) {
+        System.arraycopy(dual, numCon, target, 0, numVar);
+    }
+
+    @Override
+    public String toString() {
+        return String.format("OsqpSolution(status = %s, numVar = %d, numCon = %d, objective = %g)",
+                status, numVar, numCon, getObjective());
+    }
+}
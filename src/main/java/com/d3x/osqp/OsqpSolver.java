@@ -0,0 +1,802 @@
+/*
+ * Copyright (C) 2022 D3X Systems - All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.d3x.osqp;
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.LongBuffer;
+import java.util.Arrays;
+import java.util.Map;
+
+/**
+ * Owns a native OSQP workspace that persists between solves, so that
+ * repeated solves of the same problem skip the setup and factorization
+ * performed by {@code osqp_setup}.
+ *
+ * <p>Most applications solve problems through {@link OsqpModel}, which
+ * manages its own solver.  A solver may also be created directly from
+ * problem data held in off-heap storage ({@link OsqpData}), which the
+ * native setup reads in place.</p>
+ *
+ * <p>A cancellable solve ({@link #setCancellable}) or one with a time limit
+ * ({@link OsqpParam#TIME_LIMIT}) runs the ADMM iterations in chunks and may
+ * be stopped between chunks by {@link #cancel()} from another thread; it
+ * then returns the last iterate with status {@code CANCELLED}.</p>
+ *
+ * <p>A solver may hold a single-precision workspace ({@link OsqpPrecision}),
+ * created by the single-precision adapter library; the vectors passed to
+ * and from it are converted at the native boundary.</p>
+ *
+ * <p>The native workspace is released by {@link #close()}, after which every
+ * method that reads or updates the workspace throws an exception; a solver
+ * that becomes unreachable without being closed is released by a cleaner.
+ * Calls that reach the workspace hold the solver lock, so a solve running
+ * on another thread delays {@code close()} until it returns.</p>
+ *
+ * @author Scott Shaffer
+ */
+public final class OsqpSolver implements AutoCloseable {
+    private final int numVar;
+    private final int numDual;
+    private final Workspace workspace;
+    private final Cleaner.Cleanable cleanable;
+
+    // The statistics from the most recent solve, copied by the native
+    // code...
+    private final double[] infoValues = OsqpInfo.newValues();
+
+    // The cancellation flag, read in place by the native solve while
+    // other threads may write to it...
+    private final ByteBuffer cancelFlag = ByteBuffer.allocateDirect(Integer.BYTES).order(ByteOrder.nativeOrder());
+
+    private volatile boolean cancellable = false;
+
+    // The time limit in seconds (zero for none), enforced by the adapter
+    // whether or not OSQP was compiled with profiling...
+    private double timeLimit = 0.0;
+
+    // Whether the native workspace has been released; every native call
+    // checks it while holding the solver lock, which close() also takes...
+    private boolean closed = false;
+
+    private static final Cleaner cleaner = Cleaner.create();
+
+    private static final VarHandle intView = MethodHandles.byteBufferViewVarHandle(int[].class, ByteOrder.nativeOrder());
+
+    /**
+     * Whether the native OSQP library was compiled with profiling, which
+     * enables the solve timings and the adaptive step size fraction.
+     */
+    static final boolean PROFILING;
+
+    static {
+        System.loadLibrary("osqp");
+        System.loadLibrary("d3x-osqp");
+        PROFILING = isProfiling();
+    }
+
+    // The native handle is held apart from the solver so that the
+    // cleaner action does not keep the solver itself reachable; a single
+    // precision handle belongs to the single-precision library...
+    private static final class Workspace implements Runnable {
+        private final long handle;
+        private final boolean single;
+
+        private Workspace(long handle, boolean single) {
+            this.handle = handle;
+            this.single = single;
+        }
+
+        @Override
+        public void run() {
+            if (single)
+                OsqpSingle.cleanup(handle);
+            else
+                cleanup(handle);
+        }
+    }
+
+    private OsqpSolver(int numVar, int numDual, long handle, OsqpPrecision precision, double[] paramValues) {
+        this.numVar = numVar;
+        this.numDual = numDual;
+        this.workspace = new Workspace(handle, precision == OsqpPrecision.SINGLE);
+        this.cleanable = cleaner.register(this, workspace);
+        assignTimeLimit(paramValues);
+    }
+
+    private void assignTimeLimit(double[] paramValues) {
+        var value = paramValues[OsqpParam.TIME_LIMIT.ordinal()];
+
+        if (!Double.isNaN(value))
+            timeLimit = value;
+    }
+
+    /**
+     * Creates a solver for a quadratic program held in off-heap storage.
+     * The native setup reads the problem data in place; the solver keeps
+     * its own copy, so the storage may be reused after this method returns.
+     *
+     * @param data   the problem data.
+     * @param params the solver parameters to assign.
+     *
+     * @return a new solver for the given problem.
+     *
+     * @throws RuntimeException if the problem data is invalid or the native
+     * problem setup fails.
+     */
+    public static OsqpSolver create(OsqpData data, Map<OsqpParam, Double> params) {
+        return create(data, params, OsqpPrecision.DOUBLE);
+    }
+
+    /**
+     * Creates a solver for a quadratic program held in off-heap storage,
+     * in the specified precision.  The single-precision setup converts the
+     * problem data before reading it.
+     *
+     * @param data      the problem data.
+     * @param params    the solver parameters to assign.
+     * @param precision the precision of the native workspace.
+     *
+     * @return a new solver for the given problem.
+     *
+     * @throws IllegalStateException if the precision is not available.
+     * @throws RuntimeException if the problem data is invalid or the native
+     * problem setup fails.
+     */
+    public static OsqpSolver create(OsqpData data, Map<OsqpParam, Double> params, OsqpPrecision precision) {
+        precision.requireAvailable();
+        data.validate();
+
+        var paramValues = OsqpParam.toArray(params);
+        var handle = precision == OsqpPrecision.SINGLE
+                ? setupDirectSingle(data, paramValues)
+                : setupDirect(
+                        data.numVar(),
+                        data.numDual(),
+                        "",
+                        data.linObjCoeff(),
+                        data.quadObjColPtr(),
+                        data.quadObjRowInd(),
+                        data.quadObjCoeff(),
+                        data.linConColPtr(),
+                        data.linConRowInd(),
+                        data.linConCoeff(),
+                        data.linConLower(),
+                        data.linConUpper(),
+                        paramValues);
+
+        if (handle != 0)
+            return new OsqpSolver(data.numVar(), data.numDual(), handle, precision, paramValues);
+        else
+            throw new IllegalStateException("OSQP problem setup failed.");
+    }
+
+    private static long setupDirectSingle(OsqpData data, double[] paramValues) {
+        return OsqpSingle.setupDirect(
+                data.numVar(),
+                data.numDual(),
+                "",
+                data.linObjCoeff(),
+                data.quadObjColPtr(),
+                data.quadObjRowInd(),
+                data.quadObjCoeff(),
+                data.linConColPtr(),
+                data.linConRowInd(),
+                data.linConCoeff(),
+                data.linConLower(),
+                data.linConUpper(),
+                paramValues);
+    }
+
+    /**
+     * Creates a new native workspace for a quadratic program.
+     *
+     * @param numVar      the number of decision variables.
+     * @param numDual     the number of rows in the constraint matrix.
+     * @param logFile     the name of the solver log file (empty for none).
+     * @param linObjCoeff the linear objective coefficients.
+     * @param quadObj     the upper triangle of the quadratic objective matrix.
+     * @param linCon      the linear constraint matrix.
+     * @param linConLower the lower bounds on the linear constraints.
+     * @param linConUpper the upper bounds on the linear constraints.
+     * @param paramValues the solver parameters, indexed by ordinal (with
+     *                    {@code Double.NaN} for the defaults).
+     *
+     * @return the new solver, or {@code null} if the problem setup failed.
+     */
+    static OsqpSolver setup(
+            int        numVar,
+            int        numDual,
+            String     logFile,
+            double[]   linObjCoeff,
+            OsqpMatrix quadObj,
+            OsqpMatrix linCon,
+            double[]   linConLower,
+            double[]   linConUpper,
+            double[]   paramValues) {
+        return setup(numVar, numDual, logFile, linObjCoeff, quadObj, linCon, linConLower, linConUpper, paramValues, OsqpPrecision.DOUBLE);
+    }
+
+    /**
+     * Creates a new native workspace for a quadratic program in the
+     * specified precision.
+     *
+     * @param numVar      the number of decision variables.
+     * @param numDual     the number of rows in the constraint matrix.
+     * @param logFile     the name of the solver log file (empty for none).
+     * @param linObjCoeff the linear objective coefficients.
+     * @param quadObj     the upper triangle of the quadratic objective matrix.
+     * @param linCon      the linear constraint matrix.
+     * @param linConLower the lower bounds on the linear constraints.
+     * @param linConUpper the upper bounds on the linear constraints.
+     * @param paramValues the solver parameters, indexed by ordinal (with
+     *                    {@code Double.NaN} for the defaults).
+     * @param precision   the precision of the native workspace, which must
+     *                    be available.
+     *
+     * @return the new solver, or {@code null} if the problem setup failed.
+     */
+    static OsqpSolver setup(
+            int           numVar,
+            int           numDual,
+            String        logFile,
+            double[]      linObjCoeff,
+            OsqpMatrix    quadObj,
+            OsqpMatrix    linCon,
+            double[]      linConLower,
+            double[]      linConUpper,
+            double[]      paramValues,
+            OsqpPrecision precision) {
+        if (precision == OsqpPrecision.SINGLE) {
+            var handle = OsqpSingle.setup(
+                    numVar,
+                    numDual,
+                    logFile,
+                    linObjCoeff,
+                    quadObj.colptr,
+                    quadObj.rowind,
+                    quadObj.values,
+                    linCon.colptr,
+                    linCon.rowind,
+                    linCon.values,
+                    linConLower,
+                    linConUpper,
+                    paramValues);
+
+            return handle != 0 ? new OsqpSolver(numVar, numDual, handle, precision, paramValues) : null;
+        }
+
+        var handle = setup(
+                numVar,
+                numDual,
+                logFile,
+                linObjCoeff,
+                quadObj.colptr,
+                quadObj.rowind,
+                quadObj.values,
+                linCon.colptr,
+                linCon.rowind,
+                linCon.values,
+                linConLower,
+                linConUpper,
+                paramValues);
+
+        if (handle != 0)
+            return new OsqpSolver(numVar, numDual, handle, precision, paramValues);
+        else
+            return null;
+    }
+
+    /**
+     * Solves the quadratic program held in the native workspace.
+     *
+     * @param primal the array to receive the primal solution (length
+     *               {@code numVar}).
+     * @param dual   the array to receive the dual solution (length
+     *               {@code numDual}).
+     *
+     * @return the solution status.
+     *
+     * @throws IllegalStateException if this solver has been closed.
+     */
+    public OsqpStatus solve(double[] primal, double[] dual) {
+        if (primal.length != numVar)
+            throw new IllegalArgumentException("Invalid primal vector length.");
+
+        if (dual.length != numDual)
+            throw new IllegalArgumentException("Invalid dual vector length.");
+
+        return OsqpStatus.valueOf(solve("", primal, dual));
+    }
+
+    /**
+     * Enables or disables cancellation of later solves by {@link #cancel()}.
+     * A cancellable solve checks for cancellation every few hundred
+     * iterations; only the first chunk of iterations is written to the
+     * solver log.
+     *
+     * @param enabled whether later solves may be cancelled.
+     */
+    public void setCancellable(boolean enabled) {
+        cancellable = enabled;
+    }
+
+    /**
+     * Requests that the solve in progress on another thread stop and
+     * return its last iterate with status {@code CANCELLED}.  Has no effect
+     * unless the solve is cancellable or has a time limit, or if no solve
+     * is in progress; each solve clears earlier requests when it starts.
+     */
+    public void cancel() {
+        intView.setVolatile(cancelFlag, 0, 1);
+    }
+
+    /**
+     * Returns the solver statistics from the most recent solve.
+     *
+     * @return the solver statistics from the most recent solve.
+     *
+     * @throws IllegalStateException unless the problem has been solved.
+     */
+    public OsqpInfo getInfo() {
+        if (Double.isNaN(infoValues[0]))
+            throw new IllegalStateException("The problem has not been solved.");
+
+        return OsqpInfo.of(infoValues, 0);
+    }
+
+    /**
+     * Returns the precision of the native workspace.
+     * @return the precision of the native workspace.
+     */
+    public OsqpPrecision getPrecision() {
+        return workspace.single ? OsqpPrecision.SINGLE : OsqpPrecision.DOUBLE;
+    }
+
+    /**
+     * Solves the quadratic program held in the native workspace.
+     *
+     * @param logFile   the name of the solver log file (empty for none).
+     * @param optPrimal the array to receive the optimal primal solution.
+     * @param optDual   the array to receive the optimal dual solution.
+     *
+     * @return the native OSQP status code.
+     */
+    synchronized int solve(String logFile, double[] optPrimal, double[] optDual) {
+        checkOpen();
+
+        intView.setVolatile(cancelFlag, 0, 0);
+
+        var flag = cancellable || timeLimit > 0.0 ? cancelFlag : null;
+
+        if (workspace.single)
+            return OsqpSingle.solve(workspace.handle, logFile, optPrimal, optDual, infoValues, flag, timeLimit);
+        else
+            return solve(workspace.handle, logFile, optPrimal, optDual, infoValues, flag, timeLimit);
+    }
+
+    /**
+     * Solves a sequence of problems that differ from the one held in the
+     * native workspace only in the linear objective and/or the constraint
+     * bounds, with one native call.  The vectors for the problems are laid
+     * end to end in flat arrays; each problem is warm started from the
+     * solution of the previous one (if warm starts are enabled).  The
+     * workspace keeps the vectors of the last problem.
+     *
+     * <p>The time limit applies to each problem, and {@link #cancel()}
+     * stops the problem in progress, which returns {@code CANCELLED} with
+     * its last iterate; the problems that follow it are not solved and
+     * also return {@code CANCELLED}.</p>
+     *
+     * @param logFile     the name of the solver log file (empty for none).
+     * @param count       the number of problems.
+     * @param linObjCoeff the linear objective coefficients for each problem,
+     *                    or {@code null} to keep the current coefficients.
+     * @param linConLower the lower bounds for each problem, or {@code null}
+     *                    to keep the current lower bounds.
+     * @param linConUpper the upper bounds for each problem, or {@code null}
+     *                    to keep the current upper bounds.
+     * @param optPrimal   the array to receive the primal solutions.
+     * @param optDual     the array to receive the dual solutions.
+     *
+     * @return the native OSQP status code for each problem.
+     */
+    synchronized int[] sweep(String   logFile,
+                             int      count,
+                             double[] linObjCoeff,
+                             double[] linConLower,
+                             double[] linConUpper,
+                             double[] optPrimal,
+                             double[] optDual) {
+        checkOpen();
+
+        checkSweepLength(linObjCoeff, count * numVar);
+        checkSweepLength(linConLower, count * numDual);
+        checkSweepLength(linConUpper, count * numDual);
+
+        if (optPrimal.length != count * numVar || optDual.length != count * numDual)
+            throw new IllegalArgumentException("Invalid sweep solution length.");
+
+        var status = new int[count];
+        Arrays.fill(status, OsqpStatus.SETUP_ERROR.getCode());
+
+        intView.setVolatile(cancelFlag, 0, 0);
+
+        var flag = cancellable || timeLimit > 0.0 ? cancelFlag : null;
+
+        if (workspace.single)
+            OsqpSingle.sweep(workspace.handle, logFile, count, linObjCoeff, linConLower, linConUpper, optPrimal, optDual, status, flag, timeLimit);
+        else
+            sweep(workspace.handle, logFile, count, linObjCoeff, linConLower, linConUpper, optPrimal, optDual, status, flag, timeLimit);
+
+        return status;
+    }
+
+    private static void checkSweepLength(double[] vectors, int length) {
+        if (vectors != null && vectors.length != length)
+            throw new IllegalArgumentException("Invalid sweep vector length.");
+    }
+
+    /**
+     * Evaluates the objective function at a primal point using the problem
+     * data held in the native workspace.
+     *
+     * @param primal the primal point (length {@code numVar}).
+     *
+     * @return the objective function value at the given point.
+     *
+     * @throws IllegalStateException if this solver has been closed.
+     */
+    public double evaluateObjective(double[] primal) {
+        if (primal.length != numVar)
+            throw new IllegalArgumentException("Invalid primal vector length.");
+
+        var values = new double[1];
+        checkEvaluated(evaluate(primal, values));
+        return values[0];
+    }
+
+    /**
+     * Evaluates the objective function, the primal residual, and the bound
+     * violations at a primal point with one native call, using the problem
+     * data held in the native workspace.
+     *
+     * @param primal the primal point (length {@code numVar}).
+     *
+     * @return the evaluation at the given point.
+     *
+     * @throws IllegalStateException if this solver has been closed.
+     */
+    public OsqpEvaluation evaluate(double[] primal) {
+        if (primal.length != numVar)
+            throw new IllegalArgumentException("Invalid primal vector length.");
+
+        var values = new double[OsqpEvaluation.size(numDual)];
+        checkEvaluated(evaluate(primal, values));
+        return OsqpEvaluation.of(values);
+    }
+
+    private synchronized int evaluate(double[] primal, double[] values) {
+        checkOpen();
+
+        if (workspace.single)
+            return OsqpSingle.evaluate(workspace.handle, primal, values);
+        else
+            return evaluate(workspace.handle, primal, values);
+    }
+
+    private static void checkEvaluated(int status) {
+        if (status != 0)
+            throw new IllegalStateException("Native evaluation failed.");
+    }
+
+    /**
+     * Replaces the linear objective coefficients in the native workspace.
+     *
+     * @param linObjCoeff the new linear objective coefficients.
+     *
+     * @return {@code true} iff the workspace was updated.
+     */
+    synchronized boolean updateLinCost(double[] linObjCoeff) {
+        checkOpen();
+
+        if (workspace.single)
+            return OsqpSingle.updateLinCost(workspace.handle, linObjCoeff) == 0;
+        else
+            return updateLinCost(workspace.handle, linObjCoeff) == 0;
+    }
+
+    /**
+     * Replaces the lower and upper constraint bounds in the native workspace.
+     *
+     * @param linConLower the new lower bounds on the linear constraints.
+     * @param linConUpper the new upper bounds on the linear constraints.
+     *
+     * @return {@code true} iff the workspace was updated.
+     */
+    synchronized boolean updateBounds(double[] linConLower, double[] linConUpper) {
+        checkOpen();
+
+        if (workspace.single)
+            return OsqpSingle.updateBounds(workspace.handle, linConLower, linConUpper) == 0;
+        else
+            return updateBounds(workspace.handle, linConLower, linConUpper) == 0;
+    }
+
+    /**
+     * Replaces the lower constraint bounds in the native workspace.
+     *
+     * @param linConLower the new lower bounds on the linear constraints.
+     *
+     * @return {@code true} iff the workspace was updated.
+     */
+    synchronized boolean updateLowerBound(double[] linConLower) {
+        checkOpen();
+
+        if (workspace.single)
+            return OsqpSingle.updateLowerBound(workspace.handle, linConLower) == 0;
+        else
+            return updateLowerBound(workspace.handle, linConLower) == 0;
+    }
+
+    /**
+     * Replaces the upper constraint bounds in the native workspace.
+     *
+     * @param linConUpper the new upper bounds on the linear constraints.
+     *
+     * @return {@code true} iff the workspace was updated.
+     */
+    synchronized boolean updateUpperBound(double[] linConUpper) {
+        checkOpen();
+
+        if (workspace.single)
+            return OsqpSingle.updateUpperBound(workspace.handle, linConUpper) == 0;
+        else
+            return updateUpperBound(workspace.handle, linConUpper) == 0;
+    }
+
+    /**
+     * Updates solver parameters in the native workspace.
+     *
+     * @param paramValues the new parameters, indexed by ordinal (with
+     *                    {@code Double.NaN} for those left unchanged).
+     *
+     * @return {@code true} iff the workspace was updated; {@code false} if
+     * a parameter may only be assigned during the setup.
+     */
+    synchronized boolean updateSettings(double[] paramValues) {
+        checkOpen();
+
+        var status = workspace.single
+                ? OsqpSingle.updateSettings(workspace.handle, paramValues)
+                : updateSettings(workspace.handle, paramValues);
+
+        if (status != 0)
+            return false;
+
+        assignTimeLimit(paramValues);
+        return true;
+    }
+
+    /**
+     * Replaces the values of the quadratic objective and linear constraint
+     * matrices in the native workspace.  The matrices must have the same
+     * non-zero patterns as the current matrices; only the changed elements
+     * are sent to the workspace, which repeats the numeric factorization but
+     * not the symbolic analysis.
+     *
+     * @param quadObj0 the current quadratic objective matrix.
+     * @param quadObj1 the new quadratic objective matrix.
+     * @param linCon0  the current linear constraint matrix.
+     * @param linCon1  the new linear constraint matrix.
+     *
+     * @return {@code true} iff the workspace was updated.
+     */
+    synchronized boolean updateMatrices(OsqpMatrix quadObj0, OsqpMatrix quadObj1, OsqpMatrix linCon0, OsqpMatrix linCon1) {
+        checkOpen();
+
+        var quadObj = new ValueUpdate(quadObj0, quadObj1);
+        var linCon = new ValueUpdate(linCon0, linCon1);
+
+        if (quadObj.isEmpty() && linCon.isEmpty())
+            return true;
+
+        if (workspace.single)
+            return OsqpSingle.updateMatrices(workspace.handle, quadObj.values, quadObj.index, linCon.values, linCon.index) == 0;
+        else
+            return updateMatrices(workspace.handle, quadObj.values, quadObj.index, linCon.values, linCon.index) == 0;
+    }
+
+    // The changed elements of a matrix in compressed column order: a
+    // null index means that every element has changed, while a null
+    // value array means that none have...
+    private static final class ValueUpdate {
+        private double[] values = null;
+        private long[] index = null;
+
+        private ValueUpdate(OsqpMatrix prior, OsqpMatrix update) {
+            var priorValues = prior.values;
+            var updateValues = update.values;
+            var changed = 0;
+
+            for (int k = 0; k < updateValues.length; ++k)
+                if (updateValues[k] != priorValues[k])
+                    ++changed;
+
+            if (changed == 0) {
+                return;
+            }
+            else if (changed == updateValues.length) {
+                values = updateValues;
+            }
+            else {
+                values = new double[changed];
+                index = new long[changed];
+                changed = 0;
+
+                for (int k = 0; k < updateValues.length; ++k) {
+                    if (updateValues[k] != priorValues[k]) {
+                        values[changed] = updateValues[k];
+                        index[changed] = k;
+                        ++changed;
+                    }
+                }
+            }
+        }
+
+        private boolean isEmpty() {
+            return values == null;
+        }
+    }
+
+    /**
+     * Assigns the starting point for the next solve.
+     *
+     * @param primal the initial primal vector, or {@code null} to keep the
+     *               current primal iterate.
+     * @param dual   the initial dual vector, or {@code null} to keep the
+     *               current dual iterate.
+     *
+     * @return {@code true} iff the starting point was assigned.
+     */
+    synchronized boolean warmStart(double[] primal, double[] dual) {
+        checkOpen();
+
+        if (primal == null && dual == null)
+            return true;
+        else if (workspace.single)
+            return OsqpSingle.warmStart(workspace.handle, primal, dual) == 0;
+        else
+            return warmStart(workspace.handle, primal, dual) == 0;
+    }
+
+    /**
+     * Starts the next solve from the origin, as the first solve after the
+     * setup does, instead of the iterate left by the previous solve.  The
+     * step size keeps any value adapted by earlier solves.
+     *
+     * @return {@code true} iff the starting point was assigned.
+     */
+    synchronized boolean coldStart() {
+        return warmStart(new double[numVar], new double[numDual]);
+    }
+
+    /**
+     * Releases the native workspace; the solver may not be used afterward.
+     * Closing a solver more than once has no further effect.
+     */
+    @Override
+    public synchronized void close() {
+        closed = true;
+        cleanable.clean();
+    }
+
+    /**
+     * Identifies solvers whose native workspace has been released.
+     * @return {@code true} iff this solver has been closed.
+     */
+    public synchronized boolean isClosed() {
+        return closed;
+    }
+
+    private void checkOpen() {
+        if (closed)
+            throw new IllegalStateException("The solver has been closed.");
+    }
+
+    // OSQP uses long as the integer type so all "integer"
+    // arguments are defined as longs...
+    private static native long setup(
+            long     numVar,
+            long     numDual,
+            String   logFile,
+            double[] linObjCoeff,
+            long[]   quadObjColPtr,
+            long[]   quadObjRowInd,
+            double[] quadObjCoeff,
+            long[]   linConColPtr,
+            long[]   linConRowInd,
+            double[] linConCoeff,
+            double[] linConLower,
+            double[] linConUpper,
+            double[] paramValues);
+
+    private static native long setupDirect(
+            long         numVar,
+            long         numDual,
+            String       logFile,
+            DoubleBuffer linObjCoeff,
+            LongBuffer   quadObjColPtr,
+            LongBuffer   quadObjRowInd,
+            DoubleBuffer quadObjCoeff,
+            LongBuffer   linConColPtr,
+            LongBuffer   linConRowInd,
+            DoubleBuffer linConCoeff,
+            DoubleBuffer linConLower,
+            DoubleBuffer linConUpper,
+            double[]     paramValues);
+
+    private static native int solve(
+            long       handle,
+            String     logFile,
+            double[]   optPrimal,
+            double[]   optDual,
+            double[]   solveInfo,
+            ByteBuffer cancelFlag,
+            double     timeLimit);
+
+    private static native void sweep(
+            long       handle,
+            String     logFile,
+            int        count,
+            double[]   linObjCoeff,
+            double[]   linConLower,
+            double[]   linConUpper,
+            double[]   optPrimal,
+            double[]   optDual,
+            int[]      status,
+            ByteBuffer cancelFlag,
+            double     timeLimit);
+
+    private static native int updateLinCost(long handle, double[] linObjCoeff);
+
+    private static native int updateBounds(long handle, double[] linConLower, double[] linConUpper);
+
+    private static native int updateLowerBound(long handle, double[] linConLower);
+
+    private static native int updateUpperBound(long handle, double[] linConUpper);
+
+    private static native int updateSettings(long handle, double[] paramValues);
+
+    private static native int updateMatrices(
+            long     handle,
+            double[] quadObjCoeff,
+            long[]   quadObjIndex,
+            double[] linConCoeff,
+            long[]   linConIndex);
+
+    private static native int warmStart(long handle, double[] primal, double[] dual);
+
+    private static native int evaluate(long handle, double[] primal, double[] values);
+
+    private static native void cleanup(long handle);
+
+    private static native boolean isProfiling();
+}
@@ -35,7 +35,8 @@ public enum OsqpStatus {
     SIGINT(-5), // interrupted by user
     TIME_LIMIT_REACHED(-6),
     NON_CVX(-7),
-    UNSOLVED(-10);
+    UNSOLVED(-10),
+    CANCELLED(-11); // cancelled by the caller (not an OSQP code)
 
     private final int code;
     private static final Map<Integer, OsqpStatus> codeMap = new HashMap<>();
@@ -68,6 +69,27 @@ public enum OsqpStatus {
             throw new IllegalArgumentException(String.format("Unknown status code: [%d].", code));
     }
 
+    /**
+     * Identifies statuses for which the solution vectors hold the last
+     * ADMM iterate, which may be used as an approximate solution.
+     *
+     * @return {@code true} iff the solver returns its last iterate with
+     * this status.
+     */
+    public boolean hasIterate() {
+        switch (this) {
+        case SOLVED:
+        case SOLVED_INACCURATE:
+        case MAX_ITER_REACHED:
+        case TIME_LIMIT_REACHED:
+        case CANCELLED:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
     /**
      * Returns the native OSQP status code.
      * @return the native OSQP status code.
@@ -15,7 +15,20 @@
  */
 package com.d3x.osqp;
 
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.EnumMap;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.CompletableFuture;
+import java.util.stream.IntStream;
+
 import org.testng.Assert;
+import org.testng.SkipException;
 import org.testng.annotations.Test;
 
 /**
@@ -24,9 +37,8 @@ import org.testng.annotations.Test;
  * @author Scott Shaffer
  */
 public class OsqpModelTest {
-    @Test
-    public void test1() {
-        var model = OsqpModel.create(2, 1)
+    private static OsqpModel createModel1() {
+        return OsqpModel.create(2, 1)
                 .setVariableBound(0, 0.0, 0.7)
                 .setVariableBound(1, 0.0, 0.7)
                 .setObjectiveCoeff(0, 1.0)
@@ -44,9 +56,9 @@ public class OsqpModelTest {
                 .setParameter(OsqpParam.EPS_REL, 1.0E-04)
                 .setParameter(OsqpParam.EPS_PRIM_INF, 1.0E-05)
                 .setParameter(OsqpParam.EPS_DUAL_INF, 1.0E-05);
+    }
 
-        var status = model.solve();
-        Assert.assertEquals(status, OsqpStatus.SOLVED);
+    private static void assertSolution1(OsqpModel model) {
         Assert.assertTrue(model.isSolved());
 
         var tolerance = 1.0E-12;
@@ -57,7 +69,1124 @@ public class OsqpModelTest {
         Assert.assertEquals(model.getDual(0), -2.9, tolerance);
         Assert.assertEquals(model.evaluate(model.getOptimal()), 1.88, tolerance);
     }
-    
+
+    @Test
+    public void test1() {
+        var model = createModel1();
+        var status = model.solve();
+        Assert.assertEquals(status, OsqpStatus.SOLVED);
+        assertSolution1(model);
+    }
+
+    @Test
+    public void testEvaluate() {
+        var model = createModel1();
+
+        // Reassigned coefficients replace the previous values...
+        model.setObjectiveCoeff(1, 1, 3.0).setObjectiveCoeff(1, 1, 2.0);
+        model.setConstraintCoeff(0, 0, 2.0).setConstraintCoeff(0, 0, 1.0);
+
+        var tolerance = 1.0E-12;
+        Assert.assertEquals(model.evaluate(0.3, 0.7), 1.88, tolerance);
+        Assert.assertTrue(model.isFeasible(0.3, 0.7));
+        Assert.assertTrue(model.isFeasible(0.4, 0.6));
+        Assert.assertFalse(model.isFeasible(0.4, 0.5));
+        Assert.assertFalse(model.isFeasible(0.2, 0.8));
+        Assert.assertEquals(model.constraintValues(0.3, 0.5), new double[] { 0.8 }, tolerance);
+
+        // The cached matrices follow later assignments...
+        model.setObjectiveCoeff(1, 1, 4.0).setConstraintCoeff(0, 1, 2.0);
+        Assert.assertEquals(model.evaluate(0.3, 0.7), 2.37, tolerance);
+        Assert.assertEquals(model.constraintValues(0.3, 0.5), new double[] { 1.3 }, tolerance);
+        Assert.assertFalse(model.isFeasible(0.3, 0.7));
+    }
+
+    @Test
+    public void testEvaluateNative() {
+        try (var model = createModel1()) {
+            var tolerance = 1.0E-12;
+            Assert.assertEquals(model.evaluateNative(0.3, 0.7), 1.88, tolerance);
+
+            var feasible = model.constraintResidualsNative(0.3, 0.7);
+            Assert.assertEquals(feasible.getObjective(), 1.88, tolerance);
+            Assert.assertEquals(feasible.getPrimalResidual(), 0.0, tolerance);
+
+            // The violations cover the constraints and then the bounds...
+            var infeasible = model.constraintResidualsNative(0.4, 0.8);
+            Assert.assertEquals(infeasible.getViolations(), new double[] { 0.2, 0.0, 0.1 }, tolerance);
+            Assert.assertEquals(infeasible.getPrimalResidual(), 0.2, tolerance);
+
+            // The native workspace follows updates to the model...
+            model.setObjectiveCoeff(0, 2.0);
+            Assert.assertEquals(model.evaluateNative(0.3, 0.7), model.evaluate(0.3, 0.7), tolerance);
+        }
+    }
+
+    @Test
+    public void testUnboundedVariable() {
+        try (var model = createModel1().setVariableBound(0, Double.NEGATIVE_INFINITY, Double.POSITIVE_INFINITY)) {
+            // The free variable has no row in the native constraint matrix...
+            Assert.assertEquals(model.toData().numDual(), 2);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+            Assert.assertEquals(model.constraintResidualsNative(0.3, 0.8).getViolations(), new double[] { 0.1, 0.0, 0.1 }, 1.0E-12);
+
+            // ...until it is bounded again...
+            model.setVariableBound(0, 0.0, 0.7);
+            Assert.assertEquals(model.toData().numDual(), 3);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+        }
+    }
+
+    @Test
+    public void testResolve() {
+        try (var model = createModel1()) {
+            // The second solve reuses the native workspace...
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            // The workspace is rebuilt after the model is modified...
+            model.setConstraintBound(0, 1.0, 1.0);
+            Assert.assertFalse(model.isSolved());
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            // ...and after it is closed...
+            model.close();
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+        }
+    }
+
+    private static void assertSameSolution(OsqpModel actual, OsqpModel expected, double tolerance) {
+        Assert.assertEquals(actual.getStatus(), expected.getStatus());
+        Assert.assertEquals(actual.getOptimal(), expected.getOptimal(), tolerance);
+        Assert.assertEquals(actual.getReduced(), expected.getReduced(), tolerance);
+        Assert.assertEquals(actual.getDual(), expected.getDual(), tolerance);
+    }
+
+    @Test
+    public void testVectorUpdate() {
+        try (var updated = createModel1(); var rebuilt = createModel1()) {
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+
+            // Only the linear objective and bounds change, so the
+            // existing workspace is updated in place...
+            updated.setObjectiveCoeff(0, 2.0)
+                    .setVariableBound(1, 0.0, 0.6)
+                    .setConstraintBound(0, 0.9, 1.0);
+
+            rebuilt.setObjectiveCoeff(0, 2.0)
+                    .setVariableBound(1, 0.0, 0.6)
+                    .setConstraintBound(0, 0.9, 1.0);
+
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(rebuilt.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(updated, rebuilt, 1.0E-08);
+
+            // Lower bounds only...
+            updated.setVariableBound(0, 0.35, 0.7);
+            rebuilt.setVariableBound(0, 0.35, 0.7);
+
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(rebuilt.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(updated, rebuilt, 1.0E-08);
+        }
+    }
+
+    @Test
+    public void testMatrixUpdate() {
+        try (var updated = createModel1(); var rebuilt = createModel1()) {
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+
+            // New values in the existing sparsity pattern...
+            updated.setObjectiveCoeff(0, 0, 5.0).setConstraintCoeff(0, 1, 0.9);
+            rebuilt.setObjectiveCoeff(0, 0, 5.0).setConstraintCoeff(0, 1, 0.9);
+
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(rebuilt.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(updated, rebuilt, 1.0E-08);
+
+            // A zero coefficient changes the sparsity pattern...
+            updated.setObjectiveCoeff(0, 1, 0.0);
+            rebuilt.setObjectiveCoeff(0, 1, 0.0);
+
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(rebuilt.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(updated, rebuilt, 1.0E-08);
+        }
+    }
+
+    @Test
+    public void testParameterUpdate() {
+        try (var updated = createModel1(); var rebuilt = createModel1()) {
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+
+            // Updatable settings are sent to the existing workspace...
+            updated.setParameter(OsqpParam.EPS_ABS, 1.0E-06)
+                    .setParameter(OsqpParam.MAX_ITER, 500)
+                    .setParameter(OsqpParam.CHECK_TERMINATION, 5);
+
+            rebuilt.setParameter(OsqpParam.EPS_ABS, 1.0E-06)
+                    .setParameter(OsqpParam.MAX_ITER, 500)
+                    .setParameter(OsqpParam.CHECK_TERMINATION, 5);
+
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(rebuilt.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(updated, rebuilt, 1.0E-08);
+
+            // Others require a new setup...
+            updated.setParameter(OsqpParam.SCALING, 0);
+            Assert.assertEquals(updated.solve(), OsqpStatus.SOLVED);
+            assertSolution1(updated);
+        }
+    }
+
+    @Test
+    public void testLinsysSolver() {
+        Assert.assertTrue(OsqpLinsys.QDLDL.isAvailable());
+
+        for (var solver : OsqpLinsys.values()) {
+            if (solver.isAvailable()) {
+                try (var model = createModel1().setLinsysSolver(solver); var expected = createModel1()) {
+                    Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+                    Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                    assertSameSolution(model, expected, 1.0E-06);
+                }
+            }
+        }
+    }
+
+    @Test
+    public void testSweep() {
+        var count = 4;
+        var linObjCoeffs = new double[count][];
+        var lowers = new double[count][];
+        var uppers = new double[count][];
+        var primals = new double[count][2];
+        var duals = new double[count][3];
+
+        for (int k = 0; k < count; ++k) {
+            linObjCoeffs[k] = new double[] { 1.0 + 0.5 * k, 1.0 };
+            lowers[k] = new double[] { 1.0, 0.0, 0.0 };
+            uppers[k] = new double[] { 1.0, 0.7, 0.6 + 0.1 * k };
+        }
+
+        try (var model = createModel1()) {
+            var statuses = model.sweep(linObjCoeffs, lowers, uppers, primals, duals);
+
+            for (int k = 0; k < count; ++k) {
+                try (var expected = createModel1()
+                        .setObjectiveCoeff(0, linObjCoeffs[k][0])
+                        .setVariableBound(1, 0.0, uppers[k][2])) {
+                    Assert.assertEquals(statuses.get(k), OsqpStatus.SOLVED);
+                    Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                    Assert.assertEquals(primals[k], expected.getOptimal(), 1.0E-06);
+                    Assert.assertEquals(duals[k][0], expected.getDual(0), 1.0E-06);
+                }
+            }
+
+            // The model keeps its own vectors...
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+        }
+    }
+
+    @Test
+    public void testWarmStart() {
+        try (var solved = createModel1(); var model = createModel1()) {
+            Assert.assertEquals(solved.solve(), OsqpStatus.SOLVED);
+
+            var dual = new double[3];
+            dual[0] = solved.getDual(0);
+            dual[1] = solved.getReduced(0);
+            dual[2] = solved.getReduced(1);
+
+            // Explicit warm start from the known solution...
+            model.warmStart(solved.getOptimal(), dual);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            // Primal warm start only, then the automatic warm start...
+            model.setObjectiveCoeff(0, 1.0).warmStart(solved.getOptimal(), null);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            model.setObjectiveCoeff(0, 1.0);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            // Cold start...
+            model.setWarmStart(false).setObjectiveCoeff(0, 1.0);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+        }
+    }
+
+    @Test
+    public void testColdStart() {
+        // Without the adaptive step size, the workspace holds nothing but
+        // the iterate from one solve to the next...
+        try (var fresh = createModel1().setParameter(OsqpParam.ADAPTIVE_RHO, 0);
+             var model = createModel1().setParameter(OsqpParam.ADAPTIVE_RHO, 0)) {
+            Assert.assertEquals(fresh.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            var iterations = fresh.getInfo().orElseThrow().getIterations();
+            Assert.assertEquals(model.getInfo().orElseThrow().getIterations(), iterations);
+
+            // The warm start begins at the solution...
+            model.setObjectiveCoeff(0, 1.0);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            Assert.assertTrue(model.getInfo().orElseThrow().getIterations() <= iterations);
+
+            // ...and the cold start at the origin, as a fresh model does...
+            model.setWarmStart(false).setObjectiveCoeff(0, 1.0);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(model.getInfo().orElseThrow().getIterations(), iterations);
+            assertSameSolution(model, fresh, 1.0E-12);
+        }
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testWarmStartLength() {
+        createModel1().warmStart(new double[] { 0.0 }, null);
+    }
+
+    @Test
+    public void testInfo() {
+        try (var model = createModel1()) {
+            Assert.assertTrue(model.getInfo().isEmpty());
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            var info = model.getInfo().orElseThrow();
+            Assert.assertEquals(info.getStatus(), OsqpStatus.SOLVED);
+            Assert.assertTrue(info.getIterations() > 0);
+            Assert.assertTrue(info.getIterations() <= 200);
+            Assert.assertEquals(info.getObjectiveValue(), 1.88, 1.0E-08);
+            Assert.assertTrue(info.getPrimalResidual() >= 0.0);
+            Assert.assertTrue(info.getDualResidual() >= 0.0);
+        }
+    }
+
+    @Test
+    public void testCancellable() {
+        try (var model = createModel1().setCancellable(true); var plain = createModel1()) {
+            // A request made before the solve is cleared when it starts...
+            model.cancel();
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(plain.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(model, plain, 1.0E-06);
+            Assert.assertEquals(model.getIterate(), model.getOptimal());
+        }
+
+        try (var model = createModel1().setCancellable(true)) {
+            model.setParameter(OsqpParam.MAX_ITER, 1.0);
+            model.setParameter(OsqpParam.EPS_ABS, 1.0E-12);
+            model.setParameter(OsqpParam.EPS_REL, 1.0E-12);
+
+            // The iterate survives a solve that stops early...
+            Assert.assertEquals(model.solve(), OsqpStatus.MAX_ITER_REACHED);
+            Assert.assertTrue(Double.isNaN(model.getOptimal(0)));
+
+            for (var value : model.getIterate())
+                Assert.assertTrue(Double.isFinite(value));
+        }
+    }
+
+    // An infeasible problem whose infeasibility is never detected, so that
+    // a solve runs until it is stopped...
+    private static OsqpModel createEndlessModel() {
+        return createModel1()
+                .setConstraintBound(0, 2.0, 2.0)
+                .setParameter(OsqpParam.MAX_ITER, 1.0E+09)
+                .setParameter(OsqpParam.EPS_PRIM_INF, 0.0)
+                .setParameter(OsqpParam.EPS_DUAL_INF, 0.0);
+    }
+
+    private static void assertFiniteIterate(OsqpModel model) {
+        for (var value : model.getIterate())
+            Assert.assertTrue(Double.isFinite(value));
+    }
+
+    @Test
+    public void testCancelRunning() throws Exception {
+        try (var model = createEndlessModel().setCancellable(true)) {
+            var future = CompletableFuture.supplyAsync(model::solve);
+
+            // A request made before the solve starts is cleared, so it is
+            // repeated until the solve stops...
+            while (!future.isDone()) {
+                model.cancel();
+                Thread.sleep(10);
+            }
+
+            Assert.assertEquals(future.get(), OsqpStatus.CANCELLED);
+            Assert.assertTrue(Double.isNaN(model.getOptimal(0)));
+            assertFiniteIterate(model);
+        }
+    }
+
+    @Test
+    public void testLogFiles() throws Exception {
+        var path1 = Files.createTempFile("osqp", ".log");
+        var path2 = Files.createTempFile("osqp", ".log");
+
+        // Verbose solves with their own log files run concurrently, and
+        // each file receives the progress of its own solves only...
+        try (var model1 = createModel1().setParameter(OsqpParam.VERBOSE, 1).setLogFile(path1.toString());
+             var model2 = createEndlessModel().setParameter(OsqpParam.VERBOSE, 1).setParameter(OsqpParam.MAX_ITER, 1000).setLogFile(path2.toString())) {
+            var future1 = CompletableFuture.supplyAsync(model1::solve);
+            var future2 = CompletableFuture.supplyAsync(model2::solve);
+
+            Assert.assertEquals(future1.get(), OsqpStatus.SOLVED);
+            Assert.assertEquals(future2.get(), OsqpStatus.MAX_ITER_REACHED);
+
+            var log1 = Files.readString(path1);
+            var log2 = Files.readString(path2);
+
+            Assert.assertTrue(log1.contains("status:               solved"));
+            Assert.assertFalse(log1.contains("maximum iterations reached"));
+            Assert.assertTrue(log2.contains("status:               maximum iterations reached"));
+            Assert.assertTrue(log2.contains("number of iterations: 1000"));
+        }
+        finally {
+            Files.deleteIfExists(path1);
+            Files.deleteIfExists(path2);
+        }
+    }
+
+    @Test
+    public void testTimeLimit() {
+        try (var model = createEndlessModel().setParameter(OsqpParam.TIME_LIMIT, 0.05)) {
+            Assert.assertEquals(model.solve(), OsqpStatus.TIME_LIMIT_REACHED);
+            assertFiniteIterate(model);
+
+            // Batch solves and sweeps keep the time limit...
+            Assert.assertEquals(OsqpModel.solveAll(List.of(model)), List.of(OsqpStatus.TIME_LIMIT_REACHED));
+            assertFiniteIterate(model);
+
+            var primals = new double[2][2];
+            var statuses = model.sweep(null, null, null, primals, null);
+            Assert.assertEquals(statuses, List.of(OsqpStatus.TIME_LIMIT_REACHED, OsqpStatus.TIME_LIMIT_REACHED));
+
+            for (var primal : primals)
+                for (var value : primal)
+                    Assert.assertTrue(Double.isFinite(value));
+        }
+    }
+
+    @Test
+    public void testNativeStats() {
+        OsqpNativeStats.enable(true);
+
+        try (var model = createModel1()) {
+            var before = OsqpModel.nativeStats();
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            var delta = OsqpModel.nativeStats().minus(before);
+            Assert.assertTrue(delta.getCount(OsqpNativeStats.Phase.SETUP) >= 1);
+            Assert.assertTrue(delta.getCount(OsqpNativeStats.Phase.SOLVE) >= 1);
+            Assert.assertTrue(delta.getNanos(OsqpNativeStats.Phase.SOLVE) > 0);
+            Assert.assertTrue(delta.getArenaCalls() >= 1);
+            Assert.assertTrue(delta.getArenaPeakBytes() > 0);
+        }
+        finally {
+            OsqpNativeStats.enable(false);
+        }
+    }
+
+    @Test
+    public void testSolveAll() {
+        try (var model1 = createModel1();
+             var model2 = createModel1().setObjectiveCoeff(0, 2.0);
+             var model3 = createModel1().setObjectiveCoeff(0, 2.0)) {
+            var statuses = OsqpModel.solveAll(List.of(model1, model2));
+
+            Assert.assertEquals(statuses, List.of(OsqpStatus.SOLVED, OsqpStatus.SOLVED));
+            Assert.assertEquals(model1.getInfo().orElseThrow().getStatus(), OsqpStatus.SOLVED);
+            assertSolution1(model1);
+
+            Assert.assertEquals(model3.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(model2, model3, 1.0E-08);
+        }
+    }
+
+    @Test
+    public void testSolveAllThreads() {
+        var models = new ArrayList<OsqpModel>();
+
+        for (int k = 0; k < 50; ++k)
+            models.add(createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k));
+
+        var statuses = OsqpModel.solveAll(models, 4);
+
+        for (int k = 0; k < models.size(); ++k) {
+            try (var expected = createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k)) {
+                Assert.assertEquals(statuses.get(k), OsqpStatus.SOLVED);
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(models.get(k), expected, 1.0E-06);
+            }
+        }
+    }
+
+    @Test
+    public void testSolveAllRho() {
+        // A poor initial step size is adapted during each solve, but every
+        // problem in a reused workspace starts again from the setting...
+        var models = new ArrayList<OsqpModel>();
+
+        for (int k = 0; k < 4; ++k)
+            models.add(createModel1().setParameter(OsqpParam.RHO, 1.0E-04).setParameter(OsqpParam.ADAPTIVE_RHO_INTERVAL, 5));
+
+        try (var expected = createModel1().setParameter(OsqpParam.RHO, 1.0E-04).setParameter(OsqpParam.ADAPTIVE_RHO_INTERVAL, 5)) {
+            Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(OsqpModel.solveAll(models, 1), List.of(OsqpStatus.SOLVED, OsqpStatus.SOLVED, OsqpStatus.SOLVED, OsqpStatus.SOLVED));
+
+            for (var model : models)
+                Assert.assertEquals(model.getInfo().orElseThrow().getIterations(), expected.getInfo().orElseThrow().getIterations());
+        }
+    }
+
+    @Test
+    public void testPipeline() {
+        var count = 40;
+        var solutions = new ArrayList<OsqpSolution>();
+        var models = IntStream.range(0, count)
+                .mapToObj(k -> createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k));
+
+        var stats = OsqpPipeline.solve(models, solutions::add, 3);
+
+        Assert.assertEquals(solutions.size(), count);
+        Assert.assertEquals(stats.getCount(OsqpPipeline.Stage.MARSHAL), count);
+        Assert.assertEquals(stats.getCount(OsqpPipeline.Stage.SOLVE), count);
+        Assert.assertEquals(stats.getCount(OsqpPipeline.Stage.DELIVER), count);
+        Assert.assertTrue(stats.getReusedWorkspaces() >= count - 3);
+        Assert.assertTrue(stats.getPeakInFlight() <= OsqpPipeline.CAPACITY_PER_THREAD * 3);
+
+        // The solutions arrive in the order of the models...
+        for (int k = 0; k < count; ++k) {
+            try (var expected = createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k)) {
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                Assert.assertTrue(solutions.get(k).isSolved());
+
+                for (int j = 0; j < 2; ++j)
+                    Assert.assertEquals(solutions.get(k).getOptimal(j), expected.getOptimal(j), 1.0E-06);
+            }
+        }
+    }
+
+    // Runs of models that share their structure and parameters: the run
+    // boundaries (at 4, 8, and 12) change the parameters, the structure,
+    // and both...
+    private static OsqpModel createPipelineModel(int k) {
+        var bound = 1.0 + 0.001 * k;
+        var model = createModel1().setConstraintBound(0, bound, bound);
+
+        if (4 <= k && k < 8)
+            model.setParameter(OsqpParam.POLISH, 0);
+        else if (8 <= k && k < 12)
+            model.setVariableBound(0, Double.NEGATIVE_INFINITY, Double.POSITIVE_INFINITY);
+
+        return model;
+    }
+
+    private static void assertPipelineSolutions(List<OsqpSolution> solutions) {
+        for (int k = 0; k < solutions.size(); ++k) {
+            try (var expected = createPipelineModel(k)) {
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                Assert.assertTrue(solutions.get(k).isSolved());
+
+                for (int j = 0; j < 2; ++j)
+                    Assert.assertEquals(solutions.get(k).getOptimal(j), expected.getOptimal(j), 1.0E-06);
+            }
+        }
+    }
+
+    @Test
+    public void testPipelineMixed() {
+        var count = 14;
+        var solutions = new ArrayList<OsqpSolution>();
+        var models = IntStream.range(0, count).mapToObj(OsqpModelTest::createPipelineModel);
+
+        // One solver thread sees the models in order, so every model but
+        // the first of each run adopts the previous workspace...
+        var stats = OsqpPipeline.solve(models, solutions::add, 1);
+
+        Assert.assertEquals(solutions.size(), count);
+        Assert.assertEquals(stats.getCount(OsqpPipeline.Stage.SOLVE), count);
+        Assert.assertEquals(stats.getReusedWorkspaces(), count - 4);
+        assertPipelineSolutions(solutions);
+    }
+
+    @Test
+    public void testPipelineSourceFailure() {
+        var solutions = new ArrayList<OsqpSolution>();
+        var models = new Iterator<OsqpModel>() {
+            private int next = 0;
+
+            @Override
+            public boolean hasNext() {
+                return true;
+            }
+
+            @Override
+            public OsqpModel next() {
+                if (next == 6)
+                    throw new IllegalArgumentException("Unreadable scenario.");
+
+                return createPipelineModel(next++);
+            }
+        };
+
+        var thrown = Assert.expectThrows(IllegalArgumentException.class, () -> OsqpPipeline.solve(models, solutions::add, 2));
+        Assert.assertEquals(thrown.getMessage(), "Unreadable scenario.");
+
+        // Any solutions delivered before the failure are in order...
+        Assert.assertTrue(solutions.size() <= 6);
+        assertPipelineSolutions(solutions);
+    }
+
+    @Test(expectedExceptions = IllegalStateException.class)
+    public void testPipelineFailure() {
+        var models = List.of(createModel1(), createModel1(), createModel1()).iterator();
+
+        OsqpPipeline.solve(models, solution -> { throw new IllegalStateException("Rejected."); }, 2, 1);
+    }
+
+    @Test
+    public void testSolveAsync() {
+        var models = new ArrayList<OsqpModel>();
+        var futures = new ArrayList<CompletableFuture<OsqpStatus>>();
+
+        for (int k = 0; k < 20; ++k) {
+            models.add(createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k));
+            futures.add(models.get(k).solveAsync());
+        }
+
+        try (var model1 = createModel1(); var model2 = createModel1()) {
+            var batch = OsqpModel.solveAllAsync(List.of(model1, model2)).join();
+            Assert.assertEquals(batch, List.of(OsqpStatus.SOLVED, OsqpStatus.SOLVED));
+        }
+
+        for (int k = 0; k < models.size(); ++k) {
+            try (var expected = createModel1().setConstraintBound(0, 1.0 + 0.001 * k, 1.0 + 0.001 * k)) {
+                Assert.assertEquals(futures.get(k).join(), OsqpStatus.SOLVED);
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(models.get(k), expected, 1.0E-06);
+                models.get(k).close();
+            }
+        }
+    }
+
+    @Test
+    public void testDirectData() {
+        var params = new EnumMap<OsqpParam, Double>(OsqpParam.class);
+        params.put(OsqpParam.RHO, 1.0);
+        params.put(OsqpParam.POLISH, 1.0);
+        params.put(OsqpParam.EPS_ABS, 1.0E-04);
+        params.put(OsqpParam.EPS_REL, 1.0E-04);
+
+        var data = createModel1().toData();
+        var primal = new double[data.numVar()];
+        var dual = new double[data.numDual()];
+
+        try (var solver = OsqpSolver.create(data, params)) {
+            Assert.assertEquals(solver.solve(primal, dual), OsqpStatus.SOLVED);
+        }
+
+        var tolerance = 1.0E-12;
+        Assert.assertEquals(primal[0], 0.3, tolerance);
+        Assert.assertEquals(primal[1], 0.7, tolerance);
+        Assert.assertEquals(dual[0], -2.9, tolerance);
+        Assert.assertEquals(dual[2], 0.2, tolerance);
+    }
+
+    @Test
+    public void testSolverClosed() {
+        var data = createModel1().toData();
+        var primal = new double[data.numVar()];
+        var dual = new double[data.numDual()];
+        var solver = OsqpSolver.create(data, Map.of());
+
+        Assert.assertEquals(solver.solve(primal, dual), OsqpStatus.SOLVED);
+        solver.close();
+        solver.close();
+
+        Assert.assertTrue(solver.isClosed());
+        Assert.assertThrows(IllegalStateException.class, () -> solver.solve(primal, dual));
+        Assert.assertThrows(IllegalStateException.class, () -> solver.evaluate(primal));
+        Assert.assertThrows(IllegalStateException.class, () -> solver.updateLinCost(new double[data.numVar()]));
+    }
+
+    @Test
+    public void testBulkSetters() {
+        try (var expected = createModel1();
+             var model = OsqpModel.create(2, 1)
+                     .setVariableBounds(new double[] { 0.0, 0.0 }, new double[] { 0.7, 0.7 })
+                     .setObjective(new double[] { 1.0, 1.0 })
+                     .setQuadraticObjective(new int[] { 0, 0, 1 }, new int[] { 0, 1, 1 }, new double[] { 4.0, 1.0, 2.0 })
+                     .setConstraintBlock(0, new int[] { 0, 1, 2 }, new int[] { 0, 0 }, new double[] { 1.0, 1.0 })
+                     .setConstraintBounds(new double[] { 1.0 }, new double[] { 1.0 })
+                     .setParameter(OsqpParam.RHO, 1.0)
+                     .setParameter(OsqpParam.POLISH, 1)
+                     .setParameter(OsqpParam.MAX_ITER, 200)
+                     .setParameter(OsqpParam.EPS_ABS, 1.0E-04)
+                     .setParameter(OsqpParam.EPS_REL, 1.0E-04)) {
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+
+            model.setConstraintMatrix(new int[] { 0 }, new int[] { 1 }, new double[] { 2.0 });
+            expected.setConstraintCoeff(0, 1, 2.0);
+
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+            assertSameSolution(model, expected, 1.0E-08);
+
+            Assert.assertThrows(IllegalArgumentException.class,
+                    () -> model.setQuadraticObjective(new int[] { 1 }, new int[] { 0 }, new double[] { 1.0 }));
+            Assert.assertThrows(IllegalArgumentException.class,
+                    () -> model.setConstraintMatrix(new int[] { 0, 1 }, new int[] { 0, 0 }, new double[] { 1.0, 1.0 }));
+        }
+    }
+
+    @Test
+    public void testFactorModel() {
+        var numVar = 5;
+        var diagonal = new double[] { 0.10, 0.20, 0.15, 0.30, 0.25 };
+        var loadings = new double[][] { { 1.0, 0.2 }, { 0.8, 0.0 }, { 1.2, -0.5 }, { 0.9, 0.4 }, { 1.1, 0.1 } };
+        var factorCov = new double[][] { { 0.04, 0.01 }, { 0.01, 0.09 } };
+
+        try (var lifted = OsqpModel.createFactor(numVar, 1, diagonal, loadings, factorCov);
+             var dense = OsqpModel.create(numVar, 1)) {
+            for (int i = 0; i < numVar; ++i) {
+                for (int j = i; j < numVar; ++j) {
+                    var coeff = i == j ? diagonal[i] : 0.0;
+
+                    for (int f = 0; f < 2; ++f)
+                        for (int g = 0; g < 2; ++g)
+                            coeff += loadings[i][f] * factorCov[f][g] * loadings[j][g];
+
+                    dense.setObjectiveCoeff(i, j, coeff);
+                }
+            }
+
+            for (var model : List.of(lifted, dense)) {
+                for (int i = 0; i < numVar; ++i) {
+                    model.setObjectiveCoeff(i, -0.01 * (i + 1));
+                    model.setVariableBound(i, 0.0, 1.0);
+                    model.setConstraintCoeff(0, i, 1.0);
+                }
+
+                model.setConstraintBound(0, 1.0, 1.0);
+                model.setParameter(OsqpParam.POLISH, 1);
+                model.setParameter(OsqpParam.EPS_ABS, 1.0E-06);
+                model.setParameter(OsqpParam.EPS_REL, 1.0E-06);
+                Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            }
+
+            Assert.assertEquals(lifted.countVariables(), numVar + 2);
+            Assert.assertEquals(lifted.countConstraints(), 3);
+
+            var liftedOpt = Arrays.copyOf(lifted.getOptimal(), numVar);
+            Assert.assertEquals(liftedOpt, dense.getOptimal(), 1.0E-05);
+            Assert.assertEquals(lifted.evaluate(lifted.getOptimal()), dense.evaluate(dense.getOptimal()), 1.0E-06);
+        }
+    }
+
+    @Test
+    public void testModelFile() throws IOException {
+        var path = Files.createTempFile("osqp", ".bin");
+
+        try (var model = createModel1().setVariableBound(1, Double.NEGATIVE_INFINITY, Double.POSITIVE_INFINITY)) {
+            model.save(path);
+
+            try (var loaded = OsqpModel.load(path)) {
+                Assert.assertEquals(loaded.countVariables(), 2);
+                Assert.assertEquals(loaded.countConstraints(), 1);
+                Assert.assertEquals(loaded.toData().numDual(), 2);
+                Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+                Assert.assertEquals(loaded.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(model, loaded, 1.0E-12);
+            }
+
+            var file = OsqpModelFile.map(path);
+            var primal = new double[file.data().numVar()];
+            var dual = new double[file.data().numDual()];
+
+            try (var solver = OsqpSolver.create(file.data(), file.params())) {
+                Assert.assertEquals(solver.solve(primal, dual), OsqpStatus.SOLVED);
+                Assert.assertEquals(primal, model.getOptimal(), 1.0E-12);
+            }
+
+            var infos = OsqpModelFile.solveAll(List.of(path, path), Map.of(OsqpParam.MAX_ITER, 1.0), 2);
+            Assert.assertEquals(infos.size(), 2);
+            Assert.assertEquals(infos.get(0).orElseThrow().getIterations(), 1);
+            Assert.assertEquals(infos.get(1).orElseThrow().getStatus(), OsqpStatus.MAX_ITER_REACHED);
+        }
+        finally {
+            Files.delete(path);
+        }
+    }
+
+    @Test
+    public void testSolution() {
+        try (var model = createModel1()) {
+            var unsolved = model.getSolution();
+            Assert.assertFalse(unsolved.isSolved());
+            Assert.assertTrue(Double.isNaN(unsolved.getOptimal(0)));
+            Assert.assertTrue(Double.isNaN(unsolved.getObjective()));
+
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            var solution = model.getSolution();
+            Assert.assertSame(model.getSolution(), solution);
+            Assert.assertTrue(solution.isSolved());
+            Assert.assertEquals(solution.countVariables(), 2);
+            Assert.assertEquals(solution.countConstraints(), 1);
+            Assert.assertEquals(solution.getObjective(), model.evaluate(model.getOptimal()), 1.0E-12);
+            Assert.assertEquals(solution.getInfo().orElseThrow().getStatus(), OsqpStatus.SOLVED);
+
+            var primal = new double[2];
+            var dual = new double[1];
+            var reduced = new double[2];
+            solution.copyOptimalInto(primal);
+            solution.copyDualInto(dual);
+            solution.copyReducedInto(reduced);
+
+            Assert.assertEquals(primal, model.getOptimal());
+            Assert.assertEquals(dual, model.getDual());
+            Assert.assertEquals(reduced, model.getReduced());
+            Assert.assertEquals(solution.getDual(0), model.getDual(0));
+            Assert.assertEquals(solution.getReduced(1), model.getReduced(1));
+
+            var view = solution.reduced();
+            Assert.assertTrue(view.isReadOnly());
+            Assert.assertEquals(view.remaining(), 2);
+            Assert.assertEquals(view.get(1), reduced[1]);
+            Assert.assertEquals(solution.dual().get(0), dual[0]);
+
+            // The snapshot survives modification of the model...
+            model.setObjectiveCoeff(0, 5.0);
+            Assert.assertNotSame(model.getSolution(), solution);
+            Assert.assertFalse(model.getSolution().isSolved());
+            Assert.assertEquals(solution.optimal().get(0), primal[0]);
+        }
+    }
+
+    private static OsqpModel createPresolveModel() {
+        return OsqpModel.create(4, 4)
+                .setVariableBound(0, 0.0, 0.7)
+                .setVariableBound(1, 0.0, 0.7)
+                .setVariableBound(2, 0.2, 0.2)
+                .setVariableBound(3, -1.0, 1.0)
+                .setObjectiveCoeff(0, 1.0)
+                .setObjectiveCoeff(1, 1.0)
+                .setObjectiveCoeff(3, 1.0)
+                .setObjectiveCoeff(0, 0, 4.0)
+                .setObjectiveCoeff(0, 1, 1.0)
+                .setObjectiveCoeff(1, 1, 2.0)
+                .setObjectiveCoeff(0, 2, 0.5)
+                .setObjectiveCoeff(2, 2, 1.0)
+                .setConstraintCoeff(0, 0, 1.0)
+                .setConstraintCoeff(0, 1, 1.0)
+                .setConstraintBound(0, 1.0, 1.0)
+                .setConstraintCoeff(1, 0, 1.0)
+                .setConstraintCoeff(1, 2, 1.0)
+                .setConstraintBound(1, 0.0, 0.8)
+                .setConstraintCoeff(2, 0, 1.0)
+                .setConstraintCoeff(2, 1, 1.0)
+                .setConstraintBound(2, 0.9, 1.1)
+                .setConstraintCoeff(3, 2, 1.0)
+                .setConstraintBound(3, 0.0, 1.0)
+                .setParameter(OsqpParam.POLISH, 1)
+                .setParameter(OsqpParam.EPS_ABS, 1.0E-09)
+                .setParameter(OsqpParam.EPS_REL, 1.0E-09);
+    }
+
+    @Test
+    public void testPresolve() {
+        // The fixed variable x2 and the empty column x3 are removed, the
+        // empty constraint 3 is dropped, and constraint 2 is merged into
+        // constraint 0...
+        var quadObj = OsqpMatrix.build(4, 4, 5,
+                new int[] { 0, 0, 1, 0, 2 },
+                new int[] { 0, 1, 1, 2, 2 },
+                new double[] { 4.0, 1.0, 2.0, 0.5, 1.0 });
+
+        var conCoeff = OsqpMatrix.build(4, 4, 7,
+                new int[] { 0, 0, 1, 1, 2, 2, 3 },
+                new int[] { 0, 1, 0, 2, 0, 1, 2 },
+                new double[] { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 });
+
+        var presolve = OsqpPresolve.of(
+                new double[] { 1.0, 1.0, 0.0, 1.0 },
+                quadObj,
+                conCoeff,
+                new double[] { 1.0, 0.0, 0.9, 0.0, 0.0, 0.0, 0.2, -1.0 },
+                new double[] { 1.0, 0.8, 1.1, 1.0, 0.7, 0.7, 0.2, 1.0 },
+                1.0E+20);
+
+        Assert.assertEquals(presolve.countRemovedVars(), 2);
+        Assert.assertEquals(presolve.countRemovedRows(), 2);
+        Assert.assertEquals(presolve.numVar(), 2);
+        Assert.assertEquals(presolve.numRows(), 4);
+        Assert.assertEquals(presolve.linObjCoeff(), new double[] { 1.1, 1.0 }, 1.0E-15);
+        Assert.assertEquals(presolve.upper()[1], 0.6, 1.0E-15);
+        Assert.assertEquals(presolve.objectiveOffset(), -0.98, 1.0E-15);
+
+        try (var full = createPresolveModel(); var reduced = createPresolveModel().setPresolve(true)) {
+            Assert.assertEquals(full.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(reduced.solve(), OsqpStatus.SOLVED);
+
+            var tolerance = 1.0E-06;
+            Assert.assertEquals(reduced.getOptimal(), full.getOptimal(), tolerance);
+            Assert.assertEquals(reduced.getOptimal(2), 0.2);
+            Assert.assertEquals(reduced.getOptimal(3), -1.0);
+            Assert.assertEquals(reduced.getReduced(), full.getReduced(), tolerance);
+            Assert.assertEquals(reduced.getDual(1), full.getDual(1), tolerance);
+            Assert.assertEquals(reduced.getDual(3), 0.0);
+
+            // The objective value includes the removed variables...
+            var objective = full.getInfo().orElseThrow().getObjectiveValue();
+            Assert.assertEquals(reduced.getInfo().orElseThrow().getObjectiveValue(), objective, 1.0E-04);
+
+            // The duplicate rows share one dual value...
+            Assert.assertEquals(reduced.getDual(0) + reduced.getDual(2), full.getDual(0) + full.getDual(2), tolerance);
+
+            // A new value for the fixed variable requires a new reduction...
+            full.setVariableBound(2, 0.1, 0.1);
+            reduced.setVariableBound(2, 0.1, 0.1);
+            Assert.assertEquals(full.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(reduced.solve(), OsqpStatus.SOLVED);
+            Assert.assertEquals(reduced.getOptimal(), full.getOptimal(), tolerance);
+
+            Assert.assertThrows(IllegalStateException.class, () -> reduced.evaluateNative(reduced.getOptimal()));
+            Assert.assertEquals(OsqpModel.solveAll(List.of(reduced)), List.of(OsqpStatus.SOLVED));
+            Assert.assertEquals(reduced.getOptimal(), full.getOptimal(), tolerance);
+
+            objective = full.getInfo().orElseThrow().getObjectiveValue();
+            Assert.assertEquals(reduced.getInfo().orElseThrow().getObjectiveValue(), objective, 1.0E-04);
+            Assert.assertEquals(reduced.getSolution().getInfo().orElseThrow().getObjectiveValue(), objective, 1.0E-04);
+        }
+    }
+
+    @Test
+    public void testPresolveToggle() {
+        // The reduction of one batch solve must not map the solution of a
+        // later batch solve without presolve...
+        try (var full = createPresolveModel(); var model = createPresolveModel()) {
+            Assert.assertEquals(full.solve(), OsqpStatus.SOLVED);
+
+            var tolerance = 1.0E-06;
+            model.setPresolve(true);
+            Assert.assertEquals(OsqpModel.solveAll(List.of(model)), List.of(OsqpStatus.SOLVED));
+            Assert.assertEquals(model.getOptimal(), full.getOptimal(), tolerance);
+
+            model.setPresolve(false);
+            Assert.assertEquals(OsqpModel.solveAll(List.of(model)), List.of(OsqpStatus.SOLVED));
+            Assert.assertEquals(model.getOptimal(), full.getOptimal(), tolerance);
+            Assert.assertEquals(model.getDual(), full.getDual(), tolerance);
+
+            model.setPresolve(true);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            model.setPresolve(false);
+            Assert.assertEquals(OsqpModel.solveAll(List.of(model)), List.of(OsqpStatus.SOLVED));
+            Assert.assertEquals(model.getOptimal(), full.getOptimal(), tolerance);
+        }
+    }
+
+    @Test
+    public void testEmbeddedLoad() throws IOException {
+        var path = Files.createTempFile("osqp", ".so");
+
+        try {
+            Assert.assertThrows(IllegalArgumentException.class, () -> OsqpEmbedded.load(path));
+        }
+        finally {
+            Files.delete(path);
+        }
+    }
+
+    // The matrices of model 1 in the solver layout...
+    private static OsqpMatrix quadObj1() {
+        return OsqpMatrix.wrap(2, 2, new long[] { 0, 1, 3 }, new long[] { 0, 0, 1 }, new double[] { 4.0, 1.0, 2.0 });
+    }
+
+    private static OsqpMatrix linCon1() {
+        return OsqpMatrix.wrap(3, 2, new long[] { 0, 2, 4 }, new long[] { 0, 1, 0, 2 }, new double[] { 1.0, 1.0, 1.0, 1.0 });
+    }
+
+    @Test
+    public void testEmbeddedAccepts() {
+        var quadObj = quadObj1();
+        var linCon = linCon1();
+        Assert.assertTrue(OsqpEmbedded.accepts(quadObj, linCon, false, quadObj1(), linCon1()));
+
+        // Differences within the tolerance are the same values...
+        var perturbed = linCon1();
+        perturbed.values[0] *= 1.0 + 1.0E-14;
+        Assert.assertTrue(OsqpEmbedded.accepts(quadObj, linCon, false, quadObj1(), perturbed));
+
+        var changed = quadObj1();
+        changed.values[1] = 0.5;
+        Assert.assertFalse(OsqpEmbedded.accepts(quadObj, linCon, false, changed, linCon1()));
+        Assert.assertTrue(OsqpEmbedded.accepts(quadObj, linCon, true, changed, linCon1()));
+
+        // A different pattern is never accepted...
+        var diagonal = OsqpMatrix.wrap(2, 2, new long[] { 0, 1, 2 }, new long[] { 0, 1 }, new double[] { 4.0, 2.0 });
+        Assert.assertFalse(OsqpEmbedded.accepts(quadObj, linCon, true, diagonal, linCon1()));
+
+        var unbounded = OsqpMatrix.wrap(2, 2, new long[] { 0, 2, 3 }, new long[] { 0, 1, 0 }, new double[] { 1.0, 1.0, 1.0 });
+        Assert.assertFalse(OsqpEmbedded.accepts(quadObj, linCon, true, quadObj1(), unbounded));
+    }
+
+    @Test
+    public void testEmbeddedLayout() {
+        var lower = new double[] { 1.0, 0.0, 0.0 };
+        var upper = new double[] { 1.0, 0.7, 0.7 };
+        var boundRows = OsqpBoundRows.of(1, 2, lower, upper, 1.0E+20);
+
+        var linCon = OsqpMatrix.wrap(1, 2, new long[] { 0, 1, 2 }, new long[] { 0, 0 }, new double[] { 1.0, 1.0 });
+        Assert.assertTrue(boundRows.stack(linCon).hasPattern(linCon1()));
+        Assert.assertEquals(boundRows.gather(lower), lower);
+
+        // An unbounded variable has no row in the specialized solver...
+        upper[2] = Double.POSITIVE_INFINITY;
+        lower[2] = Double.NEGATIVE_INFINITY;
+        boundRows = OsqpBoundRows.of(1, 2, lower, upper, 1.0E+20);
+
+        var stacked = boundRows.stack(linCon);
+        Assert.assertEquals(stacked.nrow, 2);
+        Assert.assertTrue(stacked.hasPattern(OsqpMatrix.wrap(2, 2, new long[] { 0, 2, 3 }, new long[] { 0, 1, 0 }, new double[] { 1.0, 1.0, 1.0 })));
+        Assert.assertEquals(boundRows.gather(upper), new double[] { 1.0, 0.7 });
+
+        var dual = new double[3];
+        boundRows.scatter(new double[] { -1.5, 0.25 }, dual, 0.0);
+        Assert.assertEquals(dual, new double[] { -1.5, 0.25, 0.0 });
+    }
+
+    @Test
+    public void testEmbeddedSettings() {
+        var generated = new double[OsqpEmbedded.settingIndex(OsqpParam.WARM_START) + 1];
+        generated[OsqpEmbedded.settingIndex(OsqpParam.RHO)] = 0.1;
+        generated[OsqpEmbedded.settingIndex(OsqpParam.SIGMA)] = 1.0E-06;
+        generated[OsqpEmbedded.settingIndex(OsqpParam.ADAPTIVE_RHO_INTERVAL)] = Double.NaN;
+
+        var params = new EnumMap<OsqpParam, Double>(OsqpParam.class);
+        params.put(OsqpParam.MAX_ITER, 500.0);
+        params.put(OsqpParam.EPS_ABS, 1.0E-05);
+        params.put(OsqpParam.POLISH, 1.0);
+        params.put(OsqpParam.SIGMA, 1.0E-06);
+        params.put(OsqpParam.ADAPTIVE_RHO_INTERVAL, 50.0);
+        params.put(OsqpParam.TIME_LIMIT, 0.0);
+
+        // Only the updatable settings are sent...
+        var values = OsqpEmbedded.settingValues(params, generated, false);
+        Assert.assertEquals(OsqpEmbedded.settingIndex(OsqpParam.POLISH), -1);
+        Assert.assertEquals(values[OsqpEmbedded.settingIndex(OsqpParam.MAX_ITER)], 500.0);
+        Assert.assertEquals(values[OsqpEmbedded.settingIndex(OsqpParam.EPS_ABS)], 1.0E-05);
+        Assert.assertTrue(Double.isNaN(values[OsqpEmbedded.settingIndex(OsqpParam.RHO)]));
+        Assert.assertTrue(Double.isNaN(values[OsqpEmbedded.settingIndex(OsqpParam.SIGMA)]));
+        Assert.assertTrue(Double.isNaN(values[OsqpEmbedded.settingIndex(OsqpParam.ADAPTIVE_RHO_INTERVAL)]));
+
+        params.put(OsqpParam.RHO, 0.2);
+        Assert.assertThrows(IllegalStateException.class, () -> OsqpEmbedded.settingValues(params, generated, false));
+        Assert.assertEquals(OsqpEmbedded.settingValues(params, generated, true)[OsqpEmbedded.settingIndex(OsqpParam.RHO)], 0.2);
+
+        params.put(OsqpParam.SIGMA, 1.0E-05);
+        Assert.assertThrows(IllegalStateException.class, () -> OsqpEmbedded.settingValues(params, generated, true));
+        params.put(OsqpParam.SIGMA, 1.0E-06);
+
+        params.put(OsqpParam.TIME_LIMIT, 1.0);
+        Assert.assertThrows(IllegalStateException.class, () -> OsqpEmbedded.settingValues(params, generated, true));
+    }
+
+    /**
+     * Solves model 1 with a specialized library generated from it, whose path
+     * is given by the {@code com.d3x.osqp.embeddedLibrary} system property;
+     * skipped without the property, since generating the library requires the
+     * OSQP Python interface.
+     */
+    @Test
+    public void testEmbeddedSolve() {
+        var library = System.getProperty("com.d3x.osqp.embeddedLibrary");
+
+        if (library == null)
+            throw new SkipException("No specialized library for model 1.");
+
+        try (var embedded = OsqpEmbedded.load(Path.of(library));
+             var model = createModel1().setParameter(OsqpParam.POLISH, 0)) {
+            model.setEmbeddedSolver(embedded);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            try (var general = createModel1().setParameter(OsqpParam.POLISH, 0)) {
+                Assert.assertEquals(general.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(model, general, 1.0E-06);
+            }
+
+            // The new bounds are sent with the next solve...
+            model.setConstraintBound(0, 0.9, 0.9);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            try (var general = createModel1().setParameter(OsqpParam.POLISH, 0).setConstraintBound(0, 0.9, 0.9)) {
+                Assert.assertEquals(general.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(model, general, 1.0E-06);
+            }
+
+            model.setParameter(OsqpParam.SIGMA, 1.0E-03);
+            Assert.assertThrows(IllegalStateException.class, model::solve);
+        }
+    }
+
+    @Test
+    public void testParamAvailable() {
+        Assert.assertTrue(OsqpParam.RHO.isAvailable());
+        Assert.assertTrue(OsqpParam.TIME_LIMIT.isAvailable());
+
+        try (var model = createModel1()) {
+            if (!OsqpParam.ADAPTIVE_RHO_FRACTION.isAvailable()) {
+                Assert.assertThrows(IllegalStateException.class, () -> model.setParameter(OsqpParam.ADAPTIVE_RHO_FRACTION, 0.4));
+                return;
+            }
+
+            model.setParameter(OsqpParam.ADAPTIVE_RHO_FRACTION, 0.4);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+            assertSolution1(model);
+        }
+    }
+
+    @Test
+    public void testPrecision() {
+        Assert.assertTrue(OsqpPrecision.DOUBLE.isAvailable());
+
+        if (!OsqpPrecision.SINGLE.isAvailable()) {
+            Assert.assertThrows(IllegalStateException.class, () -> createModel1().setPrecision(OsqpPrecision.SINGLE));
+            return;
+        }
+
+        try (var model = createModel1().setPrecision(OsqpPrecision.SINGLE)) {
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            try (var expected = createModel1()) {
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(model, expected, 1.0E-05);
+            }
+
+            // The workspace survives vector updates...
+            model.setConstraintBound(0, 0.9, 0.9);
+            Assert.assertEquals(model.solve(), OsqpStatus.SOLVED);
+
+            try (var expected = createModel1().setConstraintBound(0, 0.9, 0.9)) {
+                Assert.assertEquals(expected.solve(), OsqpStatus.SOLVED);
+                assertSameSolution(model, expected, 1.0E-05);
+            }
+        }
+    }
+
     @Test
     public void test2() {
         var nvar = 7;